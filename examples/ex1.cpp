@@ -32,6 +32,7 @@
 //             > ex1 -pa -d raja-omp
 //             > ex1 -pa -d occa-omp
 //             > ex1 -m ../data/beam-hex.mesh -pa -d cuda
+//             > ex1 -pa -sp
 //
 // Description:  This example code demonstrates the use of MFEM to define a
 //               simple finite element discretization of the Laplace problem
@@ -46,7 +47,10 @@
 //               corresponding to the left-hand side and right-hand side of the
 //               discrete linear system. We also cover the explicit elimination
 //               of essential boundary conditions, static condensation, and the
-//               optional connection to the GLVis tool for visualization.
+//               optional connection to the GLVis tool for visualization. With
+//               partial assembly, a single-precision copy of the operator can
+//               be used in an inner CG preconditioner for an outer (double
+//               precision) FGMRES solver.
 
 #include "mfem.hpp"
 #include <fstream>
@@ -62,6 +66,7 @@ int main(int argc, char *argv[])
    int order = 1;
    bool static_cond = false;
    bool pa = false;
+   bool single_prec = false;
    const char *device = "cpu";
    bool visualization = true;
 
@@ -75,6 +80,9 @@ int main(int argc, char *argv[])
                   "--no-static-condensation", "Enable static condensation.");
    args.AddOption(&pa, "-pa", "--partial-assembly", "-no-pa",
                   "--no-partial-assembly", "Enable Partial Assembly.");
+   args.AddOption(&single_prec, "-sp", "--single-precision-prec", "-no-sp",
+                  "--no-single-precision-prec", "With partial assembly, use a "
+                  "single-precision inner CG solve as FGMRES preconditioner.");
    args.AddOption(&device, "-d", "--device",
                   "Device configuration string, see Device::Configure().");
    args.AddOption(&visualization, "-vis", "--visualization", "-no-vis",
@@ -195,10 +203,39 @@ int main(int argc, char *argv[])
       umf_solver.Mult(B, X);
 #endif
    }
-   else // No preconditioning for now in partial assembly mode.
+   else if (!single_prec) // No preconditioning in partial assembly mode.
    {
       CG(*A, B, X, 1, 2000, 1e-12, 0.0);
    }
+   else
+   {
+      // Assemble the same operator with single-precision quadrature data and
+      // use a few CG iterations on it as a (variable) preconditioner.
+      BilinearForm a_sp(fespace);
+      a_sp.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      a_sp.EnableSinglePrecisionPA();
+      a_sp.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a_sp.Assemble();
+      OperatorPtr A_sp;
+      a_sp.FormSystemMatrix(ess_tdof_list, A_sp);
+
+      CGSolver prec;
+      prec.SetOperator(*A_sp);
+      prec.SetRelTol(1e-3);
+      prec.SetAbsTol(0.0);
+      prec.SetMaxIter(10);
+      prec.SetPrintLevel(-1);
+
+      FGMRESSolver fgmres;
+      fgmres.SetOperator(*A);
+      fgmres.SetPreconditioner(prec);
+      fgmres.SetRelTol(1e-6);
+      fgmres.SetAbsTol(0.0);
+      fgmres.SetMaxIter(500);
+      fgmres.SetKDim(50);
+      fgmres.SetPrintLevel(1);
+      fgmres.Mult(B, X);
+   }
 
    // 12. Recover the solution as a finite element grid function.
    a->RecoverFEMSolution(X, *b, x);
@@ -0,0 +1,77 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Methods of SmoothedAggregationAMG (linalg/amg.hpp) that use a
+// FiniteElementSpace; they are here so that linalg does not depend on fem.
+
+#include "fem.hpp"
+#include "../linalg/amg.hpp"
+
+namespace mfem
+{
+
+static void RotationXY(const Vector &x, Vector &y)
+{
+   y = 0.0; y(0) = x(1); y(1) = -x(0);
+}
+
+static void RotationYZ(const Vector &x, Vector &y)
+{
+   y = 0.0; y(1) = x(2); y(2) = -x(1);
+}
+
+static void RotationZX(const Vector &x, Vector &y)
+{
+   y = 0.0; y(2) = x(0); y(0) = -x(2);
+}
+
+void SmoothedAggregationAMG::SetElasticityOptions(FiniteElementSpace *fes)
+{
+   fespace = fes;
+   SetSystemsOptions(fes->GetVDim(),
+                     fes->GetOrdering() == Ordering::byNODES);
+}
+
+void SmoothedAggregationAMG::ComputeRigidBodyModes()
+{
+   const int dim = fespace->GetMesh()->SpaceDimension();
+   MFEM_VERIFY(fespace->GetVDim() == dim && (dim == 2 || dim == 3),
+               "the space must have vector dimension 2 or 3");
+   void (*rotations[3])(const Vector &, Vector &) =
+   { RotationXY, RotationYZ, RotationZX };
+   const int num_rotations = (dim == 2) ? 1 : 3;
+
+   GridFunction mode(fespace);
+   const SparseMatrix *R = fespace->GetConformingRestriction();
+   const int n = R ? R->Height() : mode.Size();
+   nullspace.SetSize(n, dim + num_rotations);
+   for (int m = 0; m < dim + num_rotations; m++)
+   {
+      if (m < dim)
+      {
+         Vector e(dim);
+         e = 0.0;
+         e(m) = 1.0;
+         VectorConstantCoefficient translation(e);
+         mode.ProjectCoefficient(translation);
+      }
+      else
+      {
+         VectorFunctionCoefficient rotation(dim, rotations[m - dim]);
+         mode.ProjectCoefficient(rotation);
+      }
+      Vector col(nullspace.GetColumn(m), n);
+      if (R) { R->Mult(mode, col); }
+      else { col = mode; }
+   }
+}
+
+}
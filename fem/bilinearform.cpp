@@ -13,22 +13,227 @@
 
 #include "fem.hpp"
 #include "../general/device.hpp"
+#include "../general/tic_toc.hpp"
 #include <cmath>
+#include <fstream>
+#include <limits>
 
 namespace mfem
 {
 
+void AssemblyCostModel::Calibrate(const char *cache_file)
+{
+   if (cache_file)
+   {
+      std::ifstream in(cache_file);
+      double bw = 0.0, flops = 0.0;
+      if (in >> bw >> flops && bw > 0.0 && flops > 0.0)
+      {
+         SetMachineParameters(bw, flops);
+         return;
+      }
+   }
+
+   StopWatch sw;
+   const int n = 1 << 21, n_rep = 5;
+   Vector a(n), b(n), c(n);
+   b = 1.0;
+   c = 2.0;
+   double best = std::numeric_limits<double>::infinity();
+   for (int r = 0; r < n_rep; r++)
+   {
+      sw.Clear();
+      sw.Start();
+      add(b, 0.5, c, a);
+      sw.Stop();
+      best = std::min(best, sw.RealTime());
+   }
+   if (best > 0.0) { bandwidth = 3.0*n*sizeof(double)/best; }
+
+   const int m = 64, m_rep = 200;
+   DenseMatrix M(m);
+   Vector x(m), y(m);
+   for (int i = 0; i < m*m; i++) { M.GetData()[i] = 1.0/(1.0 + i); }
+   x = 1.0;
+   sw.Clear();
+   sw.Start();
+   for (int r = 0; r < m_rep; r++)
+   {
+      M.Mult(x, y);
+      x(r % m) = y(0)/m;
+   }
+   sw.Stop();
+   if (sw.RealTime() > 0.0) { flop_rate = 2.0*m*m*m_rep/sw.RealTime(); }
+
+   if (cache_file)
+   {
+      std::ofstream out(cache_file);
+      out.precision(8);
+      out << bandwidth << ' ' << flop_rate << '\n';
+   }
+}
+
+bool AssemblyCostModel::IsSupported(BilinearForm &a, AssemblyLevel level) const
+{
+   const bool device = Device::IsEnabled();
+   switch (level)
+   {
+      case AssemblyLevel::FULL:
+         return !device;
+      case AssemblyLevel::PARTIAL:
+      {
+         if (a.StaticCondensationIsEnabled() || a.GetHybridization() ||
+             a.GetBBFI()->Size() || a.GetFBFI()->Size() ||
+             a.GetBFBFI()->Size() || a.GetDBFI()->Size() == 0)
+         {
+            return false;
+         }
+         const FiniteElementSpace *fes = a.FESpace();
+         const Mesh *mesh = fes->GetMesh();
+         if (fes->GetNE() == 0 || mesh->Dimension() < 2 ||
+             mesh->GetNumGeometries(mesh->Dimension()) != 1 ||
+             !dynamic_cast<const TensorBasisElement*>(fes->GetFE(0)))
+         {
+            return false;
+         }
+         Array<BilinearFormIntegrator*> &dbfi = *a.GetDBFI();
+         for (int i = 0; i < dbfi.Size(); i++)
+         {
+            if (!dbfi[i]->SupportsPartialAssembly()) { return false; }
+         }
+         return true;
+      }
+      default:
+         // ELEMENT and NONE are not implemented by BilinearForm yet.
+         return false;
+   }
+}
+
+AssemblyCostModel::Estimate
+AssemblyCostModel::GetEstimate(BilinearForm &a, AssemblyLevel level) const
+{
+   Estimate est = { 0.0, 0.0, 0.0 };
+   const FiniteElementSpace *fes = a.FESpace();
+   const int NE = fes->GetNE();
+   if (NE == 0) { return est; }
+
+   const FiniteElement *fe = fes->GetFE(0);
+   const int dim = fe->GetDim();
+   const int p = std::max(fe->GetOrder(), 1);
+   const double vdim = fes->GetVDim();
+   const double nd = fe->GetDof();
+   const double ndv = nd*vdim;
+   const double N = fes->GetVSize();
+   const int ir_order = 2*p + dim - 1;
+   const double nq = IntRules.Get(fe->GetGeomType(), ir_order).GetNPoints();
+   const double q1d = IntRules.Get(Geometry::SEGMENT, ir_order).GetNPoints();
+   const double ni = std::max(a.GetDBFI()->Size(), 1);
+   const double symm = dim*(dim+1)/2;
+   const double sd = sizeof(double), si = sizeof(int);
+
+   // Computing one element matrix: ni*nq outer products of the (derivatives
+   // of the) shape functions.
+   const double elmat_flops = 2.0*ni*nq*(dim + 1)*nd*nd*vdim;
+
+   switch (level)
+   {
+      case AssemblyLevel::FULL:
+      {
+         // Each row couples with the dofs of all elements around it; for
+         // tensor-product H1 spaces that is (2p+1)^dim nodes.
+         const double row_size = std::min(N, vdim*std::pow(2.0*p + 1, dim));
+         const double nnz = N*row_size;
+         // Peak memory: the linked-list rows and the final CSR arrays.
+         est.memory = nnz*(sizeof(RowNode) + sd + si) + (N + 1)*si;
+         est.setup_time = NE*elmat_flops/flop_rate +
+                          NE*ndv*ndv*(sizeof(RowNode) + sd + si)/bandwidth;
+         est.mult_time = std::max(2.0*nnz/flop_rate,
+                                  (nnz*(sd + si) + 3.0*N*sd)/bandwidth);
+         break;
+      }
+      case AssemblyLevel::ELEMENT:
+      {
+         est.memory = NE*ndv*ndv*sd;
+         est.setup_time = NE*elmat_flops/flop_rate + est.memory/bandwidth;
+         est.mult_time = std::max(2.0*NE*ndv*ndv/flop_rate,
+                                  (est.memory + 2.0*NE*ndv*sd + 2.0*N*sd)/
+                                  bandwidth);
+         break;
+      }
+      case AssemblyLevel::PARTIAL:
+      {
+         // Quadrature data (at most symm values per point and integrator),
+         // geometric factors (X, J, invJ, detJ), E-vectors and the element
+         // restriction.
+         const double qdata = NE*nq*ni*symm*sd;
+         const double geom = NE*nq*(2*dim*dim + dim + 1)*sd;
+         const double evec = 2.0*NE*ndv*sd;
+         est.memory = qdata + geom + evec + 2.0*NE*nd*si;
+         est.setup_time = NE*nq*ni*(10.0*dim*dim)/flop_rate +
+                          (qdata + geom)/bandwidth;
+         // Sum factorization: dim contractions of size (p+1) x q1d^dim, for
+         // the values and the dim derivatives, forward and backward.
+         const double flops =
+            NE*vdim*ni*4.0*dim*(dim + 1)*(p + 1)*std::pow(q1d, dim);
+         est.mult_time = std::max(flops/flop_rate,
+                                  (qdata + 2.0*evec + NE*nd*si + 2.0*N*sd)/
+                                  bandwidth);
+         break;
+      }
+      default:
+         MFEM_ABORT("no estimate for this assembly level");
+   }
+   return est;
+}
+
+AssemblyLevel AssemblyCostModel::Select(BilinearForm &a) const
+{
+   const AssemblyLevel levels[3] =
+   { AssemblyLevel::FULL, AssemblyLevel::ELEMENT, AssemblyLevel::PARTIAL };
+
+   AssemblyLevel best = AssemblyLevel::FULL, smallest = AssemblyLevel::FULL;
+   double best_time = std::numeric_limits<double>::infinity();
+   double min_memory = std::numeric_limits<double>::infinity();
+   bool fits = false;
+   for (int i = 0; i < 3; i++)
+   {
+      if (!IsSupported(a, levels[i])) { continue; }
+      const Estimate est = GetEstimate(a, levels[i]);
+      if (est.memory < min_memory)
+      {
+         min_memory = est.memory;
+         smallest = levels[i];
+      }
+      if (memory_budget > 0.0 && est.memory > memory_budget) { continue; }
+      const double time = est.setup_time + num_mult*est.mult_time;
+      if (time < best_time)
+      {
+         best_time = time;
+         best = levels[i];
+         fits = true;
+      }
+   }
+   if (!fits && min_memory < std::numeric_limits<double>::infinity())
+   {
+      MFEM_WARNING("no assembly level fits within the memory budget, using the"
+                   " one with the smallest memory estimate");
+      return smallest;
+   }
+   return best;
+}
+
 void BilinearForm::AllocMat()
 {
    if (static_cond) { return; }
 
-   if (precompute_sparsity == 0 || fes->GetVDim() > 1)
+   if (precompute_sparsity == 0)
    {
       mat = new SparseMatrix(height);
       return;
    }
 
    const Table &elem_dof = fes->GetElementToDofTable();
+   const int ndofs = fes->GetNDofs(), vdim = fes->GetVDim();
    Table dof_dof;
 
    if (fbfi.Size() > 0)
@@ -40,27 +245,58 @@ void BilinearForm::AllocMat()
          mfem::Mult(*face_elem, elem_dof, face_dof);
          delete face_elem;
       }
-      Transpose(face_dof, dof_face, height);
+      Transpose(face_dof, dof_face, ndofs);
       mfem::Mult(dof_face, face_dof, dof_dof);
    }
    else
    {
       // the sparsity pattern is defined from the map: element->dof
       Table dof_elem;
-      Transpose(elem_dof, dof_elem, height);
+      Transpose(elem_dof, dof_elem, ndofs);
       mfem::Mult(dof_elem, elem_dof, dof_dof);
    }
 
    dof_dof.SortRows();
 
-   int *I = dof_dof.GetI();
-   int *J = dof_dof.GetJ();
+   if (vdim == 1)
+   {
+      int *I = dof_dof.GetI();
+      int *J = dof_dof.GetJ();
+      double *data = mfem::New<double>(I[height]);
+
+      mat = new SparseMatrix(I, J, data, height, height, true, true, true);
+      *mat = 0.0;
+
+      dof_dof.LoseData();
+      return;
+   }
+
+   // Vector space: all components of the dofs in the scalar pattern are
+   // coupled. The columns are generated in increasing order for both the
+   // byNODES and the byVDIM orderings.
+   const bool bynodes = (fes->GetOrdering() == Ordering::byNODES);
+   const int *sI = dof_dof.GetI(), *sJ = dof_dof.GetJ();
+   int *I = mfem::New<int>(height+1);
+   int *J = mfem::New<int>(vdim*vdim*sI[ndofs]);
+   I[0] = 0;
+   for (int r = 0; r < height; r++)
+   {
+      const int d = bynodes ? r % ndofs : r / vdim;
+      int k = I[r];
+      for (int c = 0; c < vdim && bynodes; c++)
+      {
+         for (int p = sI[d]; p < sI[d+1]; p++) { J[k++] = sJ[p] + c*ndofs; }
+      }
+      for (int p = sI[d]; p < sI[d+1] && !bynodes; p++)
+      {
+         for (int c = 0; c < vdim; c++) { J[k++] = sJ[p]*vdim + c; }
+      }
+      I[r+1] = k;
+   }
    double *data = mfem::New<double>(I[height]);
 
    mat = new SparseMatrix(I, J, data, height, height, true, true, true);
    *mat = 0.0;
-
-   dof_dof.LoseData();
 }
 
 BilinearForm::BilinearForm(FiniteElementSpace * f)
@@ -77,6 +313,7 @@ BilinearForm::BilinearForm(FiniteElementSpace * f)
    diag_policy = DIAG_KEEP;
 
    assembly = AssemblyLevel::FULL;
+   pa_single_precision = false;
    batch = 1;
    ext = NULL;
 }
@@ -95,6 +332,7 @@ BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
    diag_policy = DIAG_KEEP;
 
    assembly = AssemblyLevel::FULL;
+   pa_single_precision = false;
    batch = 1;
    ext = NULL;
 
@@ -140,6 +378,9 @@ void BilinearForm::SetAssemblyLevel(AssemblyLevel assembly_level)
          mfem_error("Matrix-free action not supported yet... stay tuned!");
          // ext = new MFBilinearFormExtension(this);
          break;
+      case AssemblyLevel::AUTO:
+         // The level is selected in Assemble(), once the integrators are set.
+         break;
       default:
          mfem_error("Unknown assembly level");
    }
@@ -148,7 +389,7 @@ void BilinearForm::SetAssemblyLevel(AssemblyLevel assembly_level)
 void BilinearForm::EnableStaticCondensation()
 {
    delete static_cond;
-   if (assembly != AssemblyLevel::FULL)
+   if (assembly != AssemblyLevel::FULL && assembly != AssemblyLevel::AUTO)
    {
       static_cond = NULL;
       MFEM_WARNING("Static condensation not supported for this assembly level");
@@ -173,7 +414,7 @@ void BilinearForm::EnableHybridization(FiniteElementSpace *constr_space,
                                        const Array<int> &ess_tdof_list)
 {
    delete hybridization;
-   if (assembly != AssemblyLevel::FULL)
+   if (assembly != AssemblyLevel::FULL && assembly != AssemblyLevel::AUTO)
    {
       delete constr_integ;
       hybridization = NULL;
@@ -342,8 +583,153 @@ void BilinearForm::AssembleBdrElementMatrix(
    }
 }
 
+BlockSparseMatrix *BilinearForm::AssembleBlockSparse()
+{
+   MFEM_VERIFY(!static_cond && !hybridization,
+               "static condensation and hybridization are not supported");
+   MFEM_VERIFY(fbfi.Size() == 0 && bfbfi.Size() == 0,
+               "face integrators are not supported");
+   MFEM_VERIFY(fes->GetConformingProlongation() == NULL,
+               "nonconforming spaces are not supported");
+
+   Mesh *mesh = fes->GetMesh();
+   ElementTransformation *eltrans;
+   DenseMatrix elmat;
+   Array<int> dofs;
+
+   // The block graph is the scalar dof-to-dof graph of the space.
+   const Table &elem_dof = fes->GetElementToDofTable();
+   Table dof_elem, dof_dof;
+   Transpose(elem_dof, dof_elem, fes->GetNDofs());
+   mfem::Mult(dof_elem, elem_dof, dof_dof);
+   BlockSparseMatrix *bmat =
+      new BlockSparseMatrix(dof_dof, fes->GetNDofs(), fes->GetVDim(),
+                            fes->GetOrdering() == Ordering::byNODES);
+
+   for (int i = 0; i < fes->GetNE() && dbfi.Size(); i++)
+   {
+      const FiniteElement &fe = *fes->GetFE(i);
+      fes->GetElementDofs(i, dofs);
+      eltrans = fes->GetElementTransformation(i);
+      dbfi[0]->AssembleElementMatrix(fe, *eltrans, elmat);
+      for (int k = 1; k < dbfi.Size(); k++)
+      {
+         dbfi[k]->AssembleElementMatrix(fe, *eltrans, elemmat);
+         elmat += elemmat;
+      }
+      bmat->AddElementMatrix(dofs, dofs, elmat);
+   }
+
+   for (int i = 0; i < fes->GetNBE() && bbfi.Size(); i++)
+   {
+      const int bdr_attr = mesh->GetBdrAttribute(i);
+      const FiniteElement &be = *fes->GetBE(i);
+      fes->GetBdrElementDofs(i, dofs);
+      eltrans = fes->GetBdrElementTransformation(i);
+      bool empty = true;
+      for (int k = 0; k < bbfi.Size(); k++)
+      {
+         if (bbfi_marker[k] && (*bbfi_marker[k])[bdr_attr-1] == 0) { continue; }
+
+         bbfi[k]->AssembleElementMatrix(be, *eltrans, elemmat);
+         if (empty) { elmat = elemmat; empty = false; }
+         else { elmat += elemmat; }
+      }
+      if (!empty) { bmat->AddElementMatrix(dofs, dofs, elmat); }
+   }
+
+   return bmat;
+}
+
+SymmetricSparseMatrix *BilinearForm::AssembleSymmetric()
+{
+   MFEM_VERIFY(!static_cond && !hybridization,
+               "static condensation and hybridization are not supported");
+   MFEM_VERIFY(fes->GetConformingProlongation() == NULL,
+               "nonconforming spaces are not supported");
+
+   Mesh *mesh = fes->GetMesh();
+   ElementTransformation *eltrans;
+   FaceElementTransformations *tr;
+   DenseMatrix elmat;
+   Array<int> vdofs2;
+   SymmetricSparseMatrix *smat = new SymmetricSparseMatrix(height);
+
+   for (int i = 0; i < fes->GetNE() && dbfi.Size(); i++)
+   {
+      const FiniteElement &fe = *fes->GetFE(i);
+      fes->GetElementVDofs(i, vdofs);
+      eltrans = fes->GetElementTransformation(i);
+      dbfi[0]->AssembleElementMatrix(fe, *eltrans, elmat);
+      for (int k = 1; k < dbfi.Size(); k++)
+      {
+         dbfi[k]->AssembleElementMatrix(fe, *eltrans, elemmat);
+         elmat += elemmat;
+      }
+      smat->AddSubMatrix(vdofs, elmat);
+   }
+
+   for (int i = 0; i < fes->GetNBE() && bbfi.Size(); i++)
+   {
+      const int bdr_attr = mesh->GetBdrAttribute(i);
+      const FiniteElement &be = *fes->GetBE(i);
+      fes->GetBdrElementVDofs(i, vdofs);
+      eltrans = fes->GetBdrElementTransformation(i);
+      for (int k = 0; k < bbfi.Size(); k++)
+      {
+         if (bbfi_marker[k] && (*bbfi_marker[k])[bdr_attr-1] == 0) { continue; }
+
+         bbfi[k]->AssembleElementMatrix(be, *eltrans, elemmat);
+         smat->AddSubMatrix(vdofs, elemmat);
+      }
+   }
+
+   for (int i = 0; i < mesh->GetNumFaces() && fbfi.Size(); i++)
+   {
+      tr = mesh->GetInteriorFaceTransformations(i);
+      if (tr == NULL) { continue; }
+
+      fes->GetElementVDofs(tr->Elem1No, vdofs);
+      fes->GetElementVDofs(tr->Elem2No, vdofs2);
+      vdofs.Append(vdofs2);
+      for (int k = 0; k < fbfi.Size(); k++)
+      {
+         fbfi[k]->AssembleFaceMatrix(*fes->GetFE(tr->Elem1No),
+                                     *fes->GetFE(tr->Elem2No), *tr, elemmat);
+         smat->AddSubMatrix(vdofs, elemmat);
+      }
+   }
+
+   for (int i = 0; i < fes->GetNBE() && bfbfi.Size(); i++)
+   {
+      const int bdr_attr = mesh->GetBdrAttribute(i);
+      tr = mesh->GetBdrFaceTransformations(i);
+      if (tr == NULL) { continue; }
+
+      fes->GetElementVDofs(tr->Elem1No, vdofs);
+      const FiniteElement &fe1 = *fes->GetFE(tr->Elem1No);
+      for (int k = 0; k < bfbfi.Size(); k++)
+      {
+         if (bfbfi_marker[k] && (*bfbfi_marker[k])[bdr_attr-1] == 0)
+         {
+            continue;
+         }
+         bfbfi[k]->AssembleFaceMatrix(fe1, fe1, *tr, elemmat);
+         smat->AddSubMatrix(vdofs, elemmat);
+      }
+   }
+
+   smat->Finalize();
+   return smat;
+}
+
 void BilinearForm::Assemble(int skip_zeros)
 {
+   if (assembly == AssemblyLevel::AUTO)
+   {
+      SetAssemblyLevel(cost_model.Select(*this));
+   }
+
    if (Device::IsEnabled() && (assembly != AssemblyLevel::PARTIAL))
    {
       mfem_error("Chosen assembly level not supported yet in device mode!");
@@ -846,44 +1232,54 @@ void BilinearForm::EliminateEssentialBCDiag (const Array<int> &bdr_attr_is_ess,
    }
 }
 
-void BilinearForm::EliminateVDofs(const Array<int> &vdofs,
-                                  const Vector &sol, Vector &rhs,
-                                  DiagonalPolicy dpolicy)
+// Decode the (possibly negative) vdofs into nonnegative indices.
+static void DecodeVDofs(const Array<int> &vdofs, Array<int> &dofs)
 {
+   dofs.SetSize(vdofs.Size());
    for (int i = 0; i < vdofs.Size(); i++)
    {
-      int vdof = vdofs[i];
-      if ( vdof >= 0 )
-      {
-         mat -> EliminateRowCol (vdof, sol(vdof), rhs, dpolicy);
-      }
-      else
-      {
-         mat -> EliminateRowCol (-1-vdof, sol(-1-vdof), rhs, dpolicy);
-      }
+      dofs[i] = (vdofs[i] >= 0) ? vdofs[i] : -1-vdofs[i];
    }
 }
 
-void BilinearForm::EliminateVDofs(const Array<int> &vdofs,
-                                  DiagonalPolicy dpolicy)
+// Collect the indices i with ess_dofs[i] < 0.
+static void MarkerToDofs(const Array<int> &ess_dofs, Array<int> &dofs)
 {
-   if (mat_e == NULL)
+   dofs.SetSize(0);
+   for (int i = 0; i < ess_dofs.Size(); i++)
    {
-      mat_e = new SparseMatrix(height);
+      if (ess_dofs[i] < 0) { dofs.Append(i); }
    }
+}
 
-   for (int i = 0; i < vdofs.Size(); i++)
+void BilinearForm::EliminateVDofs(const Array<int> &vdofs,
+                                  const Vector &sol, Vector &rhs,
+                                  DiagonalPolicy dpolicy)
+{
+   Array<int> dofs;
+   DecodeVDofs(vdofs, dofs);
+   mat->EliminateRowsCols(dofs, sol, rhs, dpolicy);
+}
+
+void BilinearForm::EliminateVDofs(const Array<int> &vdofs,
+                                  DiagonalPolicy dpolicy)
+{
+   // Eliminate all dofs in one pass, the eliminated part is in CSR format
+   Array<int> dofs;
+   DecodeVDofs(vdofs, dofs);
+   SparseMatrix *Ae = new SparseMatrix;
+   mat->EliminateRowsCols(dofs, *Ae, dpolicy);
+   if (mat_e == NULL)
    {
-      int vdof = vdofs[i];
-      if ( vdof >= 0 )
-      {
-         mat -> EliminateRowCol (vdof, *mat_e, dpolicy);
-      }
-      else
-      {
-         mat -> EliminateRowCol (-1-vdof, *mat_e, dpolicy);
-      }
+      mat_e = Ae;
+      return;
    }
+   const int remove_zeros = 0;
+   mat_e->Finalize(remove_zeros);
+   SparseMatrix *sum = mfem::Add(*mat_e, *Ae);
+   delete Ae;
+   delete mat_e;
+   mat_e = sum;
 }
 
 void BilinearForm::EliminateEssentialBCFromDofs(
@@ -894,11 +1290,9 @@ void BilinearForm::EliminateEssentialBCFromDofs(
    MFEM_ASSERT(sol.Size() == height, "incorrect sol Vector size");
    MFEM_ASSERT(rhs.Size() == height, "incorrect rhs Vector size");
 
-   for (int i = 0; i < ess_dofs.Size(); i++)
-      if (ess_dofs[i] < 0)
-      {
-         mat -> EliminateRowCol (i, sol(i), rhs, dpolicy);
-      }
+   Array<int> dofs;
+   MarkerToDofs(ess_dofs, dofs);
+   mat->EliminateRowsCols(dofs, sol, rhs, dpolicy);
 }
 
 void BilinearForm::EliminateEssentialBCFromDofs (const Array<int> &ess_dofs,
@@ -906,11 +1300,9 @@ void BilinearForm::EliminateEssentialBCFromDofs (const Array<int> &ess_dofs,
 {
    MFEM_ASSERT(ess_dofs.Size() == height, "incorrect dof Array size");
 
-   for (int i = 0; i < ess_dofs.Size(); i++)
-      if (ess_dofs[i] < 0)
-      {
-         mat -> EliminateRowCol (i, dpolicy);
-      }
+   Array<int> dofs;
+   MarkerToDofs(ess_dofs, dofs);
+   mat->EliminateRowsCols(dofs, dpolicy);
 }
 
 void BilinearForm::EliminateEssentialBCFromDofsDiag (const Array<int> &ess_dofs,
@@ -41,6 +41,74 @@ enum class AssemblyLevel
    /// "Matrix-free" form that computes all of its action on-the-fly without any
    /// substantial storage.
    NONE,
+   /// Select FULL, ELEMENT or PARTIAL at assembly time, based on the estimates
+   /// of an AssemblyCostModel.
+   AUTO,
+};
+
+class BilinearForm;
+
+/** @brief Simple performance model used by AssemblyLevel::AUTO to estimate the
+    memory use and run time of the different assembly levels of a
+    BilinearForm.
+
+    The estimates are based on the size of the FiniteElementSpace (number of
+    elements, order, dimension, vdim) and on two machine parameters: the
+    sustained memory bandwidth and floating-point rate. These parameters have
+    conservative defaults and can be calibrated with a short on-node benchmark,
+    see Calibrate(). The selected level is the one with the smallest estimated
+    time for the setup plus a given number of operator applications, among the
+    levels that are supported for the form and fit within the memory budget. */
+class AssemblyCostModel
+{
+public:
+   /// Estimated cost of one assembly level.
+   struct Estimate
+   {
+      double memory;     ///< Storage in bytes
+      double setup_time; ///< Time for the assembly in seconds
+      double mult_time;  ///< Time for one operator application in seconds
+   };
+
+protected:
+   double bandwidth;     ///< Memory bandwidth in bytes/second
+   double flop_rate;     ///< Floating-point rate in flops/second
+   double memory_budget; ///< Memory budget in bytes, <= 0 means no limit
+   int num_mult;         ///< Expected number of operator applications
+
+public:
+   AssemblyCostModel()
+      : bandwidth(5e9), flop_rate(2e9), memory_budget(0.0), num_mult(100) { }
+
+   /// Set the memory bandwidth (bytes/s) and floating-point rate (flops/s).
+   void SetMachineParameters(double bw, double flops)
+   { bandwidth = bw; flop_rate = flops; }
+
+   /// Set the memory budget in bytes for the form; <= 0 means no limit.
+   void SetMemoryBudget(double bytes) { memory_budget = bytes; }
+
+   /// Set the expected number of operator applications after assembly.
+   void SetNumMult(int n) { num_mult = n; }
+
+   double GetBandwidth() const { return bandwidth; }
+   double GetFlopRate() const { return flop_rate; }
+
+   /** @brief Determine the machine parameters with a short benchmark (a
+       vector triad and small dense matrix-vector products).
+
+       If @a cache_file is not NULL and can be read, the parameters are loaded
+       from it and no benchmark is run. Otherwise, the benchmark is run and, if
+       @a cache_file is not NULL, the results are written to it. */
+   void Calibrate(const char *cache_file = NULL);
+
+   /// Check if the given assembly level can be used for the form @a a.
+   bool IsSupported(BilinearForm &a, AssemblyLevel level) const;
+
+   /// Estimate the cost of assembling and applying @a a with @a level.
+   Estimate GetEstimate(BilinearForm &a, AssemblyLevel level) const;
+
+   /// Select the assembly level for @a a, see the class description.
+   AssemblyLevel Select(BilinearForm &a) const;
 };
 
 
@@ -60,6 +128,11 @@ protected:
 
    /// The form assembly level (full, partial, etc.)
    AssemblyLevel assembly;
+   /// Cost model used to resolve AssemblyLevel::AUTO in Assemble()
+   AssemblyCostModel cost_model;
+   /// Store partially assembled data in single precision, see
+   /// EnableSinglePrecisionPA().
+   bool pa_single_precision;
    /// Element batch size used in the form action (1, 8, num_elems, etc.)
    int batch;
    /** Extension for supporting Full Assembly (FA), Element Assembly (EA),
@@ -118,6 +191,7 @@ protected:
       precompute_sparsity = 0;
       diag_policy = DIAG_KEEP;
       assembly = AssemblyLevel::FULL;
+      pa_single_precision = false;
       batch = 1;
       ext = NULL;
    }
@@ -150,9 +224,32 @@ public:
    int Size() const { return height; }
 
    /// Set the desired assembly level. The default is AssemblyLevel::FULL.
-   /** This method must be called before assembly. */
+   /** This method must be called before assembly. With AssemblyLevel::AUTO,
+       the actual level is chosen in Assemble() using the cost model set with
+       SetAssemblyCostModel(). */
    void SetAssemblyLevel(AssemblyLevel assembly_level);
 
+   /// Return the assembly level; AUTO is replaced by the selected level in
+   /// Assemble().
+   AssemblyLevel GetAssemblyLevel() const { return assembly; }
+
+   /// Set the cost model used with AssemblyLevel::AUTO (the model is copied).
+   void SetAssemblyCostModel(const AssemblyCostModel &cm) { cost_model = cm; }
+
+   /** @brief Store the partially assembled quadrature data in single (float)
+       precision and apply the form with single-precision kernels. */
+   /** The input and output vectors of Mult() remain in double precision; they
+       are converted at the element (E-vector) level. This halves the memory
+       traffic of the action and is intended for operators used inside
+       preconditioners. Requires AssemblyLevel::PARTIAL and integrators that
+       implement BilinearFormIntegrator::AssembleSinglePrecision(). This method
+       must be called before assembly; a change after assembly takes effect at
+       the next call to Assemble(). */
+   void EnableSinglePrecisionPA(bool sp = true) { pa_single_precision = sp; }
+
+   /// Check if single-precision partial assembly is enabled.
+   bool SinglePrecisionPAIsEnabled() const { return pa_single_precision; }
+
    /** Enable the use of static condensation. For details see the description
        for class StaticCondensation in fem/staticcond.hpp This method should be
        called before assembly. If the number of unknowns after static
@@ -163,6 +260,9 @@ public:
        EnableStaticCondensation(). */
    bool StaticCondensationIsEnabled() const { return static_cond; }
 
+   /// Return the Hybridization object, or NULL if hybridization is not used.
+   Hybridization *GetHybridization() const { return hybridization; }
+
    /// Return the trace FE space associated with static condensation.
    FiniteElementSpace *SCFESpace() const
    { return static_cond ? static_cond->GetTraceFESpace() : NULL; }
@@ -174,9 +274,15 @@ public:
                             BilinearFormIntegrator *constr_integ,
                             const Array<int> &ess_tdof_list);
 
-   /** For scalar FE spaces, precompute the sparsity pattern of the matrix
-       (assuming dense element matrices) based on the types of integrators
-       present in the bilinear form. */
+   /** @brief Precompute the sparsity pattern of the matrix (assuming dense
+       element matrices) based on the types of integrators present in the
+       bilinear form. */
+   /** The matrix is then allocated directly in the (sorted) CSR format and the
+       element contributions are added into the fixed graph, bypassing the
+       linked-list storage used by SparseMatrix before Finalize(). For vector
+       FE spaces, all components of coupled dofs are coupled. When the form is
+       reassembled after Update() with an unchanged space, the graph is reused
+       without new allocations. */
    void UsePrecomputedSparsity(int ps = 1) { precompute_sparsity = ps; }
 
    /** @brief Use the given CSR sparsity pattern to allocate the internal
@@ -270,6 +376,24 @@ public:
    }
    SparseMatrix *LoseMat() { SparseMatrix *tmp = mat; mat = NULL; return tmp; }
 
+   /** @brief Assemble the domain and boundary integrators directly into a new
+       BlockSparseMatrix with block size equal to the vector dimension of the
+       space. The returned matrix is owned by the caller. */
+   /** The block rows and columns correspond to the scalar dofs of the space and
+       the scalar indices follow its ordering (byNODES or byVDIM), so the
+       matrix can be applied to GridFunction%s on the space. The form does not
+       need to be assembled; static condensation, hybridization, face
+       integrators and nonconforming spaces are not supported. */
+   BlockSparseMatrix *AssembleBlockSparse();
+
+   /** @brief Assemble all integrators into a new SymmetricSparseMatrix, which
+       stores only the upper triangle. The returned matrix is owned by the
+       caller. */
+   /** The element and face matrices of all integrators are assumed to be
+       symmetric. The form does not need to be assembled; static condensation,
+       hybridization and nonconforming spaces are not supported. */
+   SymmetricSparseMatrix *AssembleSymmetric();
+
    /// Returns a reference to the sparse matrix of eliminated b.c.
    const SparseMatrix &SpMatElim() const
    {
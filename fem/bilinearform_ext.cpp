@@ -41,6 +41,7 @@ PABilinearFormExtension::PABilinearFormExtension(BilinearForm *form) :
    trialFes(a->FESpace()), testFes(a->FESpace()),
    localX(trialFes->GetNE() * trialFes->GetFE(0)->GetDof() * trialFes->GetVDim()),
    localY( testFes->GetNE() * testFes->GetFE(0)->GetDof() * testFes->GetVDim()),
+   single_precision(false),
    elem_restrict(new ElemRestriction(*a->FESpace())) { }
 
 PABilinearFormExtension::~PABilinearFormExtension()
@@ -52,9 +53,22 @@ void PABilinearFormExtension::Assemble()
 {
    Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
    const int integratorCount = integrators.Size();
+   single_precision = a->SinglePrecisionPAIsEnabled();
    for (int i = 0; i < integratorCount; ++i)
    {
-      integrators[i]->Assemble(*a->FESpace());
+      if (single_precision)
+      {
+         integrators[i]->AssembleSinglePrecision(*a->FESpace());
+      }
+      else
+      {
+         integrators[i]->Assemble(*a->FESpace());
+      }
+   }
+   if (single_precision)
+   {
+      localX_sp.SetSize(localX.Size());
+      localY_sp.SetSize(localY.Size());
    }
 }
 
@@ -94,10 +108,29 @@ void PABilinearFormExtension::FormLinearSystem(const Array<int> &ess_tdof_list,
    A.Reset(oper); // A will own oper
 }
 
+void PABilinearFormExtension::MultSinglePrecision() const
+{
+   Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
+   ConvertPrecision(localX.Size(), localX.GetData(), localX_sp.GetData());
+   localY_sp = 0.0f;
+   const int iSz = integrators.Size();
+   for (int i = 0; i < iSz; ++i)
+   {
+      integrators[i]->MultAssembledSinglePrecision(localX_sp, localY_sp);
+   }
+   ConvertPrecision(localY.Size(), localY_sp.GetData(), localY.GetData());
+}
+
 void PABilinearFormExtension::Mult(const Vector &x, Vector &y) const
 {
    Array<BilinearFormIntegrator*> &integrators = *a->GetDBFI();
    elem_restrict->Mult(x, localX);
+   if (single_precision)
+   {
+      MultSinglePrecision();
+      elem_restrict->MultTranspose(localY, y);
+      return;
+   }
    localY = 0.0;
    const int iSz = integrators.Size();
    for (int i = 0; i < iSz; ++i)
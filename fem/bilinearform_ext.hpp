@@ -108,8 +108,16 @@ class PABilinearFormExtension : public BilinearFormExtension
 protected:
    const FiniteElementSpace *trialFes, *testFes;
    mutable Vector localX, localY;
+   /// Single-precision E-vectors, see BilinearForm::EnableSinglePrecisionPA()
+   mutable Array<float> localX_sp, localY_sp;
+   /** Precision of the last Assemble(); Mult() uses it rather than the current
+       setting of the form, which may change before the next assembly. */
+   bool single_precision;
    ElemRestriction *elem_restrict;
 
+   /// Apply the single-precision integrators to the E-vector #localX.
+   void MultSinglePrecision() const;
+
 public:
    PABilinearFormExtension(BilinearForm*);
 
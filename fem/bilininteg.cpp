@@ -37,6 +37,19 @@ void BilinearFormIntegrator::MultAssembledTranspose(Vector&, Vector&)
                "   is not implemented for this class.");
 }
 
+void BilinearFormIntegrator::AssembleSinglePrecision(const FiniteElementSpace&)
+{
+   mfem_error ("BilinearFormIntegrator::AssembleSinglePrecision (...)\n"
+               "   is not implemented for this class.");
+}
+
+void BilinearFormIntegrator::MultAssembledSinglePrecision(Array<float>&,
+                                                          Array<float>&)
+{
+   mfem_error ("BilinearFormIntegrator::MultAssembledSinglePrecision (...)\n"
+               "   is not implemented for this class.");
+}
+
 void BilinearFormIntegrator::AssembleElementMatrix (
    const FiniteElement &el, ElementTransformation &Trans,
    DenseMatrix &elmat )
@@ -37,6 +37,18 @@ public:
    /// Method for partially assembled transposed action.
    virtual void MultAssembledTranspose(Vector&, Vector&);
 
+   /** @brief Return true if Assemble() and MultAssembled() are implemented
+       for this integrator with its current coefficient. */
+   virtual bool SupportsPartialAssembly() const { return false; }
+
+   /** @brief Method defining partial assembly with the quadrature data stored
+       in single precision. */
+   virtual void AssembleSinglePrecision(const FiniteElementSpace&);
+
+   /** @brief Method for partially assembled action using the single-precision
+       data computed by AssembleSinglePrecision(). */
+   virtual void MultAssembledSinglePrecision(Array<float>&, Array<float>&);
+
    /// Given a particular Finite Element computes the element matrix elmat.
    virtual void AssembleElementMatrix(const FiniteElement &el,
                                       ElementTransformation &Trans,
@@ -1649,6 +1661,7 @@ private:
    DofToQuad *maps;
    GeometryExtension *geom;
    int dim, ne, dofs1D, quad1D;
+   Array<float> vec_sp;
 public:
    /// Construct a diffusion integrator with coefficient Q = 1
    DiffusionIntegrator() { Q = NULL; MQ = NULL; maps = NULL; geom = NULL; }
@@ -1688,6 +1701,9 @@ public:
    /// PA extension
    virtual void Assemble(const FiniteElementSpace&);
    virtual void MultAssembled(Vector&, Vector&);
+   virtual void AssembleSinglePrecision(const FiniteElementSpace&);
+   virtual void MultAssembledSinglePrecision(Array<float>&, Array<float>&);
+   virtual bool SupportsPartialAssembly() const;
 
    virtual ~DiffusionIntegrator();
 };
@@ -1702,6 +1718,7 @@ protected:
    Coefficient *Q;
    // PA extension
    Vector vec;
+   Array<float> vec_sp;
    DofToQuad *maps;
    GeometryExtension *geom;
    int dim, ne, nq, dofs1D, quad1D;
@@ -1724,6 +1741,9 @@ public:
    /// PA extension
    virtual void Assemble(const FiniteElementSpace&);
    virtual void MultAssembled(Vector&, Vector&);
+   virtual void AssembleSinglePrecision(const FiniteElementSpace&);
+   virtual void MultAssembledSinglePrecision(Array<float>&, Array<float>&);
+   virtual bool SupportsPartialAssembly() const;
 
    virtual ~MassIntegrator();
 };
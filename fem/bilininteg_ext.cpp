@@ -249,6 +249,7 @@ void DiffusionIntegrator::Assemble(const FiniteElementSpace &fes)
    ne = fes.GetNE();
    dofs1D = el.GetOrder() + 1;
    quad1D = IntRules.Get(Geometry::SEGMENT, ir->GetOrder()).GetNPoints();
+   delete geom;
    geom = GeometryExtension::Get(fes,*ir);
    maps = DofToQuad::Get(fes, fes, *ir);
    vec.SetSize(symmDims * nq * ne);
@@ -364,15 +365,15 @@ const int MAX_Q1D = 10;
 const int MAX_D1D = 10;
 
 // PA Diffusion Apply 2D kernel
-template<int T_D1D = 0, int T_Q1D = 0> static
+template<int T_D1D = 0, int T_Q1D = 0, typename real_t = double> static
 void PADiffusionApply2D(const int NE,
-                        const double* b,
-                        const double* g,
-                        const double* bt,
-                        const double* gt,
-                        const double* _op,
-                        const double* _x,
-                        double* _y,
+                        const real_t* b,
+                        const real_t* g,
+                        const real_t* bt,
+                        const real_t* gt,
+                        const real_t* _op,
+                        const real_t* _x,
+                        real_t* _y,
                         const int d1d = 0,
                         const int q1d = 0)
 {
@@ -381,20 +382,20 @@ void PADiffusionApply2D(const int NE,
    MFEM_VERIFY(D1D <= MAX_D1D, "");
    MFEM_VERIFY(Q1D <= MAX_Q1D, "");
 
-   const DeviceMatrix B(b, Q1D, D1D);
-   const DeviceMatrix G(g, Q1D, D1D);
-   const DeviceMatrix Bt(bt, D1D, Q1D);
-   const DeviceMatrix Gt(gt, D1D, Q1D);
-   const DeviceTensor<3> op(_op, 3, Q1D*Q1D, NE);
-   const DeviceTensor<3> x(_x, D1D, D1D, NE);
-   DeviceTensor<3> y(_y, D1D, D1D, NE);
+   const DeviceTensor<2,real_t> B(b, Q1D, D1D);
+   const DeviceTensor<2,real_t> G(g, Q1D, D1D);
+   const DeviceTensor<2,real_t> Bt(bt, D1D, Q1D);
+   const DeviceTensor<2,real_t> Gt(gt, D1D, Q1D);
+   const DeviceTensor<3,real_t> op(_op, 3, Q1D*Q1D, NE);
+   const DeviceTensor<3,real_t> x(_x, D1D, D1D, NE);
+   DeviceTensor<3,real_t> y(_y, D1D, D1D, NE);
 
    MFEM_FORALL(e, NE,
    {
       const int D1D = T_D1D ? T_D1D : d1d; // nvcc workaround
       const int Q1D = T_Q1D ? T_Q1D : q1d;
 
-      double grad[MAX_Q1D][MAX_Q1D][2];
+      real_t grad[MAX_Q1D][MAX_Q1D][2];
       for (int qy = 0; qy < Q1D; ++qy)
       {
          for (int qx = 0; qx < Q1D; ++qx)
@@ -405,7 +406,7 @@ void PADiffusionApply2D(const int NE,
       }
       for (int dy = 0; dy < D1D; ++dy)
       {
-         double gradX[MAX_Q1D][2];
+         real_t gradX[MAX_Q1D][2];
          for (int qx = 0; qx < Q1D; ++qx)
          {
             gradX[qx][0] = 0.0;
@@ -413,7 +414,7 @@ void PADiffusionApply2D(const int NE,
          }
          for (int dx = 0; dx < D1D; ++dx)
          {
-            const double s = x(dx,dy,e);
+            const real_t s = x(dx,dy,e);
             for (int qx = 0; qx < Q1D; ++qx)
             {
                gradX[qx][0] += s * B(qx,dx);
@@ -422,8 +423,8 @@ void PADiffusionApply2D(const int NE,
          }
          for (int qy = 0; qy < Q1D; ++qy)
          {
-            const double wy  = B(qy,dy);
-            const double wDy = G(qy,dy);
+            const real_t wy  = B(qy,dy);
+            const real_t wDy = G(qy,dy);
             for (int qx = 0; qx < Q1D; ++qx)
             {
                grad[qy][qx][0] += gradX[qx][1] * wy;
@@ -438,12 +439,12 @@ void PADiffusionApply2D(const int NE,
          {
             const int q = QUAD_2D_ID(qx, qy);
 
-            const double O11 = op(0,q,e);
-            const double O12 = op(1,q,e);
-            const double O22 = op(2,q,e);
+            const real_t O11 = op(0,q,e);
+            const real_t O12 = op(1,q,e);
+            const real_t O22 = op(2,q,e);
 
-            const double gradX = grad[qy][qx][0];
-            const double gradY = grad[qy][qx][1];
+            const real_t gradX = grad[qy][qx][0];
+            const real_t gradY = grad[qy][qx][1];
 
             grad[qy][qx][0] = (O11 * gradX) + (O12 * gradY);
             grad[qy][qx][1] = (O12 * gradX) + (O22 * gradY);
@@ -451,7 +452,7 @@ void PADiffusionApply2D(const int NE,
       }
       for (int qy = 0; qy < Q1D; ++qy)
       {
-         double gradX[MAX_D1D][2];
+         real_t gradX[MAX_D1D][2];
          for (int dx = 0; dx < D1D; ++dx)
          {
             gradX[dx][0] = 0;
@@ -459,20 +460,20 @@ void PADiffusionApply2D(const int NE,
          }
          for (int qx = 0; qx < Q1D; ++qx)
          {
-            const double gX = grad[qy][qx][0];
-            const double gY = grad[qy][qx][1];
+            const real_t gX = grad[qy][qx][0];
+            const real_t gY = grad[qy][qx][1];
             for (int dx = 0; dx < D1D; ++dx)
             {
-               const double wx  = Bt(dx,qx);
-               const double wDx = Gt(dx,qx);
+               const real_t wx  = Bt(dx,qx);
+               const real_t wDx = Gt(dx,qx);
                gradX[dx][0] += gX * wDx;
                gradX[dx][1] += gY * wx;
             }
          }
          for (int dy = 0; dy < D1D; ++dy)
          {
-            const double wy  = Bt(dy,qy);
-            const double wDy = Gt(dy,qy);
+            const real_t wy  = Bt(dy,qy);
+            const real_t wDy = Gt(dy,qy);
             for (int dx = 0; dx < D1D; ++dx)
             {
                y(dx,dy,e) += ((gradX[dx][0] * wy) + (gradX[dx][1] * wDy));
@@ -483,15 +484,15 @@ void PADiffusionApply2D(const int NE,
 }
 
 // PA Diffusion Apply 3D kernel
-template<int T_D1D = 0, int T_Q1D = 0> static
+template<int T_D1D = 0, int T_Q1D = 0, typename real_t = double> static
 void PADiffusionApply3D(const int NE,
-                        const double* b,
-                        const double* g,
-                        const double* bt,
-                        const double* gt,
-                        const double* _op,
-                        const double* _x,
-                        double* _y,
+                        const real_t* b,
+                        const real_t* g,
+                        const real_t* bt,
+                        const real_t* gt,
+                        const real_t* _op,
+                        const real_t* _x,
+                        real_t* _y,
                         int d1d = 0, int q1d = 0)
 {
    const int D1D = T_D1D ? T_D1D : d1d;
@@ -499,20 +500,20 @@ void PADiffusionApply3D(const int NE,
    MFEM_VERIFY(D1D <= MAX_D1D, "");
    MFEM_VERIFY(Q1D <= MAX_Q1D, "");
 
-   const DeviceMatrix B(b, Q1D, D1D);
-   const DeviceMatrix G(g, Q1D, D1D);
-   const DeviceMatrix Bt(bt, D1D, Q1D);
-   const DeviceMatrix Gt(gt, D1D, Q1D);
-   const DeviceTensor<3> op(_op, 6, Q1D*Q1D*Q1D, NE);
-   const DeviceTensor<4> x(_x, D1D, D1D, D1D, NE);
-   DeviceTensor<4> y(_y, D1D, D1D, D1D, NE);
+   const DeviceTensor<2,real_t> B(b, Q1D, D1D);
+   const DeviceTensor<2,real_t> G(g, Q1D, D1D);
+   const DeviceTensor<2,real_t> Bt(bt, D1D, Q1D);
+   const DeviceTensor<2,real_t> Gt(gt, D1D, Q1D);
+   const DeviceTensor<3,real_t> op(_op, 6, Q1D*Q1D*Q1D, NE);
+   const DeviceTensor<4,real_t> x(_x, D1D, D1D, D1D, NE);
+   DeviceTensor<4,real_t> y(_y, D1D, D1D, D1D, NE);
 
    MFEM_FORALL(e, NE,
    {
       const int D1D = T_D1D ? T_D1D : d1d; // nvcc workaround
       const int Q1D = T_Q1D ? T_Q1D : q1d;
 
-      double grad[MAX_Q1D][MAX_Q1D][MAX_Q1D][4];
+      real_t grad[MAX_Q1D][MAX_Q1D][MAX_Q1D][4];
       for (int qz = 0; qz < Q1D; ++qz)
       {
          for (int qy = 0; qy < Q1D; ++qy)
@@ -527,7 +528,7 @@ void PADiffusionApply3D(const int NE,
       }
       for (int dz = 0; dz < D1D; ++dz)
       {
-         double gradXY[MAX_Q1D][MAX_Q1D][4];
+         real_t gradXY[MAX_Q1D][MAX_Q1D][4];
          for (int qy = 0; qy < Q1D; ++qy)
          {
             for (int qx = 0; qx < Q1D; ++qx)
@@ -539,7 +540,7 @@ void PADiffusionApply3D(const int NE,
          }
          for (int dy = 0; dy < D1D; ++dy)
          {
-            double gradX[MAX_Q1D][2];
+            real_t gradX[MAX_Q1D][2];
             for (int qx = 0; qx < Q1D; ++qx)
             {
                gradX[qx][0] = 0.0;
@@ -547,7 +548,7 @@ void PADiffusionApply3D(const int NE,
             }
             for (int dx = 0; dx < D1D; ++dx)
             {
-               const double s = x(dx,dy,dz,e);
+               const real_t s = x(dx,dy,dz,e);
                for (int qx = 0; qx < Q1D; ++qx)
                {
                   gradX[qx][0] += s * B(qx,dx);
@@ -556,12 +557,12 @@ void PADiffusionApply3D(const int NE,
             }
             for (int qy = 0; qy < Q1D; ++qy)
             {
-               const double wy  = B(qy,dy);
-               const double wDy = G(qy,dy);
+               const real_t wy  = B(qy,dy);
+               const real_t wDy = G(qy,dy);
                for (int qx = 0; qx < Q1D; ++qx)
                {
-                  const double wx  = gradX[qx][0];
-                  const double wDx = gradX[qx][1];
+                  const real_t wx  = gradX[qx][0];
+                  const real_t wDx = gradX[qx][1];
                   gradXY[qy][qx][0] += wDx * wy;
                   gradXY[qy][qx][1] += wx  * wDy;
                   gradXY[qy][qx][2] += wx  * wy;
@@ -570,8 +571,8 @@ void PADiffusionApply3D(const int NE,
          }
          for (int qz = 0; qz < Q1D; ++qz)
          {
-            const double wz  = B(qz,dz);
-            const double wDz = G(qz,dz);
+            const real_t wz  = B(qz,dz);
+            const real_t wDz = G(qz,dz);
             for (int qy = 0; qy < Q1D; ++qy)
             {
                for (int qx = 0; qx < Q1D; ++qx)
@@ -591,15 +592,15 @@ void PADiffusionApply3D(const int NE,
             for (int qx = 0; qx < Q1D; ++qx)
             {
                const int q = QUAD_3D_ID(qx, qy, qz);
-               const double O11 = op(0,q,e);
-               const double O12 = op(1,q,e);
-               const double O13 = op(2,q,e);
-               const double O22 = op(3,q,e);
-               const double O23 = op(4,q,e);
-               const double O33 = op(5,q,e);
-               const double gradX = grad[qz][qy][qx][0];
-               const double gradY = grad[qz][qy][qx][1];
-               const double gradZ = grad[qz][qy][qx][2];
+               const real_t O11 = op(0,q,e);
+               const real_t O12 = op(1,q,e);
+               const real_t O13 = op(2,q,e);
+               const real_t O22 = op(3,q,e);
+               const real_t O23 = op(4,q,e);
+               const real_t O33 = op(5,q,e);
+               const real_t gradX = grad[qz][qy][qx][0];
+               const real_t gradY = grad[qz][qy][qx][1];
+               const real_t gradZ = grad[qz][qy][qx][2];
                grad[qz][qy][qx][0] = (O11*gradX)+(O12*gradY)+(O13*gradZ);
                grad[qz][qy][qx][1] = (O12*gradX)+(O22*gradY)+(O23*gradZ);
                grad[qz][qy][qx][2] = (O13*gradX)+(O23*gradY)+(O33*gradZ);
@@ -608,7 +609,7 @@ void PADiffusionApply3D(const int NE,
       }
       for (int qz = 0; qz < Q1D; ++qz)
       {
-         double gradXY[MAX_D1D][MAX_D1D][4];
+         real_t gradXY[MAX_D1D][MAX_D1D][4];
          for (int dy = 0; dy < D1D; ++dy)
          {
             for (int dx = 0; dx < D1D; ++dx)
@@ -620,7 +621,7 @@ void PADiffusionApply3D(const int NE,
          }
          for (int qy = 0; qy < Q1D; ++qy)
          {
-            double gradX[MAX_D1D][4];
+            real_t gradX[MAX_D1D][4];
             for (int dx = 0; dx < D1D; ++dx)
             {
                gradX[dx][0] = 0;
@@ -629,13 +630,13 @@ void PADiffusionApply3D(const int NE,
             }
             for (int qx = 0; qx < Q1D; ++qx)
             {
-               const double gX = grad[qz][qy][qx][0];
-               const double gY = grad[qz][qy][qx][1];
-               const double gZ = grad[qz][qy][qx][2];
+               const real_t gX = grad[qz][qy][qx][0];
+               const real_t gY = grad[qz][qy][qx][1];
+               const real_t gZ = grad[qz][qy][qx][2];
                for (int dx = 0; dx < D1D; ++dx)
                {
-                  const double wx  = Bt(dx,qx);
-                  const double wDx = Gt(dx,qx);
+                  const real_t wx  = Bt(dx,qx);
+                  const real_t wDx = Gt(dx,qx);
                   gradX[dx][0] += gX * wDx;
                   gradX[dx][1] += gY * wx;
                   gradX[dx][2] += gZ * wx;
@@ -643,8 +644,8 @@ void PADiffusionApply3D(const int NE,
             }
             for (int dy = 0; dy < D1D; ++dy)
             {
-               const double wy  = Bt(dy,qy);
-               const double wDy = Gt(dy,qy);
+               const real_t wy  = Bt(dy,qy);
+               const real_t wDy = Gt(dy,qy);
                for (int dx = 0; dx < D1D; ++dx)
                {
                   gradXY[dy][dx][0] += gradX[dx][0] * wy;
@@ -655,8 +656,8 @@ void PADiffusionApply3D(const int NE,
          }
          for (int dz = 0; dz < D1D; ++dz)
          {
-            const double wz  = Bt(dz,qz);
-            const double wDz = Gt(dz,qz);
+            const real_t wz  = Bt(dz,qz);
+            const real_t wDz = Gt(dz,qz);
             for (int dy = 0; dy < D1D; ++dy)
             {
                for (int dx = 0; dx < D1D; ++dx)
@@ -672,6 +673,47 @@ void PADiffusionApply3D(const int NE,
    });
 }
 
+// PA Diffusion Apply kernel dispatch, double or single precision
+template <typename real_t> static
+void PADiffusionApplyTensor(const int dim,
+                            const int D1D,
+                            const int Q1D,
+                            const int NE,
+                            const real_t* B,
+                            const real_t* G,
+                            const real_t* Bt,
+                            const real_t* Gt,
+                            const real_t* op,
+                            const real_t* x,
+                            real_t* y)
+{
+   if (dim == 2)
+   {
+      switch ((D1D << 4) | Q1D)
+      {
+         case 0x22: PADiffusionApply2D<2,2>(NE, B, G, Bt, Gt, op, x, y); break;
+         case 0x33: PADiffusionApply2D<3,3>(NE, B, G, Bt, Gt, op, x, y); break;
+         case 0x44: PADiffusionApply2D<4,4>(NE, B, G, Bt, Gt, op, x, y); break;
+         case 0x55: PADiffusionApply2D<5,5>(NE, B, G, Bt, Gt, op, x, y); break;
+         default: PADiffusionApply2D(NE, B, G, Bt, Gt, op, x, y, D1D, Q1D);
+      }
+      return;
+   }
+   if (dim == 3)
+   {
+      switch ((D1D << 4) | Q1D)
+      {
+         case 0x23: PADiffusionApply3D<2,3>(NE, B, G, Bt, Gt, op, x, y); break;
+         case 0x34: PADiffusionApply3D<3,4>(NE, B, G, Bt, Gt, op, x, y); break;
+         case 0x45: PADiffusionApply3D<4,5>(NE, B, G, Bt, Gt, op, x, y); break;
+         case 0x56: PADiffusionApply3D<5,6>(NE, B, G, Bt, Gt, op, x, y); break;
+         default: PADiffusionApply3D(NE, B, G, Bt, Gt, op, x, y, D1D, Q1D);
+      }
+      return;
+   }
+   MFEM_ABORT("Unknown kernel.");
+}
+
 static void PADiffusionApply(const int dim,
                              const int D1D,
                              const int Q1D,
@@ -700,32 +742,7 @@ static void PADiffusionApply(const int dim,
       MFEM_ABORT("OCCA PADiffusionApply unknown kernel!");
    }
 #endif // MFEM_USE_OCCA
-
-   if (dim == 2)
-   {
-      switch ((D1D << 4) | Q1D)
-      {
-         case 0x22: PADiffusionApply2D<2,2>(NE, B, G, Bt, Gt, op, x, y); break;
-         case 0x33: PADiffusionApply2D<3,3>(NE, B, G, Bt, Gt, op, x, y); break;
-         case 0x44: PADiffusionApply2D<4,4>(NE, B, G, Bt, Gt, op, x, y); break;
-         case 0x55: PADiffusionApply2D<5,5>(NE, B, G, Bt, Gt, op, x, y); break;
-         default: PADiffusionApply2D(NE, B, G, Bt, Gt, op, x, y, D1D, Q1D);
-      }
-      return;
-   }
-   if (dim == 3)
-   {
-      switch ((D1D << 4) | Q1D)
-      {
-         case 0x23: PADiffusionApply3D<2,3>(NE, B, G, Bt, Gt, op, x, y); break;
-         case 0x34: PADiffusionApply3D<3,4>(NE, B, G, Bt, Gt, op, x, y); break;
-         case 0x45: PADiffusionApply3D<4,5>(NE, B, G, Bt, Gt, op, x, y); break;
-         case 0x56: PADiffusionApply3D<5,6>(NE, B, G, Bt, Gt, op, x, y); break;
-         default: PADiffusionApply3D(NE, B, G, Bt, Gt, op, x, y, D1D, Q1D);
-      }
-      return;
-   }
-   MFEM_ABORT("Unknown kernel.");
+   PADiffusionApplyTensor(dim, D1D, Q1D, NE, B, G, Bt, Gt, op, x, y);
 }
 
 // PA Diffusion Apply kernel
@@ -736,10 +753,35 @@ void DiffusionIntegrator::MultAssembled(Vector &x, Vector &y)
                     vec, x, y);
 }
 
+// PA Diffusion Assemble with single-precision quadrature data: the setup is
+// computed in double precision and then rounded.
+void DiffusionIntegrator::AssembleSinglePrecision(const FiniteElementSpace &fes)
+{
+   Assemble(fes);
+   maps->MakeSinglePrecision();
+   vec_sp.SetSize(vec.Size());
+   ConvertPrecision(vec.Size(), vec.GetData(), vec_sp.GetData());
+   vec.Destroy();
+}
+
+// PA Diffusion Apply kernel with single-precision data
+void DiffusionIntegrator::MultAssembledSinglePrecision(Array<float> &x,
+                                                       Array<float> &y)
+{
+   PADiffusionApplyTensor(dim, dofs1D, quad1D, ne,
+                          maps->B_sp.GetData(), maps->G_sp.GetData(),
+                          maps->Bt_sp.GetData(), maps->Gt_sp.GetData(),
+                          vec_sp.GetData(), x.GetData(), y.GetData());
+}
+
+bool DiffusionIntegrator::SupportsPartialAssembly() const
+{
+   return (MQ == NULL && dynamic_cast<ConstantCoefficient*>(Q));
+}
+
 DiffusionIntegrator::~DiffusionIntegrator()
 {
    delete geom;
-   delete maps;
 }
 
 // PA Mass Assemble kernel
@@ -754,6 +796,7 @@ void MassIntegrator::Assemble(const FiniteElementSpace &fes)
    nq = ir->GetNPoints();
    dofs1D = el.GetOrder() + 1;
    quad1D = IntRules.Get(Geometry::SEGMENT, ir->GetOrder()).GetNPoints();
+   delete geom;
    geom = GeometryExtension::Get(fes,*ir);
    maps = DofToQuad::Get(fes, fes, *ir);
    vec.SetSize(ne*nq);
@@ -936,13 +979,14 @@ static void OccaPAMassApply3D(const int D1D,
 }
 #endif // MFEM_USE_OCCA
 
-template<const int T_D1D = 0, const int T_Q1D = 0> static
+template<const int T_D1D = 0, const int T_Q1D = 0,
+         typename real_t = double> static
 void PAMassApply2D(const int NE,
-                   const double* _B,
-                   const double* _Bt,
-                   const double* _op,
-                   const double* _x,
-                   double* _y,
+                   const real_t* _B,
+                   const real_t* _Bt,
+                   const real_t* _op,
+                   const real_t* _x,
+                   real_t* _y,
                    const int d1d = 0,
                    const int q1d = 0)
 {
@@ -951,18 +995,18 @@ void PAMassApply2D(const int NE,
    MFEM_VERIFY(D1D <= MAX_D1D, "");
    MFEM_VERIFY(Q1D <= MAX_Q1D, "");
 
-   const DeviceMatrix B(_B, Q1D, D1D);
-   const DeviceMatrix Bt(_Bt, D1D, Q1D);
-   const DeviceTensor<3> op(_op, Q1D, Q1D, NE);
-   const DeviceTensor<3> x(_x, D1D, D1D, NE);
-   DeviceTensor<3> y(_y, D1D, D1D, NE);
+   const DeviceTensor<2,real_t> B(_B, Q1D, D1D);
+   const DeviceTensor<2,real_t> Bt(_Bt, D1D, Q1D);
+   const DeviceTensor<3,real_t> op(_op, Q1D, Q1D, NE);
+   const DeviceTensor<3,real_t> x(_x, D1D, D1D, NE);
+   DeviceTensor<3,real_t> y(_y, D1D, D1D, NE);
 
    MFEM_FORALL(e, NE,
    {
       const int D1D = T_D1D ? T_D1D : d1d; // nvcc workaround
       const int Q1D = T_Q1D ? T_Q1D : q1d;
 
-      double sol_xy[MAX_Q1D][MAX_Q1D];
+      real_t sol_xy[MAX_Q1D][MAX_Q1D];
       for (int qy = 0; qy < Q1D; ++qy)
       {
          for (int qx = 0; qx < Q1D; ++qx)
@@ -972,14 +1016,14 @@ void PAMassApply2D(const int NE,
       }
       for (int dy = 0; dy < D1D; ++dy)
       {
-         double sol_x[MAX_Q1D];
+         real_t sol_x[MAX_Q1D];
          for (int qy = 0; qy < Q1D; ++qy)
          {
             sol_x[qy] = 0.0;
          }
          for (int dx = 0; dx < D1D; ++dx)
          {
-            const double s = x(dx,dy,e);
+            const real_t s = x(dx,dy,e);
             for (int qx = 0; qx < Q1D; ++qx)
             {
                sol_x[qx] += B(qx,dx)* s;
@@ -987,7 +1031,7 @@ void PAMassApply2D(const int NE,
          }
          for (int qy = 0; qy < Q1D; ++qy)
          {
-            const double d2q = B(qy,dy);
+            const real_t d2q = B(qy,dy);
             for (int qx = 0; qx < Q1D; ++qx)
             {
                sol_xy[qy][qx] += d2q * sol_x[qx];
@@ -1003,14 +1047,14 @@ void PAMassApply2D(const int NE,
       }
       for (int qy = 0; qy < Q1D; ++qy)
       {
-         double sol_x[MAX_D1D];
+         real_t sol_x[MAX_D1D];
          for (int dx = 0; dx < D1D; ++dx)
          {
             sol_x[dx] = 0.0;
          }
          for (int qx = 0; qx < Q1D; ++qx)
          {
-            const double s = sol_xy[qy][qx];
+            const real_t s = sol_xy[qy][qx];
             for (int dx = 0; dx < D1D; ++dx)
             {
                sol_x[dx] += Bt(dx,qx) * s;
@@ -1018,7 +1062,7 @@ void PAMassApply2D(const int NE,
          }
          for (int dy = 0; dy < D1D; ++dy)
          {
-            const double q2d = Bt(dy,qy);
+            const real_t q2d = Bt(dy,qy);
             for (int dx = 0; dx < D1D; ++dx)
             {
                y(dx,dy,e) += q2d * sol_x[dx];
@@ -1028,13 +1072,14 @@ void PAMassApply2D(const int NE,
    });
 }
 
-template<const int T_D1D = 0, const int T_Q1D = 0> static
+template<const int T_D1D = 0, const int T_Q1D = 0,
+         typename real_t = double> static
 void PAMassApply3D(const int NE,
-                   const double* _B,
-                   const double* _Bt,
-                   const double* _op,
-                   const double* _x,
-                   double* _y,
+                   const real_t* _B,
+                   const real_t* _Bt,
+                   const real_t* _op,
+                   const real_t* _x,
+                   real_t* _y,
                    const int d1d = 0,
                    const int q1d = 0)
 {
@@ -1043,18 +1088,18 @@ void PAMassApply3D(const int NE,
    MFEM_VERIFY(D1D <= MAX_D1D, "");
    MFEM_VERIFY(Q1D <= MAX_Q1D, "");
 
-   const DeviceMatrix B(_B, Q1D, D1D);
-   const DeviceMatrix Bt(_Bt, D1D, Q1D);
-   const DeviceTensor<4> op(_op, Q1D, Q1D, Q1D,NE);
-   const DeviceTensor<4> x(_x, D1D, D1D, D1D, NE);
-   DeviceTensor<4> y(_y, D1D, D1D, D1D, NE);
+   const DeviceTensor<2,real_t> B(_B, Q1D, D1D);
+   const DeviceTensor<2,real_t> Bt(_Bt, D1D, Q1D);
+   const DeviceTensor<4,real_t> op(_op, Q1D, Q1D, Q1D,NE);
+   const DeviceTensor<4,real_t> x(_x, D1D, D1D, D1D, NE);
+   DeviceTensor<4,real_t> y(_y, D1D, D1D, D1D, NE);
 
    MFEM_FORALL(e, NE,
    {
       const int D1D = T_D1D ? T_D1D : d1d; // nvcc workaround
       const int Q1D = T_Q1D ? T_Q1D : q1d;
 
-      double sol_xyz[MAX_Q1D][MAX_Q1D][MAX_Q1D];
+      real_t sol_xyz[MAX_Q1D][MAX_Q1D][MAX_Q1D];
       for (int qz = 0; qz < Q1D; ++qz)
       {
          for (int qy = 0; qy < Q1D; ++qy)
@@ -1067,7 +1112,7 @@ void PAMassApply3D(const int NE,
       }
       for (int dz = 0; dz < D1D; ++dz)
       {
-         double sol_xy[MAX_Q1D][MAX_Q1D];
+         real_t sol_xy[MAX_Q1D][MAX_Q1D];
          for (int qy = 0; qy < Q1D; ++qy)
          {
             for (int qx = 0; qx < Q1D; ++qx)
@@ -1077,14 +1122,14 @@ void PAMassApply3D(const int NE,
          }
          for (int dy = 0; dy < D1D; ++dy)
          {
-            double sol_x[MAX_Q1D];
+            real_t sol_x[MAX_Q1D];
             for (int qx = 0; qx < Q1D; ++qx)
             {
                sol_x[qx] = 0;
             }
             for (int dx = 0; dx < D1D; ++dx)
             {
-               const double s = x(dx,dy,dz,e);
+               const real_t s = x(dx,dy,dz,e);
                for (int qx = 0; qx < Q1D; ++qx)
                {
                   sol_x[qx] += B(qx,dx) * s;
@@ -1092,7 +1137,7 @@ void PAMassApply3D(const int NE,
             }
             for (int qy = 0; qy < Q1D; ++qy)
             {
-               const double wy = B(qy,dy);
+               const real_t wy = B(qy,dy);
                for (int qx = 0; qx < Q1D; ++qx)
                {
                   sol_xy[qy][qx] += wy * sol_x[qx];
@@ -1101,7 +1146,7 @@ void PAMassApply3D(const int NE,
          }
          for (int qz = 0; qz < Q1D; ++qz)
          {
-            const double wz = B(qz,dz);
+            const real_t wz = B(qz,dz);
             for (int qy = 0; qy < Q1D; ++qy)
             {
                for (int qx = 0; qx < Q1D; ++qx)
@@ -1123,7 +1168,7 @@ void PAMassApply3D(const int NE,
       }
       for (int qz = 0; qz < Q1D; ++qz)
       {
-         double sol_xy[MAX_D1D][MAX_D1D];
+         real_t sol_xy[MAX_D1D][MAX_D1D];
          for (int dy = 0; dy < D1D; ++dy)
          {
             for (int dx = 0; dx < D1D; ++dx)
@@ -1133,14 +1178,14 @@ void PAMassApply3D(const int NE,
          }
          for (int qy = 0; qy < Q1D; ++qy)
          {
-            double sol_x[MAX_D1D];
+            real_t sol_x[MAX_D1D];
             for (int dx = 0; dx < D1D; ++dx)
             {
                sol_x[dx] = 0;
             }
             for (int qx = 0; qx < Q1D; ++qx)
             {
-               const double s = sol_xyz[qz][qy][qx];
+               const real_t s = sol_xyz[qz][qy][qx];
                for (int dx = 0; dx < D1D; ++dx)
                {
                   sol_x[dx] += Bt(dx,qx) * s;
@@ -1148,7 +1193,7 @@ void PAMassApply3D(const int NE,
             }
             for (int dy = 0; dy < D1D; ++dy)
             {
-               const double wy = Bt(dy,qy);
+               const real_t wy = Bt(dy,qy);
                for (int dx = 0; dx < D1D; ++dx)
                {
                   sol_xy[dy][dx] += wy * sol_x[dx];
@@ -1157,7 +1202,7 @@ void PAMassApply3D(const int NE,
          }
          for (int dz = 0; dz < D1D; ++dz)
          {
-            const double wz = Bt(dz,qz);
+            const real_t wz = Bt(dz,qz);
             for (int dy = 0; dy < D1D; ++dy)
             {
                for (int dx = 0; dx < D1D; ++dx)
@@ -1170,32 +1215,18 @@ void PAMassApply3D(const int NE,
    });
 }
 
-static void PAMassApply(const int dim,
-                        const int D1D,
-                        const int Q1D,
-                        const int NE,
-                        const double* B,
-                        const double* Bt,
-                        const double* op,
-                        const double* x,
-                        double* y)
+// PA Mass Apply kernel dispatch, double or single precision
+template <typename real_t> static
+void PAMassApplyTensor(const int dim,
+                       const int D1D,
+                       const int Q1D,
+                       const int NE,
+                       const real_t* B,
+                       const real_t* Bt,
+                       const real_t* op,
+                       const real_t* x,
+                       real_t* y)
 {
-#ifdef MFEM_USE_OCCA
-   if (internal::DeviceUseOcca())
-   {
-      if (dim == 2)
-      {
-         OccaPAMassApply2D(D1D, Q1D, NE, B, Bt, op, x, y);
-         return;
-      }
-      if (dim == 3)
-      {
-         OccaPAMassApply3D(D1D, Q1D, NE, B, Bt, op, x, y);
-         return;
-      }
-      MFEM_ABORT("OCCA PA Mass Apply unknown kernel!");
-   }
-#endif // MFEM_USE_OCCA
    if (dim == 2)
    {
       switch ((D1D << 4 ) | Q1D)
@@ -1233,24 +1264,112 @@ static void PAMassApply(const int dim,
    MFEM_ABORT("Unknown kernel.");
 }
 
+static void PAMassApply(const int dim,
+                        const int D1D,
+                        const int Q1D,
+                        const int NE,
+                        const double* B,
+                        const double* Bt,
+                        const double* op,
+                        const double* x,
+                        double* y)
+{
+#ifdef MFEM_USE_OCCA
+   if (internal::DeviceUseOcca())
+   {
+      if (dim == 2)
+      {
+         OccaPAMassApply2D(D1D, Q1D, NE, B, Bt, op, x, y);
+         return;
+      }
+      if (dim == 3)
+      {
+         OccaPAMassApply3D(D1D, Q1D, NE, B, Bt, op, x, y);
+         return;
+      }
+      MFEM_ABORT("OCCA PA Mass Apply unknown kernel!");
+   }
+#endif // MFEM_USE_OCCA
+   PAMassApplyTensor(dim, D1D, Q1D, NE, B, Bt, op, x, y);
+}
+
 void MassIntegrator::MultAssembled(Vector &x, Vector &y)
 {
    PAMassApply(dim, dofs1D, quad1D, ne, maps->B, maps->Bt, vec, x, y);
 }
 
+void MassIntegrator::AssembleSinglePrecision(const FiniteElementSpace &fes)
+{
+   Assemble(fes);
+   maps->MakeSinglePrecision();
+   vec_sp.SetSize(vec.Size());
+   ConvertPrecision(vec.Size(), vec.GetData(), vec_sp.GetData());
+   vec.Destroy();
+}
+
+void MassIntegrator::MultAssembledSinglePrecision(Array<float> &x,
+                                                  Array<float> &y)
+{
+   PAMassApplyTensor(dim, dofs1D, quad1D, ne,
+                     maps->B_sp.GetData(), maps->Bt_sp.GetData(),
+                     vec_sp.GetData(), x.GetData(), y.GetData());
+}
+
+bool MassIntegrator::SupportsPartialAssembly() const
+{
+   return (dynamic_cast<ConstantCoefficient*>(Q) ||
+           dynamic_cast<FunctionCoefficient*>(Q));
+}
+
 MassIntegrator::~MassIntegrator()
 {
    delete geom;
-   delete maps;
 }
 
 // DofToQuad
+// The maps are shared by all integrators with the same hash, so they are owned
+// by this cache and deleted at program exit.
 static std::map<std::string, DofToQuad* > AllDofQuadMaps;
 
-DofToQuad::~DofToQuad()
+static struct DofToQuadCleanup
+{
+   ~DofToQuadCleanup()
+   {
+      std::map<std::string, DofToQuad* >::iterator it;
+      for (it = AllDofQuadMaps.begin(); it != AllDofQuadMaps.end(); ++it)
+      {
+         delete it->second;
+      }
+   }
+} AllDofQuadMapsCleanup;
+
+DofToQuad::~DofToQuad() { }
+
+void DofToQuad::MakeSinglePrecision()
+{
+   if (B_sp.Size() == B.Size() && Bt_sp.Size() == Bt.Size()) { return; }
+   B_sp.SetSize(B.Size());
+   G_sp.SetSize(G.Size());
+   Bt_sp.SetSize(Bt.Size());
+   Gt_sp.SetSize(Gt.Size());
+   ConvertPrecision(B.Size(), B.GetData(), B_sp.GetData());
+   ConvertPrecision(G.Size(), G.GetData(), G_sp.GetData());
+   ConvertPrecision(Bt.Size(), Bt.GetData(), Bt_sp.GetData());
+   ConvertPrecision(Gt.Size(), Gt.GetData(), Gt_sp.GetData());
+}
+
+void ConvertPrecision(const int N, const double *src, float *dst)
 {
-   MFEM_ASSERT(AllDofQuadMaps.at(hash),"");
-   AllDofQuadMaps.erase(hash);
+   const DeviceVector d_src(src, N);
+   DeviceTensor<1,float> d_dst(dst, N);
+   MFEM_FORALL(i, N, d_dst[i] = static_cast<float>(d_src[i]););
+}
+
+void ConvertPrecision(const int N, const float *src, double *dst)
+{
+   const DeviceTensor<1,float> d_src(src, N);
+   DeviceVector d_dst(dst, N);
+   MFEM_FORALL(i, N, d_dst[i] = static_cast<double>(d_src[i]););
 }
 
 DofToQuad* DofToQuad::Get(const FiniteElementSpace& fes,
@@ -1309,8 +1428,6 @@ DofToQuad* DofToQuad::GetTensorMaps(const FiniteElement& trialFE,
    maps->Bt = testMaps->B;
    maps->Gt = testMaps->G;
    maps->W = testMaps->W;
-   delete trialMaps;
-   delete testMaps;
    return maps;
 }
 
@@ -1430,8 +1547,6 @@ DofToQuad* DofToQuad::GetSimplexMaps(const FiniteElement& trialFE,
    maps->Bt = testMaps->B;
    maps->Gt = testMaps->G;
    maps->W = testMaps->W;
-   delete trialMaps;
-   delete testMaps;
    return maps;
 }
 
@@ -1504,9 +1619,6 @@ DofToQuad* DofToQuad::GetD2QSimplexMaps(const FiniteElement& fe,
 }
 
 
-static long sequence = -1;
-static GeometryExtension *geom = NULL;
-
 static void GeomFill(const int vdim,
                      const int NE, const int ND, const int NX,
                      const int* elementMap, int* eMap,
@@ -1784,8 +1896,18 @@ GeometryExtension* GeometryExtension::Get(const FiniteElementSpace& fes,
    const int Q1D      = ir1D.GetNPoints();
    const int elements = fespace->GetNE();
    const int ndofs    = fespace->GetNDofs();
-   const DofToQuad* maps = DofToQuad::GetSimplexMaps(*fe, ir);
+   const int numQuad  = ir.GetNPoints();
+   GeometryExtension *geom = new GeometryExtension();
+   const Table& e2dTable = fespace->GetElementToDofTable();
+   geom->eMap.SetSize(numDofs*elements);
+   geom->eMap.Assign(e2dTable.GetJ());
+   geom->nodes.SetSize(dims*numDofs*elements);
    NodeCopyByVDim(elements,numDofs,ndofs,dims,geom->eMap,Sx,geom->nodes);
+   geom->X.SetSize(dims*numQuad*elements);
+   geom->J.SetSize(dims*dims*numQuad*elements);
+   geom->invJ.SetSize(dims*dims*numQuad*elements);
+   geom->detJ.SetSize(numQuad*elements);
+   const DofToQuad* maps = DofToQuad::GetSimplexMaps(*fe, ir);
    PAGeom(dims, D1D, Q1D, elements,
           maps->B, maps->G, geom->nodes,
           geom->X, geom->J, geom->invJ, geom->detJ);
@@ -1796,13 +1918,7 @@ GeometryExtension* GeometryExtension::Get(const FiniteElementSpace& fes,
                                           const IntegrationRule& ir)
 {
    Mesh *mesh = fes.GetMesh();
-   const bool geom_to_allocate = sequence < fes.GetSequence();
-   sequence = fes.GetSequence();
-   if (geom_to_allocate)
-   {
-      if (geom) { delete geom; }
-      geom = new GeometryExtension();
-   }
+   GeometryExtension *geom = new GeometryExtension();
 
    const bool dev_enabled = Device::IsEnabled();
    if (dev_enabled) { Device::Disable(); }
@@ -1834,27 +1950,20 @@ GeometryExtension* GeometryExtension::Get(const FiniteElementSpace& fes,
             eMap,
             nodes->GetData(),
             meshNodes);
-   if (geom_to_allocate)
-   {
-      geom->nodes.SetSize(dims*numDofs*elements);
-      geom->eMap.SetSize(numDofs*elements);
-   }
+   geom->nodes.SetSize(dims*numDofs*elements);
+   geom->eMap.SetSize(numDofs*elements);
    geom->nodes = meshNodes;
    geom->eMap = eMap;
    // Reorder the original gf back
    if (orderedByNODES) { ReorderByNodes(nodes); }
-   if (geom_to_allocate)
-   {
-      geom->X.SetSize(dims*numQuad*elements);
-      geom->J.SetSize(dims*dims*numQuad*elements);
-      geom->invJ.SetSize(dims*dims*numQuad*elements);
-      geom->detJ.SetSize(numQuad*elements);
-   }
+   geom->X.SetSize(dims*numQuad*elements);
+   geom->J.SetSize(dims*dims*numQuad*elements);
+   geom->invJ.SetSize(dims*dims*numQuad*elements);
+   geom->detJ.SetSize(numQuad*elements);
    const DofToQuad* maps = DofToQuad::GetSimplexMaps(*fe, ir);
    PAGeom(dims, D1D, Q1D, elements,
           maps->B, maps->G, geom->nodes,
           geom->X, geom->J, geom->invJ, geom->detJ);
-   delete maps;
    return geom;
 }
 
@@ -24,8 +24,11 @@ public:
    Array<int> eMap;
    Array<double> nodes;
    Array<double> X, J, invJ, detJ;
+   /// Return a new GeometryExtension of the mesh nodes, owned by the caller.
    static GeometryExtension* Get(const FiniteElementSpace&,
                                  const IntegrationRule&);
+   /** @brief Return a new GeometryExtension of the nodes given by the Vector,
+       ordered byNODES, owned by the caller. */
    static GeometryExtension* Get(const FiniteElementSpace&,
                                  const IntegrationRule&,
                                  const Vector&);
@@ -44,7 +47,11 @@ public:
    void operator=(DofToQuad const&);
 public:
    Array<double> W, B, G, Bt, Gt;
+   /// Single-precision copies of B, G, Bt and Gt, see MakeSinglePrecision().
+   Array<float> B_sp, G_sp, Bt_sp, Gt_sp;
 public:
+   /// Fill the single-precision copies of the basis maps, if not already set.
+   void MakeSinglePrecision();
    static DofToQuad* Get(const FiniteElementSpace&,
                          const IntegrationRule&,
                          const bool = false);
@@ -75,6 +82,12 @@ public:
                                        const bool = false);
 };
 
+/// Convert @a N double-precision values from @a src into @a dst.
+void ConvertPrecision(const int N, const double *src, float *dst);
+
+/// Convert @a N single-precision values from @a src into @a dst.
+void ConvertPrecision(const int N, const float *src, double *dst);
+
 }
 
 #endif
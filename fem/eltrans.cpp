@@ -10,24 +10,183 @@
 // Software Foundation) version 2.1 dated February 1999.
 
 #include "../mesh/mesh_headers.hpp"
+#include "../linalg/tlayout.hpp"
+#include "../linalg/tmatrix.hpp"
 #include "fem.hpp"
 #include <cmath>
 
 namespace mfem
 {
 
+// Kernels for Jacobians of the size SDIM x DIM, see
+// ElementTransformation::JacobianKernels. The square cases use the small
+// matrix operations from tmatrix.hpp; the non-square cases use the same
+// formulas as DenseMatrix::Weight(), CalcAdjugate() and CalcInverse().
+template <int SDIM, int DIM>
+static void JacobianKernel(int dof, const double *P, const double *dshape,
+                           double *J)
+{
+   double s[SDIM*DIM];
+   for (int i = 0; i < SDIM*DIM; i++) { s[i] = 0.0; }
+   for (int k = 0; k < dof; k++)
+   {
+      for (int d = 0; d < DIM; d++)
+      {
+         const double ds = dshape[k+dof*d];
+         for (int i = 0; i < SDIM; i++)
+         {
+            s[i+SDIM*d] += P[i+SDIM*k]*ds;
+         }
+      }
+   }
+   for (int i = 0; i < SDIM*DIM; i++) { J[i] = s[i]; }
+}
+
+template <int SDIM, int DIM>
+struct JacobianOps
+{
+   // N x N
+   typedef StridedLayout2D<DIM,1,DIM,DIM> layout_t;
+
+   static double Weight(const double *J)
+   {
+      return TDet<double>(layout_t(), J);
+   }
+
+   static void Adjugate(const double *J, double *adjJ)
+   {
+      TAdjugate<double>(layout_t(), J, layout_t(), adjJ);
+   }
+
+   static void Inverse(const double *J, double *invJ)
+   {
+      const double t = 1.0/TAdjDet<double>(layout_t(), J, layout_t(), invJ);
+      for (int i = 0; i < DIM*DIM; i++) { invJ[i] *= t; }
+   }
+};
+
+template <int SDIM>
+struct CurveJacobianOps
+{
+   // N x 1, N = 2,3
+   static double Weight(const double *J)
+   {
+      double s = 0.0;
+      for (int i = 0; i < SDIM; i++) { s += J[i]*J[i]; }
+      return std::sqrt(s);
+   }
+
+   static void Adjugate(const double *J, double *adjJ)
+   {
+      for (int i = 0; i < SDIM; i++) { adjJ[i] = J[i]; }
+   }
+
+   static void Inverse(const double *J, double *invJ)
+   {
+      double s = 0.0;
+      for (int i = 0; i < SDIM; i++) { s += J[i]*J[i]; }
+      s = 1.0/s;
+      for (int i = 0; i < SDIM; i++) { invJ[i] = J[i]*s; }
+   }
+};
+
+template <> struct JacobianOps<2,1> : public CurveJacobianOps<2> { };
+template <> struct JacobianOps<3,1> : public CurveJacobianOps<3> { };
+
+template <>
+struct JacobianOps<3,2>
+{
+   // 3 x 2
+   static inline void Metric(const double *J, double &e, double &g,
+                             double &f)
+   {
+      e = J[0]*J[0] + J[1]*J[1] + J[2]*J[2];
+      g = J[3]*J[3] + J[4]*J[4] + J[5]*J[5];
+      f = J[0]*J[3] + J[1]*J[4] + J[2]*J[5];
+   }
+
+   static inline void Adjugate(const double *J, double e, double g, double f,
+                               double *adjJ)
+   {
+      adjJ[0] = J[0]*g - J[3]*f;
+      adjJ[1] = J[3]*e - J[0]*f;
+      adjJ[2] = J[1]*g - J[4]*f;
+      adjJ[3] = J[4]*e - J[1]*f;
+      adjJ[4] = J[2]*g - J[5]*f;
+      adjJ[5] = J[5]*e - J[2]*f;
+   }
+
+   static double Weight(const double *J)
+   {
+      double e, g, f;
+      Metric(J, e, g, f);
+      return std::sqrt(e*g - f*f);
+   }
+
+   static void Adjugate(const double *J, double *adjJ)
+   {
+      double e, g, f;
+      Metric(J, e, g, f);
+      Adjugate(J, e, g, f, adjJ);
+   }
+
+   static void Inverse(const double *J, double *invJ)
+   {
+      double e, g, f;
+      Metric(J, e, g, f);
+      const double t = 1.0/(e*g - f*f);
+      Adjugate(J, e*t, g*t, f*t, invJ);
+   }
+};
+
+#define MFEM_JACOBIAN_KERNELS(SDIM, DIM) \
+   { SDIM, DIM, JacobianKernel<SDIM,DIM>, JacobianOps<SDIM,DIM>::Weight, \
+     JacobianOps<SDIM,DIM>::Adjugate, JacobianOps<SDIM,DIM>::Inverse }
+
+static const ElementTransformation::JacobianKernels jacobian_kernels[] =
+{
+   MFEM_JACOBIAN_KERNELS(1, 1),
+   MFEM_JACOBIAN_KERNELS(2, 2),
+   MFEM_JACOBIAN_KERNELS(3, 3),
+   MFEM_JACOBIAN_KERNELS(2, 1),
+   MFEM_JACOBIAN_KERNELS(3, 1),
+   MFEM_JACOBIAN_KERNELS(3, 2)
+};
+
+#undef MFEM_JACOBIAN_KERNELS
+
 ElementTransformation::ElementTransformation()
    : IntPoint(static_cast<IntegrationPoint *>(NULL)),
      EvalState(0),
+     jac_kernels(NULL),
      Attribute(-1),
      ElementNo(-1)
 { }
 
+void ElementTransformation::SelectJacobianKernels(int sdim, int dim)
+{
+   jac_kernels = NULL;
+   const int nk = sizeof(jacobian_kernels)/sizeof(jacobian_kernels[0]);
+   for (int i = 0; i < nk; i++)
+   {
+      if (jacobian_kernels[i].sdim == sdim && jacobian_kernels[i].dim == dim)
+      {
+         jac_kernels = &jacobian_kernels[i];
+         break;
+      }
+   }
+}
+
 double ElementTransformation::EvalWeight()
 {
    MFEM_ASSERT((EvalState & WEIGHT_MASK) == 0, "");
    Jacobian();
    EvalState |= WEIGHT_MASK;
+   if (jac_kernels && jac_kernels->sdim == dFdx.Height() &&
+       jac_kernels->dim == dFdx.Width())
+   {
+      return (Wght = jac_kernels->Weight(dFdx.Data()));
+   }
    return (Wght = (dFdx.Width() == 0) ? 1.0 : dFdx.Weight());
 }
 
@@ -36,23 +195,52 @@ const DenseMatrix &ElementTransformation::EvalAdjugateJ()
    MFEM_ASSERT((EvalState & ADJUGATE_MASK) == 0, "");
    Jacobian();
    adjJ.SetSize(dFdx.Width(), dFdx.Height());
-   if (dFdx.Width() > 0) { CalcAdjugate(dFdx, adjJ); }
+   if (jac_kernels && jac_kernels->sdim == dFdx.Height() &&
+       jac_kernels->dim == dFdx.Width())
+   {
+      jac_kernels->Adjugate(dFdx.Data(), adjJ.Data());
+   }
+   else if (dFdx.Width() > 0) { CalcAdjugate(dFdx, adjJ); }
    EvalState |= ADJUGATE_MASK;
    return adjJ;
 }
 
 const DenseMatrix &ElementTransformation::EvalInverseJ()
 {
-   // TODO: compute as invJ = / adjJ/Weight,    if J is square,
-   //                         \ adjJ/Weight^2,  otherwise.
    MFEM_ASSERT((EvalState & INVERSE_MASK) == 0, "");
    Jacobian();
    invJ.SetSize(dFdx.Width(), dFdx.Height());
-   if (dFdx.Width() > 0) { CalcInverse(dFdx, invJ); }
+   if (jac_kernels && jac_kernels->sdim == dFdx.Height() &&
+       jac_kernels->dim == dFdx.Width())
+   {
+      jac_kernels->Inverse(dFdx.Data(), invJ.Data());
+   }
+   else if (dFdx.Width() > 0) { CalcInverse(dFdx, invJ); }
    EvalState |= INVERSE_MASK;
    return invJ;
 }
 
+void ElementTransformation::CalcJacobians(const IntegrationRule &ir,
+                                          DenseTensor &J, Vector *weights,
+                                          DenseTensor *adjugates)
+{
+   const IntegrationPoint *ip0 = IntPoint;
+   const int nq = ir.GetNPoints();
+   const int sdim = GetSpaceDim(), dim = GetDimension();
+   J.SetSize(sdim, dim, nq);
+   if (weights) { weights->SetSize(nq); }
+   if (adjugates) { adjugates->SetSize(dim, sdim, nq); }
+   for (int q = 0; q < nq; q++)
+   {
+      SetIntPoint(&ir.IntPoint(q));
+      J(q) = Jacobian();
+      if (weights) { (*weights)(q) = Weight(); }
+      if (adjugates) { (*adjugates)(q) = AdjugateJacobian(); }
+   }
+   if (ip0) { SetIntPoint(ip0); }
+   else { IntPoint = NULL; EvalState = 0; }
+}
+
 
 int InverseElementTransformation::FindClosestPhysPoint(
    const Vector& pt, const IntegrationRule &ir)
@@ -392,13 +580,14 @@ void IsoparametricTransformation::SetIdentityTransformation(
    }
    geom = GeomType;
    space_dim = dim;
+   SelectJacobianKernels(dim, dim);
 }
 
 const DenseMatrix &IsoparametricTransformation::EvalJacobian()
 {
    MFEM_ASSERT(space_dim == PointMat.Height(),
                "the IsoparametricTransformation has not been finalized;"
-               " call FinilizeTransformation() after setup");
+               " call FinalizeTransformation() after setup");
    MFEM_ASSERT((EvalState & JACOBIAN_MASK) == 0, "");
 
    dshape.SetSize(FElem->GetDof(), FElem->GetDim());
@@ -406,13 +595,52 @@ const DenseMatrix &IsoparametricTransformation::EvalJacobian()
    if (dshape.Width() > 0)
    {
       FElem->CalcDShape(*IntPoint, dshape);
-      Mult(PointMat, dshape, dFdx);
+      if (jac_kernels && jac_kernels->sdim == dFdx.Height() &&
+          jac_kernels->dim == dFdx.Width())
+      {
+         jac_kernels->Jacobian(dshape.Height(), PointMat.Data(),
+                               dshape.Data(), dFdx.Data());
+      }
+      else
+      {
+         Mult(PointMat, dshape, dFdx);
+      }
    }
    EvalState |= JACOBIAN_MASK;
 
    return dFdx;
 }
 
+void IsoparametricTransformation::CalcJacobians(const IntegrationRule &ir,
+                                                DenseTensor &J,
+                                                Vector *weights,
+                                                DenseTensor *adjugates)
+{
+   const int sdim = PointMat.Height(), dim = FElem->GetDim();
+   if (!jac_kernels || jac_kernels->sdim != sdim || jac_kernels->dim != dim)
+   {
+      ElementTransformation::CalcJacobians(ir, J, weights, adjugates);
+      return;
+   }
+   MFEM_ASSERT(space_dim == sdim,
+               "the IsoparametricTransformation has not been finalized;"
+               " call FinalizeTransformation() after setup");
+
+   const int nq = ir.GetNPoints(), dof = FElem->GetDof();
+   J.SetSize(sdim, dim, nq);
+   if (weights) { weights->SetSize(nq); }
+   if (adjugates) { adjugates->SetSize(dim, sdim, nq); }
+   dshape.SetSize(dof, dim);
+   for (int q = 0; q < nq; q++)
+   {
+      FElem->CalcDShape(ir.IntPoint(q), dshape);
+      double *Jq = J.GetData(q);
+      jac_kernels->Jacobian(dof, PointMat.Data(), dshape.Data(), Jq);
+      if (weights) { (*weights)(q) = jac_kernels->Weight(Jq); }
+      if (adjugates) { jac_kernels->Adjugate(Jq, adjugates->GetData(q)); }
+   }
+}
+
 int IsoparametricTransformation::OrderJ()
 {
    switch (FElem->Space())
@@ -22,6 +22,20 @@ namespace mfem
 
 class ElementTransformation
 {
+public:
+   /** @brief Kernels for Jacobians of a fixed size, space_dim x dim, with the
+       dimensions being compile-time constants. */
+   struct JacobianKernels
+   {
+      int sdim, dim;
+      /// Compute J = P dshape, where P is sdim x dof and dshape is dof x dim.
+      void (*Jacobian)(int dof, const double *P, const double *dshape,
+                       double *J);
+      double (*Weight)(const double *J);
+      void (*Adjugate)(const double *J, double *adjJ);
+      void (*Inverse)(const double *J, double *invJ);
+   };
+
 protected:
    const IntegrationPoint *IntPoint;
    DenseMatrix dFdx, adjJ, invJ;
@@ -37,6 +51,15 @@ protected:
    Geometry::Type geom;
    int space_dim;
 
+   /// The kernels for the Jacobians of the transformation, or NULL.
+   const JacobianKernels *jac_kernels;
+
+   /** @brief Select the Jacobian kernels for the given dimensions, which are
+       used by Weight(), AdjugateJacobian() and InverseJacobian(). */
+   /** Supported are the sizes 1x1, 2x2, 3x3, 2x1, 3x1 and 3x2; otherwise the
+       generic DenseMatrix functions are used. */
+   void SelectJacobianKernels(int sdim, int dim);
+
    // Evaluate the Jacobian of the transformation at the IntPoint and store it
    // in dFdx.
    virtual const DenseMatrix &EvalJacobian() = 0;
@@ -76,6 +99,15 @@ public:
    const DenseMatrix &InverseJacobian()
    { return (EvalState & INVERSE_MASK) ? invJ : EvalInverseJ(); }
 
+   /** @brief Evaluate the Jacobians J(k) at all points k of the integration
+       rule @a ir with one call, and optionally their weights and adjugates. */
+   /** The tensors are resized to space-dim x reference-dim x (number of
+       points), and the vector to the number of points. The currently set
+       IntegrationPoint is not changed. */
+   virtual void CalcJacobians(const IntegrationRule &ir, DenseTensor &J,
+                              Vector *weights = NULL,
+                              DenseTensor *adjugates = NULL);
+
    virtual int Order() = 0;
    virtual int OrderJ() = 0;
    virtual int OrderW() = 0;
@@ -311,7 +343,14 @@ public:
        basis functions evaluated at xh. The columns of P represent the control
        points in physical space defining the transformation. */
    DenseMatrix &GetPointMat() { return PointMat; }
-   void FinalizeTransformation() { space_dim = PointMat.Height(); }
+
+   /** @brief Complete the setup after the FiniteElement and the point matrix
+       have been set. This also selects the Jacobian kernels. */
+   void FinalizeTransformation()
+   {
+      space_dim = PointMat.Height();
+      SelectJacobianKernels(space_dim, FElem->GetDim());
+   }
 
    void SetIdentityTransformation(Geometry::Type GeomType);
 
@@ -319,6 +358,10 @@ public:
    virtual void Transform(const IntegrationRule &, DenseMatrix &);
    virtual void Transform(const DenseMatrix &matrix, DenseMatrix &result);
 
+   virtual void CalcJacobians(const IntegrationRule &ir, DenseTensor &J,
+                              Vector *weights = NULL,
+                              DenseTensor *adjugates = NULL);
+
    virtual int Order() { return FElem->GetOrder(); }
    virtual int OrderJ();
    virtual int OrderW();
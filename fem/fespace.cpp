@@ -259,6 +259,92 @@ void FiniteElementSpace::ReorderElementToDofTable()
    }
 }
 
+void FiniteElementSpace::PermuteDofs(Array<int> &dofs) const
+{
+   if (dof_perm.Size() == 0) { return; }
+   for (int i = 0; i < dofs.Size(); i++)
+   {
+      const int sdof = dofs[i];
+      dofs[i] = (sdof >= 0) ? dof_perm[sdof] : (-1-dof_perm[-1-sdof]);
+   }
+}
+
+void FiniteElementSpace::ReorderDofs(const Array<int> &dof_ordering)
+{
+   MFEM_VERIFY(!NURBSext, "NURBS spaces are not supported");
+   MFEM_VERIFY(dof_ordering.Size() == ndofs, "invalid DOF ordering size");
+
+   if (dof_perm.Size() == 0)
+   {
+      dof_ordering.Copy(dof_perm);
+   }
+   else
+   {
+      for (int i = 0; i < ndofs; i++)
+      {
+         dof_perm[i] = dof_ordering[dof_perm[i]];
+      }
+   }
+
+   // Rebuild the data that depends on the DOF numbering.
+   delete elem_dof;
+   elem_dof = NULL;
+   dof_elem_array.DeleteAll();
+   dof_ldof_array.DeleteAll();
+   delete cP;
+   delete cR;
+   cP = cR = NULL;
+   cP_is_set = false;
+   BuildElementToDofTable();
+}
+
+void FiniteElementSpace::ReorderDofsRCM()
+{
+   // The graph of DOFs sharing an element, ignoring the DOF signs.
+   Table el_dof(*elem_dof), dof_el, dof_dof;
+   int *J = el_dof.GetJ();
+   for (int k = 0; k < el_dof.Size_of_connections(); k++)
+   {
+      if (J[k] < 0) { J[k] = -1-J[k]; }
+   }
+   Transpose(el_dof, dof_el, ndofs);
+   mfem::Mult(dof_el, el_dof, dof_dof);
+
+   Array<int> dof_ordering;
+   GetRCMOrdering(dof_dof, dof_ordering);
+   ReorderDofs(dof_ordering);
+}
+
+void FiniteElementSpace::MapToNaturalDofs(const Vector &x,
+                                          Vector &x_orig) const
+{
+   MFEM_VERIFY(x.Size() == GetVSize(), "invalid vector size");
+   x_orig.SetSize(x.Size());
+   if (dof_perm.Size() == 0) { x_orig = x; return; }
+   for (int vd = 0; vd < vdim; vd++)
+   {
+      for (int i = 0; i < ndofs; i++)
+      {
+         x_orig(DofToVDof(i, vd)) = x(DofToVDof(dof_perm[i], vd));
+      }
+   }
+}
+
+void FiniteElementSpace::MapFromNaturalDofs(const Vector &x_orig,
+                                            Vector &x) const
+{
+   MFEM_VERIFY(x_orig.Size() == GetVSize(), "invalid vector size");
+   x.SetSize(x_orig.Size());
+   if (dof_perm.Size() == 0) { x = x_orig; return; }
+   for (int vd = 0; vd < vdim; vd++)
+   {
+      for (int i = 0; i < ndofs; i++)
+      {
+         x(DofToVDof(dof_perm[i], vd)) = x_orig(DofToVDof(i, vd));
+      }
+   }
+}
+
 void FiniteElementSpace::BuildDofToArrays()
 {
    if (dof_elem_array.Size()) { return; }
@@ -1317,6 +1403,7 @@ void FiniteElementSpace::Construct()
 
    elem_dof = NULL;
    bdrElem_dof = NULL;
+   dof_perm.DeleteAll();
 
    nvdofs = mesh->GetNV() * fec->DofForGeometry(Geometry::POINT);
 
@@ -1480,6 +1567,7 @@ void FiniteElementSpace::GetElementDofs (int i, Array<int> &dofs) const
             dofs[ne+j] = k + j;
          }
       }
+      PermuteDofs(dofs);
    }
 }
 
@@ -1576,6 +1664,7 @@ void FiniteElementSpace::GetBdrElementDofs(int i, Array<int> &dofs) const
             }
          }
       }
+      PermuteDofs(dofs);
    }
 }
 
@@ -1636,6 +1725,7 @@ void FiniteElementSpace::GetFaceDofs(int i, Array<int> &dofs) const
          dofs[ne+k] = j;
       }
    }
+   PermuteDofs(dofs);
 }
 
 void FiniteElementSpace::GetEdgeDofs(int i, Array<int> &dofs) const
@@ -1665,6 +1755,7 @@ void FiniteElementSpace::GetEdgeDofs(int i, Array<int> &dofs) const
    {
       dofs[nv+j] = k;
    }
+   PermuteDofs(dofs);
 }
 
 void FiniteElementSpace::GetVertexDofs(int i, Array<int> &dofs) const
@@ -1677,6 +1768,7 @@ void FiniteElementSpace::GetVertexDofs(int i, Array<int> &dofs) const
    {
       dofs[j] = i*nv+j;
    }
+   PermuteDofs(dofs);
 }
 
 void FiniteElementSpace::GetElementInteriorDofs (int i, Array<int> &dofs) const
@@ -1690,6 +1782,7 @@ void FiniteElementSpace::GetElementInteriorDofs (int i, Array<int> &dofs) const
    {
       dofs[j] = k + j;
    }
+   PermuteDofs(dofs);
 }
 
 void FiniteElementSpace::GetEdgeInteriorDofs (int i, Array<int> &dofs) const
@@ -1702,6 +1795,7 @@ void FiniteElementSpace::GetEdgeInteriorDofs (int i, Array<int> &dofs) const
    {
       dofs[j] = k;
    }
+   PermuteDofs(dofs);
 }
 
 void FiniteElementSpace::GetFaceInteriorDofs (int i, Array<int> &dofs) const
@@ -1717,6 +1811,7 @@ void FiniteElementSpace::GetFaceInteriorDofs (int i, Array<int> &dofs) const
          dofs[j] = k;
       }
    }
+   PermuteDofs(dofs);
 }
 
 const FiniteElement *FiniteElementSpace::GetBE (int i) const
@@ -96,6 +96,10 @@ protected:
 
    Array<int> dof_elem_array, dof_ldof_array;
 
+   /** Map from the natural DOF numbering (defined by the mesh entities) to the
+       current DOF numbering; empty if the DOFs have not been reordered. */
+   Array<int> dof_perm;
+
    NURBSExtension *NURBSext;
    int own_ext;
 
@@ -123,6 +127,9 @@ protected:
    static inline int DecodeDof(int dof, double& sign)
    { return (dof >= 0) ? (sign = 1, dof) : (sign = -1, (-1 - dof)); }
 
+   /// Apply #dof_perm (if set) to the signed DOFs in @a dofs.
+   void PermuteDofs(Array<int> &dofs) const;
+
    /// Helper to get vertex, edge or face DOFs (entity=0,1,2 resp.).
    void GetEntityDofs(int entity, int index, Array<int> &dofs) const;
 
@@ -409,6 +416,38 @@ public:
        is preserved. */
    void ReorderElementToDofTable();
 
+   /** @brief Renumber the scalar DOFs of the space, where @a dof_ordering
+       maps the current DOF number to the new DOF number. */
+   /** All DOF queries (element, boundary element, face, edge, vertex, ...)
+       and the element-to-DOF table use the new numbering, and so do the
+       GridFunction%s, forms and matrices created afterwards. Existing
+       GridFunction%s are not updated. The reordering is reset by Update()
+       after a mesh modification. Not supported for NURBS spaces. Serial only:
+       a ParFiniteElementSpace does not support it, and neither does
+       ReorderDofsRCM(). */
+   virtual void ReorderDofs(const Array<int> &dof_ordering);
+
+   /** @brief Renumber the scalar DOFs using the Reverse Cuthill-McKee
+       ordering of the graph of DOFs sharing an element. */
+   /** This reduces the bandwidth of the assembled matrices and improves the
+       locality of the DOF accesses in assembly and in matrix-vector products.
+       See ReorderDofs(). */
+   void ReorderDofsRCM();
+
+   /** @brief Returns the map from the natural DOF numbering (used without any
+       reordering) to the current DOF numbering. Empty if the DOFs have not
+       been reordered. */
+   const Array<int> &GetDofPermutation() const { return dof_perm; }
+
+   /** @brief Copy the vector @a x, given in the current (possibly reordered)
+       numbering of the vector DOFs, to @a x_orig in the natural numbering,
+       e.g. for output. */
+   void MapToNaturalDofs(const Vector &x, Vector &x_orig) const;
+
+   /** @brief Copy the vector @a x_orig, given in the natural numbering of the
+       vector DOFs, to @a x in the current (possibly reordered) numbering. */
+   void MapFromNaturalDofs(const Vector &x_orig, Vector &x) const;
+
    void BuildDofToArrays();
 
    const Table &GetElementToDofTable() const { return *elem_dof; }
@@ -2626,13 +2626,21 @@ void GridFunction::Save(std::ostream &out) const
       return;
    }
 #endif
+   // Write the data in the natural DOF numbering, expected when loading.
+   Vector natural;
+   const Vector *data = this;
+   if (fes->GetDofPermutation().Size() > 0)
+   {
+      fes->MapToNaturalDofs(*this, natural);
+      data = &natural;
+   }
    if (fes->GetOrdering() == Ordering::byNODES)
    {
-      Vector::Print(out, 1);
+      data->Print(out, 1);
    }
    else
    {
-      Vector::Print(out, fes->GetVDim());
+      data->Print(out, fes->GetVDim());
    }
    out.flush();
 }
@@ -467,6 +467,9 @@ public:
    void MakeTRef(FiniteElementSpace *f, Vector &tv, int tv_offset);
 
    /// Save the GridFunction to an output stream.
+   /** If the DOFs of the space were reordered, see
+       FiniteElementSpace::ReorderDofs(), the data is written in the natural
+       DOF numbering, so that the file can be loaded as usual. */
    virtual void Save(std::ostream &out) const;
 
    /** Write the GridFunction in VTK format. Note that Mesh::PrintVTK must be
@@ -364,10 +364,7 @@ Operator &NonlinearForm::GetGradient(const Vector &x) const
          cGrad = RAP(*cP, *Grad, *cP);
          mGrad = cGrad;
       }
-      for (int i = 0; i < ess_tdof_list.Size(); i++)
-      {
-         mGrad->EliminateRowCol(ess_tdof_list[i]);
-      }
+      mGrad->EliminateRowsCols(ess_tdof_list);
    }
 
    return *mGrad;
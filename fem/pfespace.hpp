@@ -172,6 +172,12 @@ private:
    HypreParMatrix* ParallelDerefinementMatrix(int old_ndofs,
                                               const Table *old_elem_dof);
 
+   /** DOF reordering is serial-only: the parallel DOF data is built with the
+       natural ordering. Private so that it cannot be called directly; calls
+       through a FiniteElementSpace abort. */
+   virtual void ReorderDofs(const Array<int> &)
+   { MFEM_ABORT("DOF reordering is not supported in parallel"); }
+
 public:
    // Face-neighbor data
    // Number of face-neighbor dofs
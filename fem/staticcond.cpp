@@ -290,14 +290,20 @@ void StaticCondensation::EliminateReducedTrueDofs(
 {
    if (!Parallel() || S) // not parallel or not finalized
    {
+      // Eliminate all dofs in one pass, the eliminated part is in CSR format
+      SparseMatrix *Ae = new SparseMatrix;
+      S->EliminateRowsCols(ess_rtdof_list, *Ae, dpolicy);
       if (S_e == NULL)
       {
-         S_e = new SparseMatrix(S->Height());
-      }
-      for (int i = 0; i < ess_rtdof_list.Size(); i++)
-      {
-         S->EliminateRowCol(ess_rtdof_list[i], *S_e, dpolicy);
+         S_e = Ae;
+         return;
       }
+      const int skip_zeros = 0;
+      S_e->Finalize(skip_zeros);
+      SparseMatrix *sum = mfem::Add(*S_e, *Ae);
+      delete Ae;
+      delete S_e;
+      S_e = sum;
    }
    else // parallel and finalized
    {
@@ -214,6 +214,7 @@ void Array2D<T>::Print(std::ostream &out, int width_)
 }
 
 template class Array<int>;
+template class Array<float>;
 template class Array<double>;
 template class Array2D<int>;
 template class Array2D<double>;
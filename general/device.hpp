@@ -182,6 +182,16 @@ public:
    static inline bool Allows(unsigned long b_mask)
    { return Get().allowed_backends & b_mask; }
 
+   /** @brief Return true if MFEM_FORALL dispatches to the host OpenMP backend,
+       i.e. if Backend::OMP is allowed but no device or RAJA OpenMP backend. */
+   /** Host code with its own OpenMP parallel regions uses this method to follow
+       the backend selection of MFEM_FORALL. */
+   static inline bool AllowsHostOpenMP()
+   {
+      return Allows(Backend::OMP) &&
+             !Allows(Backend::DEVICE_MASK | Backend::RAJA_OMP);
+   }
+
    ~Device();
 };
 
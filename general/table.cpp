@@ -14,6 +14,7 @@
 #include "array.hpp"
 #include "table.hpp"
 #include "error.hpp"
+#include "sort_pairs.hpp"
 
 #include "../general/forall.hpp"
 #include <iostream>
@@ -555,6 +556,109 @@ Table * Mult (const Table &A, const Table &B)
    return C;
 }
 
+// Breadth-first search from 'root' over the unnumbered vertices (marker < 0).
+// Returns the number of levels; 'bfs' receives the vertices in the search
+// order and 'last' the index in 'bfs' where the last level starts. The
+// markers of the visited vertices are reset to -1 before returning.
+static int RCMLevelStructure(const Table &graph, int root, Array<int> &marker,
+                             Array<int> &bfs, int &last)
+{
+   const int *I = graph.GetI(), *J = graph.GetJ();
+   bfs.SetSize(0);
+   bfs.Append(root);
+   marker[root] = 0;
+   int num_levels = 0, begin = 0;
+   while (begin < bfs.Size())
+   {
+      const int end = bfs.Size();
+      last = begin;
+      num_levels++;
+      for (int p = begin; p < end; p++)
+      {
+         const int v = bfs[p];
+         for (int k = I[v]; k < I[v+1]; k++)
+         {
+            if (marker[J[k]] == -1)
+            {
+               marker[J[k]] = num_levels;
+               bfs.Append(J[k]);
+            }
+         }
+      }
+      begin = end;
+   }
+   for (int p = 0; p < bfs.Size(); p++) { marker[bfs[p]] = -1; }
+   return num_levels;
+}
+
+void GetRCMOrdering(const Table &graph, Array<int> &ordering)
+{
+   const int n = graph.Size();
+   const int *I = graph.GetI(), *J = graph.GetJ();
+
+   // marker[v] = -1 for unnumbered vertices, -2 for numbered ones.
+   Array<int> marker(n), bfs, cm;
+   marker = -1;
+   cm.Reserve(n);
+   Array<Pair<int,int> > nbrs;
+
+   for (int seed = 0; seed < n; seed++)
+   {
+      if (marker[seed] != -1) { continue; }
+
+      // Find a pseudo-peripheral vertex of the connected component of 'seed'
+      // (George-Liu): repeatedly restart from a vertex of minimal degree in
+      // the last level, while the number of levels increases.
+      int root = seed, last;
+      int num_levels = RCMLevelStructure(graph, root, marker, bfs, last);
+      for (int p = 0; p < bfs.Size(); p++)
+      {
+         const int v = bfs[p];
+         if (graph.RowSize(v) < graph.RowSize(root)) { root = v; }
+      }
+      while (true)
+      {
+         num_levels = RCMLevelStructure(graph, root, marker, bfs, last);
+         int cand = bfs[last];
+         for (int p = last + 1; p < bfs.Size(); p++)
+         {
+            if (graph.RowSize(bfs[p]) < graph.RowSize(cand)) { cand = bfs[p]; }
+         }
+         int cand_last;
+         const int cand_levels =
+            RCMLevelStructure(graph, cand, marker, bfs, cand_last);
+         if (cand_levels <= num_levels) { break; }
+         root = cand;
+      }
+
+      // Cuthill-McKee: breadth-first numbering from 'root', visiting the
+      // neighbors of every vertex in the order of increasing degree.
+      int begin = cm.Size();
+      cm.Append(root);
+      marker[root] = -2;
+      while (begin < cm.Size())
+      {
+         const int v = cm[begin++];
+         nbrs.SetSize(0);
+         for (int k = I[v]; k < I[v+1]; k++)
+         {
+            const int u = J[k];
+            if (marker[u] == -1)
+            {
+               marker[u] = -2;
+               nbrs.Append(Pair<int,int>(graph.RowSize(u), u));
+            }
+         }
+         SortPairs<int,int>(nbrs, nbrs.Size());
+         for (int p = 0; p < nbrs.Size(); p++) { cm.Append(nbrs[p].two); }
+      }
+   }
+
+   // Reverse the Cuthill-McKee ordering.
+   ordering.SetSize(n);
+   for (int k = 0; k < n; k++) { ordering[cm[k]] = n - 1 - k; }
+}
+
 STable::STable (int dim, int connections_per_row) :
    Table(dim, connections_per_row)
 {}
@@ -182,6 +182,13 @@ void Mult (const Table &A, const Table &B, Table &C);
 Table * Mult (const Table &A, const Table &B);
 
 
+/** @brief Compute a bandwidth-reducing Reverse Cuthill-McKee ordering of the
+    vertices of the symmetric graph @a graph (e.g. a dof-to-dof Table). */
+/** On output, @a ordering maps the old vertex number to the new vertex
+    number. Every connected component is numbered separately, starting from a
+    pseudo-peripheral vertex. */
+void GetRCMOrdering(const Table &graph, Array<int> &ordering);
+
 /** Data type STable. STable is similar to Table, but it's for symmetric
     connectivity, i.e. TYPE I is equivalent to TYPE II. In the first
     dimension we put the elements with smaller index. */
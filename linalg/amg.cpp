@@ -0,0 +1,491 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of serial smoothed aggregation AMG
+
+#include "amg.hpp"
+#include "sparsesmoothers.hpp"
+
+#include <cmath>
+#include <iomanip>
+
+namespace mfem
+{
+
+using namespace std;
+
+// Index of component c of node i for nn nodes with bs components.
+static inline int NodeDof(int i, int c, int nn, int bs, bool bynodes)
+{
+   return bynodes ? (c*nn + i) : (i*bs + c);
+}
+
+SmoothedAggregationAMG::SmoothedAggregationAMG()
+   : block_size(1), order_bynodes(false), fespace(NULL),
+     theta(0.08), max_levels(10), coarse_size(200),
+     smoother_type(GAUSS_SEIDEL), smoother_sweeps(1), print_level(0),
+     coarse_chol(NULL)
+{ }
+
+SmoothedAggregationAMG::SmoothedAggregationAMG(const SparseMatrix &a)
+   : block_size(1), order_bynodes(false), fespace(NULL),
+     theta(0.08), max_levels(10), coarse_size(200),
+     smoother_type(GAUSS_SEIDEL), smoother_sweeps(1), print_level(0),
+     coarse_chol(NULL)
+{
+   SetOperator(a);
+}
+
+void SmoothedAggregationAMG::Clear()
+{
+   for (int l = 1; l < A.Size(); l++) { delete A[l]; }
+   for (int l = 0; l < P.Size(); l++) { delete P[l]; }
+   for (int l = 0; l < pre.Size(); l++) { delete pre[l]; delete post[l]; }
+   for (int l = 0; l < res.Size(); l++)
+   {
+      delete res[l];
+      delete rhs[l];
+      delete sol[l];
+   }
+   delete coarse_chol;
+   coarse_chol = NULL;
+   coarse_mat.Clear();
+   A.SetSize(0);
+   P.SetSize(0);
+   pre.SetSize(0);
+   post.SetSize(0);
+   res.SetSize(0);
+   rhs.SetSize(0);
+   sol.SetSize(0);
+}
+
+void SmoothedAggregationAMG::SetNearNullspace(const DenseMatrix &ns)
+{
+   nullspace = ns;
+}
+
+void SmoothedAggregationAMG::SetOperator(const Operator &op)
+{
+   const SparseMatrix *a = dynamic_cast<const SparseMatrix*>(&op);
+   MFEM_VERIFY(a != NULL, "the operator must be a SparseMatrix");
+   MFEM_VERIFY(a->Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(a->Height() == a->Width(), "the SparseMatrix must be square");
+   height = width = a->Height();
+
+   Clear();
+   A.Append(a);
+   Setup();
+}
+
+int SmoothedAggregationAMG::Aggregate(const SparseMatrix &Al, int bs,
+                                      bool bynodes, Array<int> &agg) const
+{
+   const int n = Al.Height(), nn = n / bs;
+   const int *I = Al.GetI(), *J = Al.GetJ();
+   const double *a = Al.GetData();
+
+   // Squared Frobenius norms of the node blocks: diagonal blocks in dnorm and
+   // off-diagonal blocks in the node graph (sI, sJ, sA).
+   Vector dnorm(nn);
+   dnorm = 0.0;
+   Array<int> sI(nn+1), sJ, pos(nn), list;
+   Array<double> sA, acc;
+   pos = -1;
+   sI[0] = 0;
+   for (int i = 0; i < nn; i++)
+   {
+      list.SetSize(0);
+      acc.SetSize(0);
+      for (int c = 0; c < bs; c++)
+      {
+         const int r = NodeDof(i, c, nn, bs, bynodes);
+         for (int k = I[r]; k < I[r+1]; k++)
+         {
+            const int j = bynodes ? (J[k] % nn) : (J[k] / bs);
+            if (pos[j] < 0)
+            {
+               pos[j] = list.Size();
+               list.Append(j);
+               acc.Append(0.0);
+            }
+            acc[pos[j]] += a[k]*a[k];
+         }
+      }
+      for (int t = 0; t < list.Size(); t++)
+      {
+         const int j = list[t];
+         if (j == i) { dnorm(i) = sqrt(acc[t]); }
+         else { sJ.Append(j); sA.Append(sqrt(acc[t])); }
+         pos[j] = -1;
+      }
+      sI[i+1] = sJ.Size();
+   }
+
+   // Strong connections: |A_ij| >= theta sqrt(|A_ii| |A_jj|).
+   Array<bool> strong(sJ.Size());
+   Array<int> num_strong(nn);
+   for (int i = 0; i < nn; i++)
+   {
+      num_strong[i] = 0;
+      for (int k = sI[i]; k < sI[i+1]; k++)
+      {
+         strong[k] = (sA[k] >= theta * sqrt(dnorm(i) * dnorm(sJ[k])) &&
+                      sA[k] > 0.0);
+         if (strong[k]) { num_strong[i]++; }
+      }
+   }
+
+   // Phase 1: nodes whose strong neighborhood is not aggregated yet form new
+   // aggregates with their neighborhoods. Nodes without strong connections
+   // are isolated and not aggregated.
+   agg.SetSize(nn);
+   agg = -1;
+   int na = 0;
+   for (int i = 0; i < nn; i++)
+   {
+      if (num_strong[i] == 0 || agg[i] >= 0) { continue; }
+      bool free = true;
+      for (int k = sI[i]; k < sI[i+1] && free; k++)
+      {
+         if (strong[k] && agg[sJ[k]] >= 0) { free = false; }
+      }
+      if (!free) { continue; }
+      agg[i] = na;
+      for (int k = sI[i]; k < sI[i+1]; k++)
+      {
+         if (strong[k]) { agg[sJ[k]] = na; }
+      }
+      na++;
+   }
+
+   // Phase 2: remaining nodes join the strongest neighboring aggregate from
+   // phase 1.
+   Array<int> agg1(agg);
+   for (int i = 0; i < nn; i++)
+   {
+      if (num_strong[i] == 0 || agg[i] >= 0) { continue; }
+      double smax = 0.0;
+      for (int k = sI[i]; k < sI[i+1]; k++)
+      {
+         if (strong[k] && agg1[sJ[k]] >= 0 && sA[k] > smax)
+         {
+            smax = sA[k];
+            agg[i] = agg1[sJ[k]];
+         }
+      }
+   }
+
+   // Phase 3: the rest form aggregates with their unaggregated neighbors.
+   for (int i = 0; i < nn; i++)
+   {
+      if (num_strong[i] == 0 || agg[i] >= 0) { continue; }
+      agg[i] = na;
+      for (int k = sI[i]; k < sI[i+1]; k++)
+      {
+         if (strong[k] && agg[sJ[k]] < 0 && num_strong[sJ[k]] > 0)
+         {
+            agg[sJ[k]] = na;
+         }
+      }
+      na++;
+   }
+   return na;
+}
+
+// Estimate the largest eigenvalue of D^{-1} A with the power method applied
+// to the symmetric matrix D^{-1/2} A D^{-1/2}.
+static double SpectralRadiusDinvA(const SparseMatrix &A, const Vector &d)
+{
+   const int n = A.Height();
+   Vector s(n), x(n), y(n), z(n);
+   for (int i = 0; i < n; i++)
+   {
+      s(i) = (d(i) > 0.0) ? 1.0/sqrt(d(i)) : 0.0;
+   }
+   x.Randomize(1);
+   double lambda = 0.0;
+   for (int it = 0; it < 20; it++)
+   {
+      x /= x.Norml2();
+      for (int i = 0; i < n; i++) { z(i) = s(i) * x(i); }
+      A.Mult(z, y);
+      for (int i = 0; i < n; i++) { y(i) *= s(i); }
+      lambda = x * y;
+      x = y;
+      if (x.Norml2() == 0.0) { break; }
+   }
+   return lambda;
+}
+
+void SmoothedAggregationAMG::Setup()
+{
+   if (fespace) { ComputeRigidBodyModes(); }
+
+   int bs = block_size;
+   bool bynodes = order_bynodes;
+   MFEM_VERIFY(height % bs == 0, "the size of the matrix is not a multiple of "
+               "the block size");
+
+   // Near-nullspace on the current level.
+   DenseMatrix B;
+   if (nullspace.Width() > 0)
+   {
+      MFEM_VERIFY(nullspace.Height() == height,
+                  "invalid near-nullspace size");
+      B = nullspace;
+   }
+   else
+   {
+      const int nn = height / bs;
+      B.SetSize(height, bs);
+      B = 0.0;
+      for (int i = 0; i < nn; i++)
+      {
+         for (int c = 0; c < bs; c++)
+         {
+            B(NodeDof(i, c, nn, bs, bynodes), c) = 1.0;
+         }
+      }
+   }
+
+   while (A.Size() < max_levels && A.Last()->Height() > coarse_size)
+   {
+      const SparseMatrix &Al = *A.Last();
+      const int n = Al.Height(), nn = n / bs, k = B.Width();
+
+      Array<int> agg;
+      const int na = Aggregate(Al, bs, bynodes, agg);
+      const int nc = na * k;
+      if (na == 0 || nc >= n) { break; }
+
+      // The nodes of every aggregate.
+      Array<int> agg_ptr(na+1), agg_nodes(nn);
+      agg_ptr = 0;
+      for (int i = 0; i < nn; i++) { if (agg[i] >= 0) { agg_ptr[agg[i]+1]++; } }
+      agg_ptr.PartialSum();
+      {
+         Array<int> pos(agg_ptr);
+         for (int i = 0; i < nn; i++)
+         {
+            if (agg[i] >= 0) { agg_nodes[pos[agg[i]]++] = i; }
+         }
+      }
+
+      // Tentative prolongator: on every aggregate, Q R = B (thin QR) gives the
+      // rows Q of the prolongator and the coarse near-nullspace R.
+      int *pI = mfem::New<int>(n+1);
+      pI[0] = 0;
+      for (int r = 0; r < n; r++)
+      {
+         const int node = bynodes ? (r % nn) : (r / bs);
+         pI[r+1] = pI[r] + ((agg[node] >= 0) ? k : 0);
+      }
+      int *pJ = mfem::New<int>(pI[n]);
+      double *pA = mfem::New<double>(pI[n]);
+      DenseMatrix Bc(nc, k), Q, R(k);
+      Array<int> rows;
+      for (int g = 0; g < na; g++)
+      {
+         rows.SetSize(0);
+         for (int p = agg_ptr[g]; p < agg_ptr[g+1]; p++)
+         {
+            for (int c = 0; c < bs; c++)
+            {
+               rows.Append(NodeDof(agg_nodes[p], c, nn, bs, bynodes));
+            }
+         }
+         const int m = rows.Size();
+         Q.SetSize(m, k);
+         for (int j = 0; j < k; j++)
+         {
+            for (int t = 0; t < m; t++) { Q(t, j) = B(rows[t], j); }
+         }
+         // Modified Gram-Schmidt with reorthogonalization; linearly dependent
+         // columns are set to zero.
+         R = 0.0;
+         for (int j = 0; j < k; j++)
+         {
+            Vector qj(Q.GetColumn(j), m);
+            const double norm0 = qj.Norml2();
+            for (int pass = 0; pass < 2; pass++)
+            {
+               for (int i = 0; i < j; i++)
+               {
+                  Vector qi(Q.GetColumn(i), m);
+                  const double rij = qi * qj;
+                  R(i, j) += rij;
+                  qj.Add(-rij, qi);
+               }
+            }
+            const double rjj = qj.Norml2();
+            if (rjj > 1e-10 * norm0)
+            {
+               R(j, j) = rjj;
+               qj /= rjj;
+            }
+            else
+            {
+               qj = 0.0;
+            }
+         }
+         for (int t = 0; t < m; t++)
+         {
+            for (int j = 0; j < k; j++)
+            {
+               pJ[pI[rows[t]] + j] = g*k + j;
+               pA[pI[rows[t]] + j] = Q(t, j);
+            }
+         }
+         for (int i = 0; i < k; i++)
+         {
+            for (int j = 0; j < k; j++) { Bc(g*k + i, j) = R(i, j); }
+         }
+      }
+      SparseMatrix Pt(pI, pJ, pA, n, nc);
+
+      // Smoothed prolongator P = (I - omega D^{-1} A) Pt.
+      Vector d;
+      Al.GetDiag(d);
+      const double omega = 4.0 / (3.0 * SpectralRadiusDinvA(Al, d));
+      SparseMatrix *APt = mfem::Mult(Al, Pt);
+      for (int i = 0; i < n; i++) { d(i) = (d(i) != 0.0) ? omega/d(i) : 0.0; }
+      APt->ScaleRows(d);
+      SparseMatrix *Pl = Add(1.0, Pt, -1.0, *APt);
+      delete APt;
+
+      // Galerkin coarse matrix; the rows of zero columns of the prolongator
+      // get a unit diagonal.
+      SparseMatrix *Ac = RAP(*Pl, Al, *Pl);
+      Vector dc, fix(nc);
+      Ac->GetDiag(dc);
+      bool need_fix = false;
+      for (int i = 0; i < nc; i++)
+      {
+         fix(i) = (dc(i) == 0.0) ? 1.0 : 0.0;
+         need_fix = need_fix || (dc(i) == 0.0);
+      }
+      if (need_fix)
+      {
+         SparseMatrix D(fix);
+         SparseMatrix *Af = Add(*Ac, D);
+         delete Ac;
+         Ac = Af;
+      }
+
+      P.Append(Pl);
+      A.Append(Ac);
+      B = Bc;
+      bs = k;
+      bynodes = false;
+   }
+
+   for (int l = 0; l < A.Size() - 1; l++) { MakeSmoothers(l); }
+   if (A.Last()->Height() <= coarse_size)
+   {
+      A.Last()->ToDenseMatrix(coarse_mat);
+      coarse_inv.Factor(coarse_mat);
+   }
+   else
+   {
+      coarse_chol = new SparseCholeskySolver(*A.Last());
+   }
+
+   for (int l = 0; l < A.Size(); l++)
+   {
+      res.Append(new Vector(A[l]->Height()));
+      rhs.Append(new Vector(A[l]->Height()));
+      sol.Append(new Vector(A[l]->Height()));
+   }
+
+   if (print_level > 0)
+   {
+      mfem::out << "SmoothedAggregationAMG hierarchy:\n"
+                << " level       rows        nnz\n";
+      for (int l = 0; l < A.Size(); l++)
+      {
+         mfem::out << setw(6) << l << setw(11) << A[l]->Height()
+                   << setw(11) << A[l]->NumNonZeroElems() << '\n';
+      }
+      mfem::out << " operator complexity: " << GetOperatorComplexity()
+                << "\n coarse solver: "
+                << (coarse_chol ? "sparse Cholesky" : "dense LU") << endl;
+   }
+}
+
+void SmoothedAggregationAMG::MakeSmoothers(int l)
+{
+   const SparseMatrix &Al = *A[l];
+   const int it = smoother_sweeps;
+   switch (smoother_type)
+   {
+      case JACOBI:
+         pre.Append(new DSmoother(Al, 0, 2.0/3.0, it));
+         post.Append(new DSmoother(Al, 0, 2.0/3.0, it));
+         break;
+      case L1_JACOBI:
+         pre.Append(new DSmoother(Al, 1, 1.0, it));
+         post.Append(new DSmoother(Al, 1, 1.0, it));
+         break;
+      case GAUSS_SEIDEL:
+         pre.Append(new GSSmoother(Al, 1, it));
+         post.Append(new GSSmoother(Al, 2, it));
+         break;
+      case MULTICOLOR_GS:
+         pre.Append(new MulticolorGSSmoother(Al, 1, it));
+         post.Append(new MulticolorGSSmoother(Al, 2, it));
+         break;
+      default:
+         MFEM_ABORT("unknown smoother type: " << smoother_type);
+   }
+   pre.Last()->iterative_mode = true;
+   post.Last()->iterative_mode = true;
+}
+
+void SmoothedAggregationAMG::Cycle(int l, const Vector &b, Vector &x) const
+{
+   if (l == A.Size() - 1)
+   {
+      if (coarse_chol) { coarse_chol->Mult(b, x); }
+      else { coarse_inv.Mult(b, x); }
+      return;
+   }
+
+   pre[l]->Mult(b, x);
+
+   Vector &r = *res[l], &bc = *rhs[l+1], &xc = *sol[l+1];
+   A[l]->Mult(x, r);
+   subtract(b, r, r);
+   P[l]->MultTranspose(r, bc);
+   xc = 0.0;
+   Cycle(l+1, bc, xc);
+   P[l]->AddMult(xc, x);
+
+   post[l]->Mult(b, x);
+}
+
+void SmoothedAggregationAMG::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_ASSERT(A.Size() > 0, "the operator is not set");
+   if (!iterative_mode)
+   {
+      x = 0.0;
+   }
+   Cycle(0, b, x);
+}
+
+double SmoothedAggregationAMG::GetOperatorComplexity() const
+{
+   double nnz = 0.0;
+   for (int l = 0; l < A.Size(); l++) { nnz += A[l]->NumNonZeroElems(); }
+   return nnz / A[0]->NumNonZeroElems();
+}
+
+}
@@ -0,0 +1,167 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_AMG
+#define MFEM_AMG
+
+// Serial algebraic multigrid for sparse matrices
+
+#include "../config/config.hpp"
+#include "sparsemat.hpp"
+#include "densemat.hpp"
+#include "solvers.hpp"
+#include "sparsechol.hpp"
+
+namespace mfem
+{
+
+class FiniteElementSpace;
+
+/** @brief Serial smoothed aggregation algebraic multigrid (AMG) V-cycle for
+    a symmetric positive definite SparseMatrix. */
+/** The setup, called from SetOperator(), builds the hierarchy as follows. On
+    every level, the nodes (groups of block size unknowns, see
+    SetSystemsOptions()) are aggregated based on the strength of their
+    connections. The tentative prolongator interpolates the near-nullspace
+    exactly on every aggregate (using a local QR factorization) and it is
+    smoothed with one damped Jacobi step. The coarse matrix is the Galerkin
+    product P^T A P. The coarsest level is solved with a dense LU
+    factorization if its size is at most the coarse size, see SetCoarseSize().
+    Otherwise, e.g. when the coarsening stalls or the maximal number of levels
+    is reached, it is solved with a SparseCholeskySolver.
+
+    The default near-nullspace consists of the constant vectors for each
+    component. For elasticity, the rigid body modes can be used instead, see
+    SetElasticityOptions() and SetNearNullspace().
+
+    The V-cycle uses the pre-smoother and the transposed post-smoother, so it
+    is a symmetric preconditioner for PCG. */
+class SmoothedAggregationAMG : public Solver
+{
+public:
+   /// Smoother types, applied with the given number of sweeps.
+   enum SmootherType
+   {
+      JACOBI,        ///< Damped (2/3) Jacobi
+      L1_JACOBI,     ///< l1-Jacobi
+      GAUSS_SEIDEL,  ///< Forward pre- and backward post-smoothing
+      MULTICOLOR_GS  ///< Multicolor (threaded) forward/backward Gauss-Seidel
+   };
+
+protected:
+   /// Number of unknowns per node and their ordering on the finest level.
+   int block_size;
+   bool order_bynodes;
+   /// Near-nullspace on the finest level (columns), empty for the default.
+   DenseMatrix nullspace;
+   /// Space for the rigid body modes, see SetElasticityOptions().
+   FiniteElementSpace *fespace;
+
+   double theta;
+   int max_levels, coarse_size;
+   SmootherType smoother_type;
+   int smoother_sweeps;
+   int print_level;
+
+   /// The hierarchy: A[0] is the given matrix (not owned).
+   Array<const SparseMatrix*> A;
+   /// Prolongation from level l+1 to level l, owned.
+   Array<SparseMatrix*> P;
+   /// Pre- and post-smoothers on all levels but the coarsest, owned.
+   Array<Solver*> pre, post;
+   DenseMatrix coarse_mat;
+   DenseMatrixInverse coarse_inv;
+   /// Solver of a coarsest level larger than the coarse size, owned.
+   SparseCholeskySolver *coarse_chol;
+
+   /// Work vectors on every level.
+   mutable Array<Vector*> res, rhs, sol;
+
+   void Clear();
+
+   /// Build the hierarchy for the matrix A[0].
+   void Setup();
+
+   /** @brief Aggregate the nodes of @a Al. Returns the number of aggregates;
+       @a agg[i] is the aggregate of node i, -1 for isolated nodes. */
+   int Aggregate(const SparseMatrix &Al, int bs, bool bynodes,
+                 Array<int> &agg) const;
+
+   /// Create the smoothers for the matrix on level @a l.
+   void MakeSmoothers(int l);
+
+   /// Compute the rigid body modes of #fespace into #nullspace.
+   void ComputeRigidBodyModes();
+
+   void Cycle(int l, const Vector &b, Vector &x) const;
+
+public:
+   SmoothedAggregationAMG();
+
+   SmoothedAggregationAMG(const SparseMatrix &a);
+
+   virtual ~SmoothedAggregationAMG() { Clear(); }
+
+   /** @brief Treat the matrix as a system with @a bs unknowns per node,
+       ordered by nodes (Ordering::byNODES) or by VDIM (Ordering::byVDIM). */
+   /** Aggregation is done on the nodes, with the Frobenius norm of the
+       @a bs x @a bs blocks as the strength of the connection. */
+   void SetSystemsOptions(int bs, bool order_bynodes_ = false)
+   { block_size = bs; order_bynodes = order_bynodes_; }
+
+   /** @brief Set the near-nullspace of the matrix, given by the columns of
+       @a ns (whose height is the size of the matrix). */
+   void SetNearNullspace(const DenseMatrix &ns);
+
+   /** @brief Use the translations and the rigid body rotations on the vector
+       H1 space @a fes as the near-nullspace. */
+   /** The space is saved and the rigid body modes are recomputed in every
+       call to SetOperator(). This also sets the systems options using the
+       vector dimension and the ordering of @a fes. */
+   void SetElasticityOptions(FiniteElementSpace *fes);
+
+   /// Strength threshold for the aggregation, default 0.08.
+   void SetStrengthThreshold(double theta_) { theta = theta_; }
+
+   /// Maximal number of levels, default 10.
+   void SetMaxLevels(int max_levels_) { max_levels = max_levels_; }
+
+   /** @brief Size below which the matrix is coarsened no further and solved
+       with a dense LU factorization, default 200. */
+   void SetCoarseSize(int coarse_size_) { coarse_size = coarse_size_; }
+
+   /// Set the smoother and the number of sweeps, default GAUSS_SEIDEL, 1.
+   void SetSmoother(SmootherType type, int sweeps = 1)
+   { smoother_type = type; smoother_sweeps = sweeps; }
+
+   /// Print the hierarchy after the setup if @a print_lvl > 0.
+   void SetPrintLevel(int print_lvl) { print_level = print_lvl; }
+
+   /// Set the (finalized, square) SparseMatrix and build the hierarchy.
+   virtual void SetOperator(const Operator &op);
+
+   /// Apply one V-cycle.
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// Returns the number of levels in the hierarchy.
+   int GetNumLevels() const { return A.Size(); }
+
+   /// Returns the matrix on level @a l, where level 0 is the finest one.
+   const SparseMatrix &GetLevelMatrix(int l) const { return *A[l]; }
+
+   /** @brief Returns the operator complexity: the total number of nonzeros
+       in the hierarchy divided by the nonzeros of the finest matrix. */
+   double GetOperatorComplexity() const;
+};
+
+}
+
+#endif
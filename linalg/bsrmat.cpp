@@ -0,0 +1,526 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of block compressed sparse row (BSR) matrices
+
+#include "bsrmat.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace mfem
+{
+
+using namespace std;
+
+// y += a A x for BSR blocks of compile-time size BS. The scalar index of
+// component c of block k is k*xb+c*xc for x and k*yb+c*yc for y.
+template <int BS>
+static void BSRAddMult(int nbrows, const int *I, const int *J,
+                       const double *A, const double *x, int xb, int xc,
+                       double *y, int yb, int yc, double a)
+{
+   for (int i = 0; i < nbrows; i++)
+   {
+      double yi[BS];
+      for (int r = 0; r < BS; r++) { yi[r] = 0.0; }
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const double *blk = A + k*BS*BS;
+         const double *xj = x + J[k]*xb;
+         for (int c = 0; c < BS; c++)
+         {
+            const double xjc = xj[c*xc];
+            for (int r = 0; r < BS; r++)
+            {
+               yi[r] += blk[r+c*BS] * xjc;
+            }
+         }
+      }
+      for (int r = 0; r < BS; r++) { y[i*yb+r*yc] += a * yi[r]; }
+   }
+}
+
+// Same as above, for a runtime block size.
+static void BSRAddMult(int nbrows, int bs, const int *I, const int *J,
+                       const double *A, const double *x, int xb, int xc,
+                       double *y, int yb, int yc, double a)
+{
+   for (int i = 0; i < nbrows; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const double *blk = A + k*bs*bs;
+         const double *xj = x + J[k]*xb;
+         for (int c = 0; c < bs; c++)
+         {
+            const double xjc = a * xj[c*xc];
+            for (int r = 0; r < bs; r++)
+            {
+               y[i*yb+r*yc] += blk[r+c*bs] * xjc;
+            }
+         }
+      }
+   }
+}
+
+void BlockSparseMatrix::Init(int nbr, int nbc, int bsize, bool order_bynodes)
+{
+   MFEM_VERIFY(bsize > 0, "invalid block size: " << bsize);
+   bs = bsize;
+   nbrows = nbr;
+   nbcols = nbc;
+   bynodes = order_bynodes;
+   height = nbrows*bs;
+   width = nbcols*bs;
+   I.SetSize(nbrows+1);
+   I = 0;
+   J.SetSize(0);
+   A.SetSize(0);
+}
+
+int BlockSparseMatrix::FindBlock(int i, int j) const
+{
+   const int *beg = J.GetData() + I[i], *end = J.GetData() + I[i+1];
+   const int *p = std::lower_bound(beg, end, j);
+   return (p != end && *p == j) ? (int)(p - J.GetData()) : -1;
+}
+
+BlockSparseMatrix::BlockSparseMatrix(const Table &block_graph, int nbc,
+                                     int bsize, bool order_bynodes)
+{
+   Init(block_graph.Size(), nbc, bsize, order_bynodes);
+   for (int i = 0; i <= nbrows; i++)
+   {
+      I[i] = block_graph.GetI()[i];
+   }
+   J.SetSize(I[nbrows]);
+   for (int k = 0; k < J.Size(); k++)
+   {
+      J[k] = block_graph.GetJ()[k];
+   }
+   for (int i = 0; i < nbrows; i++)
+   {
+      std::sort(J.GetData() + I[i], J.GetData() + I[i+1]);
+   }
+   A.SetSize(I[nbrows]*bs*bs);
+   A = 0.0;
+}
+
+BlockSparseMatrix::BlockSparseMatrix(const SparseMatrix &mat, int bsize,
+                                     bool order_bynodes)
+{
+   MFEM_VERIFY(mat.Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(mat.Height() % bsize == 0 && mat.Width() % bsize == 0,
+               "the matrix size is not a multiple of the block size");
+   Init(mat.Height()/bsize, mat.Width()/bsize, bsize, order_bynodes);
+
+   const int *mI = mat.GetI(), *mJ = mat.GetJ();
+   const double *mA = mat.GetData();
+   const int rb = RowBlockStride(), rc = RowCompStride();
+
+   // Compute the block graph.
+   Array<int> marker(nbcols);
+   marker = -1;
+   for (int i = 0; i < nbrows; i++)
+   {
+      for (int r = 0; r < bs; r++)
+      {
+         const int s = i*rb + r*rc;
+         for (int p = mI[s]; p < mI[s+1]; p++)
+         {
+            const int bj = ColBlock(mJ[p]);
+            if (marker[bj] != i)
+            {
+               marker[bj] = i;
+               J.Append(bj);
+            }
+         }
+      }
+      I[i+1] = J.Size();
+      std::sort(J.GetData() + I[i], J.GetData() + I[i+1]);
+   }
+
+   // Copy the entries.
+   A.SetSize(I[nbrows]*bs*bs);
+   A = 0.0;
+   for (int i = 0; i < nbrows; i++)
+   {
+      for (int r = 0; r < bs; r++)
+      {
+         const int s = i*rb + r*rc;
+         for (int p = mI[s]; p < mI[s+1]; p++)
+         {
+            const int k = FindBlock(i, ColBlock(mJ[p]));
+            GetBlock(k)[r+ColComp(mJ[p])*bs] += mA[p];
+         }
+      }
+   }
+}
+
+void BlockSparseMatrix::AddElementMatrix(const Array<int> &brows,
+                                         const Array<int> &bcols,
+                                         const DenseMatrix &elmat)
+{
+   const int nr = brows.Size(), nc = bcols.Size();
+   MFEM_ASSERT(elmat.Height() == nr*bs && elmat.Width() == nc*bs,
+               "invalid element matrix size");
+   for (int a = 0; a < nr; a++)
+   {
+      const int i = brows[a];
+      for (int b = 0; b < nc; b++)
+      {
+         const int k = FindBlock(i, bcols[b]);
+         MFEM_VERIFY(k >= 0, "block (" << i << ", " << bcols[b]
+                     << ") is not in the sparsity pattern");
+         double *blk = GetBlock(k);
+         for (int c = 0; c < bs; c++)
+         {
+            for (int r = 0; r < bs; r++)
+            {
+               blk[r+c*bs] += elmat(r*nr+a, c*nc+b);
+            }
+         }
+      }
+   }
+}
+
+SparseMatrix *BlockSparseMatrix::ToSparseMatrix() const
+{
+   const int rb = RowBlockStride(), rc = RowCompStride();
+   const int cb = ColBlockStride(), cc = ColCompStride();
+
+   int *sI = mfem::New<int>(height+1);
+   int *sJ = mfem::New<int>(NumNonZeroElems());
+   double *sA = mfem::New<double>(NumNonZeroElems());
+
+   sI[0] = 0;
+   for (int s = 0; s < height; s++)
+   {
+      const int i = RowBlock(s);
+      sI[s+1] = sI[s] + (I[i+1]-I[i])*bs;
+   }
+   for (int i = 0; i < nbrows; i++)
+   {
+      for (int r = 0; r < bs; r++)
+      {
+         const int s = i*rb + r*rc;
+         int p = sI[s];
+         // Order the columns so that they are sorted in both layouts.
+         if (bynodes)
+         {
+            for (int c = 0; c < bs; c++)
+            {
+               for (int k = I[i]; k < I[i+1]; k++, p++)
+               {
+                  sJ[p] = J[k]*cb + c*cc;
+                  sA[p] = GetBlock(k)[r+c*bs];
+               }
+            }
+         }
+         else
+         {
+            for (int k = I[i]; k < I[i+1]; k++)
+            {
+               for (int c = 0; c < bs; c++, p++)
+               {
+                  sJ[p] = J[k]*cb + c*cc;
+                  sA[p] = GetBlock(k)[r+c*bs];
+               }
+            }
+         }
+      }
+   }
+   return new SparseMatrix(sI, sJ, sA, height, width, true, true, true);
+}
+
+double &BlockSparseMatrix::Elem(int i, int j)
+{
+   return const_cast<double &>(
+             static_cast<const BlockSparseMatrix *>(this)->Elem(i, j));
+}
+
+const double &BlockSparseMatrix::Elem(int i, int j) const
+{
+   MFEM_ASSERT(i >= 0 && i < height && j >= 0 && j < width,
+               "Trying to access element outside of the matrix: i = " << i
+               << ", j = " << j);
+   const int k = FindBlock(RowBlock(i), ColBlock(j));
+   MFEM_VERIFY(k >= 0, "Did not find i = " << i << ", j = " << j
+               << " in matrix.");
+   return GetBlock(k)[RowComp(i)+ColComp(j)*bs];
+}
+
+MatrixInverse *BlockSparseMatrix::Inverse() const
+{
+   mfem_error("BlockSparseMatrix::Inverse() is not implemented!");
+   return NULL;
+}
+
+int BlockSparseMatrix::GetRow(const int row, Array<int> &cols,
+                              Vector &srow) const
+{
+   const int i = RowBlock(row), r = RowComp(row);
+   const int cb = ColBlockStride(), cc = ColCompStride();
+   const int n = (I[i+1]-I[i])*bs;
+   cols.SetSize(n);
+   srow.SetSize(n);
+   for (int k = I[i], p = 0; k < I[i+1]; k++)
+   {
+      for (int c = 0; c < bs; c++, p++)
+      {
+         cols[p] = J[k]*cb + c*cc;
+         srow(p) = GetBlock(k)[r+c*bs];
+      }
+   }
+   return 0;
+}
+
+void BlockSparseMatrix::EliminateZeroRows(const double threshold)
+{
+   for (int i = 0; i < nbrows; i++)
+   {
+      const int kd = FindBlock(i, i);
+      for (int r = 0; r < bs; r++)
+      {
+         double norm = 0.0;
+         for (int k = I[i]; k < I[i+1]; k++)
+         {
+            for (int c = 0; c < bs; c++)
+            {
+               norm += fabs(GetBlock(k)[r+c*bs]);
+            }
+         }
+         if (norm <= threshold && kd >= 0)
+         {
+            GetBlock(kd)[r+r*bs] = 1.0;
+         }
+      }
+   }
+}
+
+void BlockSparseMatrix::Mult(const Vector &x, Vector &y) const
+{
+   y = 0.0;
+   AddMult(x, y);
+}
+
+void BlockSparseMatrix::AddMult(const Vector &x, Vector &y,
+                                const double a) const
+{
+   MFEM_ASSERT(x.Size() == width, "invalid input vector size");
+   MFEM_ASSERT(y.Size() == height, "invalid output vector size");
+
+   const int xb = ColBlockStride(), xc = ColCompStride();
+   const int yb = RowBlockStride(), yc = RowCompStride();
+   const double *xp = x.GetData();
+   double *yp = y.GetData();
+   switch (bs)
+   {
+      case 2:
+         BSRAddMult<2>(nbrows, I, J, A, xp, xb, xc, yp, yb, yc, a);
+         break;
+      case 3:
+         BSRAddMult<3>(nbrows, I, J, A, xp, xb, xc, yp, yb, yc, a);
+         break;
+      default:
+         BSRAddMult(nbrows, bs, I, J, A, xp, xb, xc, yp, yb, yc, a);
+   }
+}
+
+void BlockSparseMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   y = 0.0;
+   AddMultTranspose(x, y);
+}
+
+void BlockSparseMatrix::AddMultTranspose(const Vector &x, Vector &y,
+                                         const double a) const
+{
+   MFEM_ASSERT(x.Size() == height, "invalid input vector size");
+   MFEM_ASSERT(y.Size() == width, "invalid output vector size");
+
+   const int xb = RowBlockStride(), xc = RowCompStride();
+   const int yb = ColBlockStride(), yc = ColCompStride();
+   const double *xp = x.GetData();
+   double *yp = y.GetData();
+   for (int i = 0; i < nbrows; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const double *blk = GetBlock(k);
+         double *yj = yp + J[k]*yb;
+         for (int c = 0; c < bs; c++)
+         {
+            double d = 0.0;
+            for (int r = 0; r < bs; r++)
+            {
+               d += blk[r+c*bs] * xp[i*xb+r*xc];
+            }
+            yj[c*yc] += a * d;
+         }
+      }
+   }
+}
+
+void BlockSparseMatrix::EliminateRowsCols(const Array<int> &vdofs,
+                                          const Vector &sol, Vector &rhs)
+{
+   MFEM_VERIFY(height == width, "the matrix must be square");
+   const int rb = RowBlockStride(), rc = RowCompStride();
+
+   Array<bool> ess(height);
+   ess = false;
+   for (int p = 0; p < vdofs.Size(); p++)
+   {
+      const int s = vdofs[p];
+      ess[(s >= 0) ? s : (-1-s)] = true;
+   }
+   for (int i = 0; i < nbrows; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         double *blk = GetBlock(k);
+         for (int c = 0; c < bs; c++)
+         {
+            const int t = J[k]*rb + c*rc;
+            for (int r = 0; r < bs; r++)
+            {
+               const int s = i*rb + r*rc;
+               double &a_st = blk[r+c*bs];
+               if (ess[s])
+               {
+                  a_st = (s == t) ? 1.0 : 0.0;
+               }
+               else if (ess[t])
+               {
+                  rhs(s) -= a_st * sol(t);
+                  a_st = 0.0;
+               }
+            }
+         }
+      }
+   }
+   for (int s = 0; s < height; s++)
+   {
+      if (ess[s]) { rhs(s) = sol(s); }
+   }
+}
+
+void BlockSparseMatrix::GetDiagBlockInverses(DenseTensor &Dinv) const
+{
+   MFEM_VERIFY(height == width, "the matrix must be square");
+   Dinv.SetSize(bs, bs, nbrows);
+   for (int i = 0; i < nbrows; i++)
+   {
+      const int k = FindBlock(i, i);
+      MFEM_VERIFY(k >= 0, "missing diagonal block in block row " << i);
+      std::copy(GetBlock(k), GetBlock(k) + bs*bs, Dinv.GetData(i));
+      Dinv(i).Invert();
+   }
+}
+
+void BlockSparseMatrix::BlockGaussSeidelForw(const DenseTensor &Dinv,
+                                             const Vector &b,
+                                             Vector &x) const
+{
+   const int rb = RowBlockStride(), rc = RowCompStride();
+   Vector res(bs), xi(bs);
+   for (int i = 0; i < nbrows; i++)
+   {
+      for (int r = 0; r < bs; r++) { res(r) = b(i*rb+r*rc); }
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const int j = J[k];
+         if (j == i) { continue; }
+         const double *blk = GetBlock(k);
+         for (int c = 0; c < bs; c++)
+         {
+            const double xjc = x(j*rb+c*rc);
+            for (int r = 0; r < bs; r++)
+            {
+               res(r) -= blk[r+c*bs] * xjc;
+            }
+         }
+      }
+      Dinv(i).Mult(res, xi);
+      for (int r = 0; r < bs; r++) { x(i*rb+r*rc) = xi(r); }
+   }
+}
+
+void BlockSparseMatrix::BlockGaussSeidelBack(const DenseTensor &Dinv,
+                                             const Vector &b,
+                                             Vector &x) const
+{
+   const int rb = RowBlockStride(), rc = RowCompStride();
+   Vector res(bs), xi(bs);
+   for (int i = nbrows-1; i >= 0; i--)
+   {
+      for (int r = 0; r < bs; r++) { res(r) = b(i*rb+r*rc); }
+      for (int k = I[i+1]-1; k >= I[i]; k--)
+      {
+         const int j = J[k];
+         if (j == i) { continue; }
+         const double *blk = GetBlock(k);
+         for (int c = 0; c < bs; c++)
+         {
+            const double xjc = x(j*rb+c*rc);
+            for (int r = 0; r < bs; r++)
+            {
+               res(r) -= blk[r+c*bs] * xjc;
+            }
+         }
+      }
+      Dinv(i).Mult(res, xi);
+      for (int r = 0; r < bs; r++) { x(i*rb+r*rc) = xi(r); }
+   }
+}
+
+void BlockSparseMatrix::Print(std::ostream &out, int width_) const
+{
+   SparseMatrix *S = ToSparseMatrix();
+   S->Print(out, width_);
+   delete S;
+}
+
+
+void BlockGSSmoother::SetOperator(const Operator &a)
+{
+   oper = dynamic_cast<const BlockSparseMatrix*>(&a);
+   if (oper == NULL)
+   {
+      mfem_error("BlockGSSmoother::SetOperator : not a BlockSparseMatrix!");
+   }
+   height = oper->Height();
+   width = oper->Width();
+   oper->GetDiagBlockInverses(Dinv);
+}
+
+void BlockGSSmoother::Mult(const Vector &x, Vector &y) const
+{
+   if (!iterative_mode)
+   {
+      y = 0.0;
+   }
+   for (int i = 0; i < iterations; i++)
+   {
+      if (type != 2)
+      {
+         oper->BlockGaussSeidelForw(Dinv, x, y);
+      }
+      if (type != 1)
+      {
+         oper->BlockGaussSeidelBack(Dinv, x, y);
+      }
+   }
+}
+
+}
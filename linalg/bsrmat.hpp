@@ -0,0 +1,204 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_BSRMAT
+#define MFEM_BSRMAT
+
+// Data types for block compressed sparse row (BSR) matrices
+
+#include "../config/config.hpp"
+#include "../general/table.hpp"
+#include "sparsemat.hpp"
+#include "densemat.hpp"
+#include "solvers.hpp"
+
+namespace mfem
+{
+
+/** @brief Sparse matrix with dense square blocks of fixed size, stored in the
+    block compressed sparse row (BSR) format. */
+/** All entries of a block share one column index, which reduces the index
+    traffic compared to SparseMatrix, e.g. for vector-valued (vdim > 1)
+    finite element spaces where the vector components of a node share the same
+    sparsity.
+
+    The scalar (vector) indices used by Mult(), Elem(), etc. follow the layout
+    of the vector finite element spaces: with the byVDIM ordering, the scalar
+    index of component c of block (node) k is k*bs+c; with the byNODES ordering
+    it is c*nb+k, where nb is the number of block rows (or block columns). */
+class BlockSparseMatrix : public AbstractSparseMatrix
+{
+protected:
+   int bs;            ///< Block size
+   int nbrows;        ///< Number of block rows
+   int nbcols;        ///< Number of block columns
+   bool bynodes;      ///< Ordering of the scalar indices: byNODES or byVDIM
+   Array<int> I;      ///< Block row offsets, size nbrows+1
+   Array<int> J;      ///< Block column indices, size I[nbrows], sorted per row
+   /** @brief Block entries, size I[nbrows]*bs*bs. Each block is stored in
+       column-major order, like DenseMatrix. */
+   Vector A;
+
+   // Strides of the scalar row/column indices w.r.t. block index and component
+   int RowBlockStride() const { return bynodes ? 1 : bs; }
+   int RowCompStride() const { return bynodes ? nbrows : 1; }
+   int ColBlockStride() const { return bynodes ? 1 : bs; }
+   int ColCompStride() const { return bynodes ? nbcols : 1; }
+
+   // Block index and component of the scalar row/column index s
+   int RowBlock(int s) const { return bynodes ? s % nbrows : s / bs; }
+   int RowComp(int s) const { return bynodes ? s / nbrows : s % bs; }
+   int ColBlock(int s) const { return bynodes ? s % nbcols : s / bs; }
+   int ColComp(int s) const { return bynodes ? s / nbcols : s % bs; }
+
+   void Init(int nbr, int nbc, int bsize, bool order_bynodes);
+
+   /// Return the offset of block (i,j) in #J, or -1 if it is not present.
+   int FindBlock(int i, int j) const;
+
+public:
+   /// Create an empty BlockSparseMatrix.
+   BlockSparseMatrix() { Init(0, 0, 1, false); }
+
+   /** @brief Create a BlockSparseMatrix with the sparsity pattern given by the
+       Table @a block_graph, with @a nbc block columns and blocks of size
+       @a bsize. All entries are set to zero. */
+   BlockSparseMatrix(const Table &block_graph, int nbc, int bsize,
+                     bool order_bynodes = false);
+
+   /** @brief Convert the SparseMatrix @a mat, whose size must be a multiple of
+       @a bsize, to the BSR format. */
+   /** Every block containing at least one entry in the sparsity pattern of
+       @a mat is stored. */
+   BlockSparseMatrix(const SparseMatrix &mat, int bsize,
+                     bool order_bynodes = false);
+
+   /// Return the block size.
+   int GetBlockSize() const { return bs; }
+   /// Return the number of block rows.
+   int NumBlockRows() const { return nbrows; }
+   /// Return the number of block columns.
+   int NumBlockCols() const { return nbcols; }
+   /// Return the number of stored blocks.
+   int NumBlocks() const { return I[nbrows]; }
+   /// Return true if the scalar indices use the byNODES ordering.
+   bool OrderedByNodes() const { return bynodes; }
+
+   const int *GetI() const { return I.GetData(); }
+   const int *GetJ() const { return J.GetData(); }
+   double *GetData() { return A.GetData(); }
+   const double *GetData() const { return A.GetData(); }
+
+   /// Return a pointer to the stored block with offset @a k in #J.
+   double *GetBlock(int k) { return A.GetData() + k*bs*bs; }
+   const double *GetBlock(int k) const { return A.GetData() + k*bs*bs; }
+
+   /// Set all stored entries to @a a.
+   BlockSparseMatrix &operator=(double a) { A = a; return *this; }
+
+   /** @brief Add the element matrix @a elmat to the blocks with block rows
+       @a brows and block columns @a bcols. */
+   /** The rows and columns of @a elmat are ordered by components first, i.e.
+       row c*brows.Size()+a corresponds to component c of block row brows[a],
+       which is the layout of the element matrices computed by the
+       BilinearFormIntegrator%s. All referenced blocks must be present in the
+       sparsity pattern. */
+   void AddElementMatrix(const Array<int> &brows, const Array<int> &bcols,
+                         const DenseMatrix &elmat);
+
+   /// Convert to a new SparseMatrix with the same scalar index layout.
+   SparseMatrix *ToSparseMatrix() const;
+
+   /// Returns reference to a_{ij} for scalar indices i and j.
+   virtual double &Elem(int i, int j);
+
+   /// Returns constant reference to a_{ij} for scalar indices i and j.
+   virtual const double &Elem(int i, int j) const;
+
+   /// Not implemented.
+   virtual MatrixInverse *Inverse() const;
+
+   /// Returns the number of stored scalar entries, NumBlocks()*bs*bs.
+   virtual int NumNonZeroElems() const { return NumBlocks()*bs*bs; }
+
+   /// Gets the columns indexes and values for scalar row @a row.
+   virtual int GetRow(const int row, Array<int> &cols, Vector &srow) const;
+
+   /// Set the diagonal of the (scalar) rows with l1-norm below @a threshold.
+   virtual void EliminateZeroRows(const double threshold = 1e-12);
+
+   /// Matrix vector multiplication, y = A x.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// y += a A x
+   virtual void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// Multiply a vector with the transposed matrix, y = A^t x.
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// y += a A^t x
+   virtual void AddMultTranspose(const Vector &x, Vector &y,
+                                 const double a = 1.0) const;
+
+   /** @brief Eliminate the rows and columns of the scalar indices @a vdofs:
+       the eliminated columns are moved to @a rhs using the values in @a sol,
+       the eliminated diagonal entries are set to one and the corresponding
+       entries of @a rhs are set to the values in @a sol. */
+   /** Requires a square matrix. */
+   void EliminateRowsCols(const Array<int> &vdofs, const Vector &sol,
+                          Vector &rhs);
+
+   /** @brief Compute the inverses of the diagonal blocks, stored in @a Dinv of
+       size bs x bs x NumBlockRows(). Requires a square matrix. */
+   void GetDiagBlockInverses(DenseTensor &Dinv) const;
+
+   /** @brief One forward block Gauss-Seidel sweep for A x = b, using the
+       inverses of the diagonal blocks @a Dinv, see GetDiagBlockInverses(). */
+   void BlockGaussSeidelForw(const DenseTensor &Dinv, const Vector &b,
+                             Vector &x) const;
+
+   /// One backward block Gauss-Seidel sweep for A x = b.
+   void BlockGaussSeidelBack(const DenseTensor &Dinv, const Vector &b,
+                             Vector &x) const;
+
+   /// Print the matrix in the sparse format (scalar row, column, value).
+   virtual void Print(std::ostream &out = mfem::out, int width_ = 4) const;
+};
+
+
+/// Block Gauss-Seidel smoother for a BlockSparseMatrix.
+class BlockGSSmoother : public Solver
+{
+protected:
+   const BlockSparseMatrix *oper;
+   DenseTensor Dinv;
+   int type; // 0, 1, 2 - symmetric, forward, backward
+   int iterations;
+
+public:
+   /// Create BlockGSSmoother.
+   BlockGSSmoother(int t = 0, int it = 1)
+      : oper(NULL) { type = t; iterations = it; }
+
+   /// Create BlockGSSmoother.
+   BlockGSSmoother(const BlockSparseMatrix &a, int t = 0, int it = 1)
+      : oper(NULL) { type = t; iterations = it; SetOperator(a); }
+
+   /// Set the BlockSparseMatrix and compute the diagonal block inverses.
+   virtual void SetOperator(const Operator &a);
+
+   /// Apply the block Gauss-Seidel sweeps.
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+}
+
+#endif
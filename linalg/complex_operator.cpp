@@ -10,6 +10,10 @@
 // Software Foundation) version 2.1 dated February 1999.
 
 #include "complex_operator.hpp"
+#include "dtensor.hpp"
+#include "../general/forall.hpp"
+
+#include <algorithm>
 
 namespace mfem
 {
@@ -31,6 +35,21 @@ ComplexOperator::ComplexOperator(Operator * Op_Real, Operator * Op_Imag,
    , v_(NULL)
 {}
 
+ComplexOperator::ComplexOperator(int height, int width, Convention convention)
+   : Operator(2*height, 2*width)
+   , Op_Real_(NULL)
+   , Op_Imag_(NULL)
+   , ownReal_(false)
+   , ownImag_(false)
+   , convention_(convention)
+   , x_r_(NULL, width)
+   , x_i_(NULL, width)
+   , y_r_(NULL, height)
+   , y_i_(NULL, height)
+   , u_(NULL)
+   , v_(NULL)
+{}
+
 ComplexOperator::~ComplexOperator()
 {
    if (ownReal_) { delete Op_Real_; }
@@ -68,14 +87,14 @@ void ComplexOperator::Mult(const Vector &x_r, const Vector &x_i,
    {
       if (!v_) { v_ = new Vector(Op_Imag_->Height()); }
       Op_Imag_->Mult(x_i, *v_);
-      y_r_ -= *v_;
+      y_r -= *v_;
       Op_Imag_->Mult(x_r, *v_);
-      y_i_ += *v_;
+      y_i += *v_;
    }
 
    if (convention_ == BLOCK_SYMMETRIC)
    {
-      y_i_ *= -1.0;
+      y_i *= -1.0;
    }
 }
 
@@ -113,15 +132,275 @@ void ComplexOperator::MultTranspose(const Vector &x_r, const Vector &x_i,
    {
       if (!u_) { u_ = new Vector(Op_Imag_->Width()); }
       Op_Imag_->MultTranspose(x_i, *u_);
-      y_r_.Add(convention_ == BLOCK_SYMMETRIC ? -1.0 : 1.0, *u_);
+      y_r.Add(convention_ == BLOCK_SYMMETRIC ? -1.0 : 1.0, *u_);
       Op_Imag_->MultTranspose(x_r, *u_);
-      y_i_ -= *u_;
+      y_i -= *u_;
+   }
+}
+
+
+ComplexSparseMatrix::ComplexSparseMatrix(const SparseMatrix &graph,
+                                         Convention convention)
+   : ComplexOperator(graph.Height(), graph.Width(), convention),
+     I_(NULL), J_(NULL), Z_(NULL)
+{
+   MFEM_VERIFY(graph.Finalized(), "the graph must be finalized");
+   MakeGraph(&graph, NULL);
+   SetZero();
+}
+
+ComplexSparseMatrix::~ComplexSparseMatrix()
+{
+   mfem::Delete(I_);
+   mfem::Delete(J_);
+   mfem::Delete(Z_);
+}
+
+void ComplexSparseMatrix::MakeGraph(const SparseMatrix *A,
+                                    const SparseMatrix *B)
+{
+   const int n = height/2, m = width/2;
+   const SparseMatrix *M[2] = { A, B };
+
+   // Count the distinct columns of each row with a marker array
+   Array<int> marker(m);
+   marker = -1;
+   I_ = mfem::New<int>(n+1);
+   I_[0] = 0;
+   for (int i = 0; i < n; i++)
+   {
+      int cnt = 0;
+      for (int l = 0; l < 2; l++)
+      {
+         if (!M[l]) { continue; }
+         const int *Mi = M[l]->GetI(), *Mj = M[l]->GetJ();
+         for (int k = Mi[i]; k < Mi[i+1]; k++)
+         {
+            if (marker[Mj[k]] != i) { marker[Mj[k]] = i; cnt++; }
+         }
+      }
+      I_[i+1] = I_[i] + cnt;
    }
+
+   marker = -1;
+   J_ = mfem::New<int>(I_[n]);
+   for (int i = 0; i < n; i++)
+   {
+      int pos = I_[i];
+      for (int l = 0; l < 2; l++)
+      {
+         if (!M[l]) { continue; }
+         const int *Mi = M[l]->GetI(), *Mj = M[l]->GetJ();
+         for (int k = Mi[i]; k < Mi[i+1]; k++)
+         {
+            if (marker[Mj[k]] != i) { marker[Mj[k]] = i; J_[pos++] = Mj[k]; }
+         }
+      }
+      std::sort(J_ + I_[i], J_ + I_[i+1]);
+   }
+   Z_ = mfem::New<double>(2*I_[n]);
 }
 
+void ComplexSparseMatrix::ConvertToInterleaved()
+{
+   if (IsInterleaved()) { return; }
+   SparseMatrix *A_r = dynamic_cast<SparseMatrix*>(Op_Real_);
+   SparseMatrix *A_i = dynamic_cast<SparseMatrix*>(Op_Imag_);
+   MFEM_VERIFY((A_r || !Op_Real_) && (A_i || !Op_Imag_),
+               "the real and imaginary parts must be SparseMatrix objects");
+   MFEM_VERIFY((!A_r || A_r->Finalized()) && (!A_i || A_i->Finalized()),
+               "the real and imaginary parts must be finalized");
+
+   MakeGraph(A_r, A_i);
+   SetZero();
+   if (A_r) { AddInterleaved(1.0, 0.0, *A_r); }
+   if (A_i) { AddInterleaved(0.0, 1.0, *A_i); }
+
+   if (ownReal_) { delete Op_Real_; }
+   if (ownImag_) { delete Op_Imag_; }
+   Op_Real_ = Op_Imag_ = NULL;
+   ownReal_ = ownImag_ = false;
+}
+
+void ComplexSparseMatrix::SetZero()
+{
+   MFEM_VERIFY(IsInterleaved(), "the interleaved storage is not used");
+   const int nnz2 = 2*NumNonZeroElems();
+   for (int k = 0; k < nnz2; k++) { Z_[k] = 0.0; }
+}
+
+void ComplexSparseMatrix::AddInterleaved(double a_r, double a_i,
+                                         const SparseMatrix &B)
+{
+   const int n = height/2;
+   const int *Bi = B.GetI(), *Bj = B.GetJ();
+   const double *Bd = B.GetData();
+   for (int i = 0; i < n; i++)
+   {
+      const int *row_beg = J_ + I_[i], *row_end = J_ + I_[i+1];
+      const int *p = row_beg;
+      for (int k = Bi[i]; k < Bi[i+1]; k++)
+      {
+         const int j = Bj[k];
+         // The columns of B are usually sorted: search from the last entry.
+         if (p == row_end || j < *p) { p = row_beg; }
+         p = std::lower_bound(p, row_end, j);
+         MFEM_VERIFY(p != row_end && *p == j,
+                     "Entry (" << i << "," << j << ") is not allocated.");
+         const int l = 2*(p - J_);
+         Z_[l]   += a_r*Bd[k];
+         Z_[l+1] += a_i*Bd[k];
+      }
+   }
+}
+
+void ComplexSparseMatrix::Add(double a_r, double a_i, const SparseMatrix &B)
+{
+   MFEM_VERIFY(IsInterleaved(), "the interleaved storage is not used");
+   MFEM_VERIFY(B.Finalized() && 2*B.Height() == height &&
+               2*B.Width() == width, "incompatible matrix");
+   AddInterleaved(a_r, a_i, B);
+}
+
+void ComplexSparseMatrix::AddSubMatrix(const Array<int> &rows,
+                                       const Array<int> &cols,
+                                       const DenseMatrix &subm_r,
+                                       const DenseMatrix &subm_i)
+{
+   MFEM_VERIFY(IsInterleaved(), "the interleaved storage is not used");
+   int gi, gj, s, t;
+   for (int i = 0; i < rows.Size(); i++)
+   {
+      if ((gi=rows[i]) < 0) { gi = -1-gi, s = -1; }
+      else { s = 1; }
+      MFEM_ASSERT(gi < height/2,
+                  "Trying to insert a row " << gi << " outside the matrix"
+                  " height " << height/2);
+      const int *row_beg = J_ + I_[gi], *row_end = J_ + I_[gi+1];
+      const int *p = row_beg;
+      for (int j = 0; j < cols.Size(); j++)
+      {
+         if ((gj=cols[j]) < 0) { gj = -1-gj, t = -s; }
+         else { t = s; }
+         if (p == row_end || gj < *p) { p = row_beg; }
+         p = std::lower_bound(p, row_end, gj);
+         MFEM_VERIFY(p != row_end && *p == gj,
+                     "Entry for column " << gj << " is not allocated.");
+         const int l = 2*(p - J_);
+         Z_[l]   += t*subm_r(i, j);
+         Z_[l+1] += t*subm_i(i, j);
+      }
+   }
+}
+
+void ComplexSparseMatrix::Mult(const Vector &x, Vector &y) const
+{
+   if (!IsInterleaved()) { ComplexOperator::Mult(x, y); return; }
+
+   // Single pass over the graph computing
+   //    y_r = A_r x_r - A_i x_i,   y_i = s (A_i x_r + A_r x_i)
+   // where s = -1 for the block symmetric convention.
+   const int n = height/2, m = width/2;
+   const double s = (convention_ == HERMITIAN) ? 1.0 : -1.0;
+   const DeviceArray d_I(I_);
+   const DeviceArray d_J(J_);
+   const DeviceVector d_Z(Z_);
+   const DeviceVector d_x(x, x.Size());
+   DeviceVector d_y(y, y.Size());
+   MFEM_FORALL(i, n,
+   {
+      double yr = 0.0, yi = 0.0;
+      const int end = d_I[i+1];
+      for (int k = d_I[i]; k < end; k++)
+      {
+         const int j = d_J[k];
+         const double ar = d_Z[2*k], ai = d_Z[2*k+1];
+         const double xr = d_x[j], xi = d_x[m+j];
+         yr += ar*xr - ai*xi;
+         yi += ar*xi + ai*xr;
+      }
+      d_y[i] = yr;
+      d_y[n+i] = s*yi;
+   });
+}
+
+void ComplexSparseMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   if (!IsInterleaved()) { ComplexOperator::MultTranspose(x, y); return; }
+
+   // Single pass over the graph computing
+   //    y_r = A_r^T x_r + s A_i^T x_i,   y_i = -A_i^T x_r + s A_r^T x_i
+   // where s = -1 for the block symmetric convention.
+   const int n = height/2, m = width/2;
+   const double s = (convention_ == HERMITIAN) ? 1.0 : -1.0;
+   y = 0.0;
+   if (!Device::Allows(~Backend::CPU))
+   {
+      const double *xp = x.GetData();
+      double *yp = y.GetData();
+      for (int i = 0; i < n; i++)
+      {
+         const double xr = xp[i], xi = s*xp[n+i];
+         for (int k = I_[i]; k < I_[i+1]; k++)
+         {
+            const int j = J_[k];
+            const double ar = Z_[2*k], ai = Z_[2*k+1];
+            yp[j]   += ar*xr + ai*xi;
+            yp[m+j] += ar*xi - ai*xr;
+         }
+      }
+      return;
+   }
+   const DeviceArray d_I(I_);
+   const DeviceArray d_J(J_);
+   const DeviceVector d_Z(Z_);
+   const DeviceVector d_x(x, x.Size());
+   DeviceVector d_y(y, y.Size());
+   MFEM_FORALL(i, n,
+   {
+      const double xr = d_x[i], xi = s*d_x[n+i];
+      const int end = d_I[i+1];
+      for (int k = d_I[i]; k < end; k++)
+      {
+         const int j = d_J[k];
+         const double ar = d_Z[2*k], ai = d_Z[2*k+1];
+         AtomicAdd(&d_y[j], ar*xr + ai*xi);
+         AtomicAdd(&d_y[m+j], ar*xi - ai*xr);
+      }
+   });
+}
 
 SparseMatrix * ComplexSparseMatrix::GetSystemMatrix() const
 {
+   if (IsInterleaved())
+   {
+      const int n = height/2, m = width/2, nnz = NumNonZeroElems();
+      const double factor = (convention_ == HERMITIAN) ? 1.0 : -1.0;
+      int    *I = new int[height+1];
+      int    *J = new int[4*nnz];
+      double *D = new double[4*nnz];
+      I[0] = 0;
+      I[n] = 2*nnz;
+      for (int i = 0; i < n; i++)
+      {
+         const int len = I_[i+1] - I_[i];
+         I[i+1]   = 2*I_[i+1];
+         I[n+i+1] = 2*nnz + 2*I_[i+1];
+         int *Jr = J + I[i], *Ji = J + I[n+i];
+         double *Dr = D + I[i], *Di = D + I[n+i];
+         for (int k = 0; k < len; k++)
+         {
+            const int j = J_[I_[i]+k];
+            const double ar = Z_[2*(I_[i]+k)], ai = Z_[2*(I_[i]+k)+1];
+            Jr[k] = j;         Dr[k] = ar;
+            Jr[len+k] = m+j;   Dr[len+k] = -ai;
+            Ji[k] = j;         Di[k] = factor*ai;
+            Ji[len+k] = m+j;   Di[len+k] = factor*ar;
+         }
+      }
+      return new SparseMatrix(I, J, D, height, width);
+   }
+
    SparseMatrix * A_r = dynamic_cast<SparseMatrix*>(Op_Real_);
    SparseMatrix * A_i = dynamic_cast<SparseMatrix*>(Op_Imag_);
 
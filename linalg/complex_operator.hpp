@@ -86,6 +86,11 @@ public:
    virtual void MultTranspose(const Vector &x, Vector &y) const;
 
 protected:
+   /** @brief Constructor for derived classes which do not use the real
+       operators; @a height and @a width are the sizes of the complex
+       operator, i.e. half the sizes of the 2x2 block operator. */
+   ComplexOperator(int height, int width, Convention convention);
+
    // Let this be hidden from the public interface since the implementation
    // depends on internal members
    void Mult(const Vector &x_r, const Vector &x_i,
@@ -120,13 +125,79 @@ protected:
  */
 class ComplexSparseMatrix : public ComplexOperator
 {
+protected:
+   /** @name Interleaved storage
+       CSR graph with sorted rows, shared by the real and imaginary parts, and
+       the values stored as (re,im) pairs: entry k of the graph has the value
+       Z_[2*k] + i Z_[2*k+1]. */
+   ///@{
+   int *I_, *J_;
+   double *Z_;
+   ///@}
+
+   // Build I_ and J_ as the union of the sparsity patterns of A and B (either
+   // may be NULL) and allocate Z_.
+   void MakeGraph(const SparseMatrix *A, const SparseMatrix *B);
+
+   // Add (a_r + i a_i) B to the interleaved values.
+   void AddInterleaved(double a_r, double a_i, const SparseMatrix &B);
+
 public:
    ComplexSparseMatrix(SparseMatrix * A_Real, SparseMatrix * A_Imag,
                        bool ownReal, bool ownImag,
                        Convention convention = HERMITIAN)
-      : ComplexOperator(A_Real, A_Imag, ownReal, ownImag, convention)
+      : ComplexOperator(A_Real, A_Imag, ownReal, ownImag, convention),
+        I_(NULL), J_(NULL), Z_(NULL)
    {}
 
+   /** @brief Create a complex matrix with interleaved storage and the
+       sparsity pattern of the finalized matrix @a graph; all entries are
+       zero. */
+   /** The matrix is then assembled directly in complex form, e.g. from
+       element matrices with AddSubMatrix(), or as a linear combination of
+       real matrices like stiffness, mass and damping matrices with Add(),
+       which is the typical case for frequency sweeps. */
+   explicit ComplexSparseMatrix(const SparseMatrix &graph,
+                                Convention convention = HERMITIAN);
+
+   virtual ~ComplexSparseMatrix();
+
+   /** @brief Switch to the interleaved storage: the values of the real and
+       imaginary parts are copied into a single complex CSR matrix, and the
+       real and imaginary parts are released. */
+   void ConvertToInterleaved();
+
+   /// Return true if the interleaved storage is used.
+   bool IsInterleaved() const { return (I_ != NULL); }
+
+   /// Interleaved storage: the row offsets.
+   int *GetI() const { return I_; }
+   /// Interleaved storage: the column indices.
+   int *GetJ() const { return J_; }
+   /// Interleaved storage: the (re,im) values, 2*NumNonZeroElems() entries.
+   double *GetData() const { return Z_; }
+   /// Interleaved storage: the number of entries of the graph.
+   int NumNonZeroElems() const { return I_ ? I_[height/2] : 0; }
+
+   /// Interleaved storage: set all entries to zero.
+   void SetZero();
+
+   /** @brief Interleaved storage: add (@a a_r + i @a a_i) @a B, where the
+       sparsity pattern of @a B is contained in the one of this matrix. */
+   void Add(double a_r, double a_i, const SparseMatrix &B);
+
+   /** @brief Interleaved storage: add the complex element matrix
+       @a subm_r + i @a subm_i at the given rows and columns. */
+   /** Negative indices encode a change of sign, as in
+       SparseMatrix::AddSubMatrix(). */
+   void AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
+                     const DenseMatrix &subm_r, const DenseMatrix &subm_i);
+
+   /** @brief With the interleaved storage, the real and imaginary parts are
+       applied with a single pass over the matrix. */
+   virtual void Mult(const Vector &x, Vector &y) const;
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
    SparseMatrix * GetSystemMatrix() const;
 };
 
@@ -1093,6 +1093,89 @@ void dsyev_Eigensystem(DenseMatrix &a, Vector &ev, DenseMatrix *evect)
 #endif
 }
 
+#ifndef MFEM_USE_LAPACK
+// Eigenvalues (in ascending order) and eigenvectors of the symmetric part of
+// the square matrix a with the cyclic Jacobi method, used without LAPACK.
+static void Jacobi_Eigensystem(const DenseMatrix &a, Vector &ev,
+                               DenseMatrix *evect)
+{
+   const int N = a.Width();
+   DenseMatrix A(N), V(N);
+   for (int j = 0; j < N; j++)
+   {
+      for (int i = 0; i < N; i++) { A(i,j) = 0.5*(a(i,j) + a(j,i)); }
+   }
+   V = 0.0;
+   for (int i = 0; i < N; i++) { V(i,i) = 1.0; }
+
+   const double norm2 = A.FNorm2();
+   for (int sweep = 0; sweep < 100; sweep++)
+   {
+      double off2 = 0.0;
+      for (int j = 1; j < N; j++)
+      {
+         for (int i = 0; i < j; i++) { off2 += 2.0*A(i,j)*A(i,j); }
+      }
+      if (off2 <= 1e-30*norm2) { break; }
+
+      for (int p = 0; p < N-1; p++)
+      {
+         for (int q = p+1; q < N; q++)
+         {
+            const double apq = A(p,q);
+            if (apq == 0.0) { continue; }
+            // Rotation zeroing A(p,q), see Golub and Van Loan, Alg. 8.4.1
+            const double tau = (A(q,q) - A(p,p)) / (2.0*apq);
+            const double t = (tau >= 0.0 ? 1.0 : -1.0) /
+                             (fabs(tau) + sqrt(1.0 + tau*tau));
+            const double c = 1.0/sqrt(1.0 + t*t), s = t*c;
+            for (int k = 0; k < N; k++)
+            {
+               const double akp = A(k,p), akq = A(k,q);
+               A(k,p) = c*akp - s*akq;
+               A(k,q) = s*akp + c*akq;
+            }
+            for (int k = 0; k < N; k++)
+            {
+               const double apk = A(p,k), aqk = A(q,k);
+               A(p,k) = c*apk - s*aqk;
+               A(q,k) = s*apk + c*aqk;
+            }
+            for (int k = 0; k < N; k++)
+            {
+               const double vkp = V(k,p), vkq = V(k,q);
+               V(k,p) = c*vkp - s*vkq;
+               V(k,q) = s*vkp + c*vkq;
+            }
+         }
+      }
+   }
+
+   Array<int> perm(N);
+   for (int i = 0; i < N; i++) { perm[i] = i; }
+   for (int i = 1; i < N; i++)
+   {
+      const int pi = perm[i];
+      int j = i;
+      for ( ; j > 0 && A(perm[j-1],perm[j-1]) > A(pi,pi); j--)
+      {
+         perm[j] = perm[j-1];
+      }
+      perm[j] = pi;
+   }
+   ev.SetSize(N);
+   for (int i = 0; i < N; i++) { ev(i) = A(perm[i],perm[i]); }
+   if (evect)
+   {
+      evect->SetSize(N);
+      for (int j = 0; j < N; j++)
+      {
+         for (int i = 0; i < N; i++) { (*evect)(i,j) = V(i,perm[j]); }
+      }
+   }
+}
+#endif
+
 void DenseMatrix::Eigensystem(Vector &ev, DenseMatrix *evect)
 {
 #ifdef MFEM_USE_LAPACK
@@ -1103,7 +1186,7 @@ void DenseMatrix::Eigensystem(Vector &ev, DenseMatrix *evect)
 
 #else
 
-   mfem_error("DenseMatrix::Eigensystem");
+   Jacobi_Eigensystem(*this, ev, evect);
 
 #endif
 }
@@ -4526,4 +4609,379 @@ DenseTensor &DenseTensor::operator=(double c)
    return *this;
 }
 
+
+// Kernels of the batched routines for one matrix. A template parameter N > 0
+// fixes the size n of the matrix at compile time; N = 0 means that the size
+// is given by the argument n_.
+
+// Size of the local work arrays of the kernels.
+static const int batch_max_size = 256;
+
+template <int N> MFEM_ATTR_HOST_DEVICE inline
+void BatchMultKernel(const int m_, const int l_, const int n_, const double *A,
+                     const double *B, double *C)
+{
+   const int m = N ? N : m_, l = N ? N : l_, n = N ? N : n_;
+   if (m > batch_max_size)
+   {
+      for (int j = 0; j < n; j++)
+      {
+         double *c = C + j*m;
+         for (int i = 0; i < m; i++) { c[i] = 0.0; }
+         for (int k = 0; k < l; k++)
+         {
+            const double b = B[k+j*l];
+            for (int i = 0; i < m; i++) { c[i] += A[i+k*m] * b; }
+         }
+      }
+      return;
+   }
+   // Accumulate each column of C in a local array, which does not alias A
+   double c[N ? N : batch_max_size];
+   for (int j = 0; j < n; j++)
+   {
+      for (int i = 0; i < m; i++) { c[i] = 0.0; }
+      for (int k = 0; k < l; k++)
+      {
+         const double b = B[k+j*l];
+         for (int i = 0; i < m; i++) { c[i] += A[i+k*m] * b; }
+      }
+      for (int i = 0; i < m; i++) { C[i+j*m] = c[i]; }
+   }
+}
+
+template <int N> MFEM_ATTR_HOST_DEVICE inline
+void BatchLUFactorKernel(const int n_, double *A, int *ipiv)
+{
+   const int n = N ? N : n_;
+   for (int i = 0; i < n; i++)
+   {
+      int piv = i;
+      double a = fabs(A[i+i*n]);
+      for (int j = i+1; j < n; j++)
+      {
+         const double b = fabs(A[j+i*n]);
+         if (b > a)
+         {
+            a = b;
+            piv = j;
+         }
+      }
+      ipiv[i] = piv;
+      if (piv != i)
+      {
+         for (int j = 0; j < n; j++)
+         {
+            const double tmp = A[i+j*n];
+            A[i+j*n] = A[piv+j*n];
+            A[piv+j*n] = tmp;
+         }
+      }
+      const double a_ii_inv = 1.0/A[i+i*n];
+      for (int j = i+1; j < n; j++) { A[j+i*n] *= a_ii_inv; }
+      for (int k = i+1; k < n; k++)
+      {
+         const double a_ik = A[i+k*n];
+         for (int j = i+1; j < n; j++) { A[j+k*n] -= a_ik * A[j+i*n]; }
+      }
+   }
+}
+
+template <int N> MFEM_ATTR_HOST_DEVICE inline
+void BatchLUSolveKernel(const int n_, const double *LU, const int *ipiv,
+                        double *x)
+{
+   const int n = N ? N : n_;
+   // x <- L^{-1} P x
+   for (int i = 0; i < n; i++)
+   {
+      const double tmp = x[i];
+      x[i] = x[ipiv[i]];
+      x[ipiv[i]] = tmp;
+   }
+   for (int j = 0; j < n; j++)
+   {
+      const double x_j = x[j];
+      for (int i = j+1; i < n; i++) { x[i] -= LU[i+j*n] * x_j; }
+   }
+   // x <- U^{-1} x
+   for (int j = n-1; j >= 0; j--)
+   {
+      const double x_j = (x[j] /= LU[j+j*n]);
+      for (int i = 0; i < j; i++) { x[i] -= LU[i+j*n] * x_j; }
+   }
+}
+
+template <int N> MFEM_ATTR_HOST_DEVICE inline
+void BatchCholeskyFactorKernel(const int n_, double *A)
+{
+   const int n = N ? N : n_;
+   for (int j = 0; j < n; j++)
+   {
+      const double l_jj = sqrt(A[j+j*n]);
+      A[j+j*n] = l_jj;
+      const double l_jj_inv = 1.0/l_jj;
+      for (int i = j+1; i < n; i++) { A[i+j*n] *= l_jj_inv; }
+      for (int k = j+1; k < n; k++)
+      {
+         const double l_kj = A[k+j*n];
+         for (int i = k; i < n; i++) { A[i+k*n] -= A[i+j*n] * l_kj; }
+      }
+   }
+}
+
+template <int N> MFEM_ATTR_HOST_DEVICE inline
+void BatchCholeskySolveKernel(const int n_, const double *L, double *x)
+{
+   const int n = N ? N : n_;
+   // x <- L^{-1} x
+   for (int j = 0; j < n; j++)
+   {
+      const double x_j = (x[j] /= L[j+j*n]);
+      for (int i = j+1; i < n; i++) { x[i] -= L[i+j*n] * x_j; }
+   }
+   // x <- L^{-T} x
+   for (int i = n-1; i >= 0; i--)
+   {
+      double x_i = x[i];
+      for (int j = i+1; j < n; j++) { x_i -= L[j+i*n] * x[j]; }
+      x[i] = x_i / L[i+i*n];
+   }
+}
+
+template <int N> MFEM_ATTR_HOST_DEVICE inline
+void BatchInverseKernel(const int n_, double *A)
+{
+   const int n = N ? N : n_;
+   int ipiv[N ? N : batch_max_size];
+   for (int k = 0; k < n; k++)
+   {
+      int piv = k;
+      double a = fabs(A[k+k*n]);
+      for (int i = k+1; i < n; i++)
+      {
+         const double b = fabs(A[i+k*n]);
+         if (b > a)
+         {
+            a = b;
+            piv = i;
+         }
+      }
+      ipiv[k] = piv;
+      if (piv != k)
+      {
+         for (int j = 0; j < n; j++)
+         {
+            const double tmp = A[k+j*n];
+            A[k+j*n] = A[piv+j*n];
+            A[piv+j*n] = tmp;
+         }
+      }
+      // In-place Gauss-Jordan step with pivot A(k,k). Zeroing A(k,k) during
+      // the update of the other columns leaves row k unchanged, so that the
+      // inner loops need no branches.
+      const double p_inv = 1.0/A[k+k*n];
+      A[k+k*n] = 0.0;
+      for (int j = 0; j < n; j++)
+      {
+         if (j == k) { continue; }
+         const double a_kj = (A[k+j*n] *= p_inv);
+         for (int i = 0; i < n; i++) { A[i+j*n] -= A[i+k*n] * a_kj; }
+      }
+      for (int i = 0; i < n; i++) { A[i+k*n] *= -p_inv; }
+      A[k+k*n] = p_inv;
+   }
+   // Undo the row interchanges by interchanging the columns in reverse order
+   for (int k = n-1; k >= 0; k--)
+   {
+      const int piv = ipiv[k];
+      if (piv == k) { continue; }
+      for (int i = 0; i < n; i++)
+      {
+         const double tmp = A[i+k*n];
+         A[i+k*n] = A[i+piv*n];
+         A[i+piv*n] = tmp;
+      }
+   }
+}
+
+template <int N>
+static void BatchMult(const int m, const int l, const int n, const int nk,
+                      const double *A, const double *B, double *C)
+{
+   const DeviceVector d_A(A, m*l*nk), d_B(B, l*n*nk);
+   DeviceVector d_C(C, m*n*nk);
+   MFEM_FORALL(k, nk,
+   {
+      BatchMultKernel<N>(m, l, n, &d_A[k*m*l], &d_B[k*l*n], &d_C[k*m*n]);
+   });
+}
+
+void BatchMult(const DenseTensor &A, const DenseTensor &B, DenseTensor &C)
+{
+   const int m = A.SizeI(), l = A.SizeJ(), n = B.SizeJ(), nk = A.SizeK();
+   MFEM_VERIFY(B.SizeI() == l && B.SizeK() == nk, "incompatible tensors");
+   if (C.SizeI() != m || C.SizeJ() != n || C.SizeK() != nk)
+   {
+      C.SetSize(m, n, nk);
+   }
+   const double *a = A.Data(), *b = B.Data();
+   double *c = C.Data();
+   if (m == l && l == n)
+   {
+      switch (n)
+      {
+         case 2: return BatchMult<2>(m, l, n, nk, a, b, c);
+         case 3: return BatchMult<3>(m, l, n, nk, a, b, c);
+         case 4: return BatchMult<4>(m, l, n, nk, a, b, c);
+         case 8: return BatchMult<8>(m, l, n, nk, a, b, c);
+         case 9: return BatchMult<9>(m, l, n, nk, a, b, c);
+         case 16: return BatchMult<16>(m, l, n, nk, a, b, c);
+         case 27: return BatchMult<27>(m, l, n, nk, a, b, c);
+      }
+   }
+   BatchMult<0>(m, l, n, nk, a, b, c);
+}
+
+template <int N>
+static void BatchLUFactor(const int n, const int nk, double *A, int *P)
+{
+   DeviceVector d_A(A, n*n*nk);
+   DeviceArray d_P(P, n*nk);
+   MFEM_FORALL(k, nk, BatchLUFactorKernel<N>(n, &d_A[k*n*n], &d_P[k*n]););
+}
+
+void BatchLUFactor(DenseTensor &A, Array<int> &P)
+{
+   const int n = A.SizeI(), nk = A.SizeK();
+   MFEM_VERIFY(A.SizeJ() == n, "the matrices must be square");
+   P.SetSize(n*nk);
+   double *a = A.Data();
+   int *p = P.GetData();
+   switch (n)
+   {
+      case 2: return BatchLUFactor<2>(n, nk, a, p);
+      case 3: return BatchLUFactor<3>(n, nk, a, p);
+      case 4: return BatchLUFactor<4>(n, nk, a, p);
+      case 8: return BatchLUFactor<8>(n, nk, a, p);
+      case 9: return BatchLUFactor<9>(n, nk, a, p);
+      case 16: return BatchLUFactor<16>(n, nk, a, p);
+      case 27: return BatchLUFactor<27>(n, nk, a, p);
+   }
+   BatchLUFactor<0>(n, nk, a, p);
+}
+
+template <int N>
+static void BatchLUSolve(const int n, const int nk, const double *LU,
+                         const int *P, double *X)
+{
+   const DeviceVector d_LU(LU, n*n*nk);
+   const DeviceArray d_P(P, n*nk);
+   DeviceVector d_X(X, n*nk);
+   MFEM_FORALL(k, nk,
+               BatchLUSolveKernel<N>(n, &d_LU[k*n*n], &d_P[k*n], &d_X[k*n]););
+}
+
+void BatchLUSolve(const DenseTensor &LU, const Array<int> &P, Vector &X)
+{
+   const int n = LU.SizeI(), nk = LU.SizeK();
+   MFEM_VERIFY(LU.SizeJ() == n && P.Size() == n*nk && X.Size() == n*nk,
+               "incompatible sizes");
+   const double *lu = LU.Data();
+   const int *p = P.GetData();
+   double *x = X.GetData();
+   switch (n)
+   {
+      case 2: return BatchLUSolve<2>(n, nk, lu, p, x);
+      case 3: return BatchLUSolve<3>(n, nk, lu, p, x);
+      case 4: return BatchLUSolve<4>(n, nk, lu, p, x);
+      case 8: return BatchLUSolve<8>(n, nk, lu, p, x);
+      case 9: return BatchLUSolve<9>(n, nk, lu, p, x);
+      case 16: return BatchLUSolve<16>(n, nk, lu, p, x);
+      case 27: return BatchLUSolve<27>(n, nk, lu, p, x);
+   }
+   BatchLUSolve<0>(n, nk, lu, p, x);
+}
+
+template <int N>
+static void BatchCholeskyFactor(const int n, const int nk, double *A)
+{
+   DeviceVector d_A(A, n*n*nk);
+   MFEM_FORALL(k, nk, BatchCholeskyFactorKernel<N>(n, &d_A[k*n*n]););
+}
+
+void BatchCholeskyFactor(DenseTensor &A)
+{
+   const int n = A.SizeI(), nk = A.SizeK();
+   MFEM_VERIFY(A.SizeJ() == n, "the matrices must be square");
+   double *a = A.Data();
+   switch (n)
+   {
+      case 2: return BatchCholeskyFactor<2>(n, nk, a);
+      case 3: return BatchCholeskyFactor<3>(n, nk, a);
+      case 4: return BatchCholeskyFactor<4>(n, nk, a);
+      case 8: return BatchCholeskyFactor<8>(n, nk, a);
+      case 9: return BatchCholeskyFactor<9>(n, nk, a);
+      case 16: return BatchCholeskyFactor<16>(n, nk, a);
+      case 27: return BatchCholeskyFactor<27>(n, nk, a);
+   }
+   BatchCholeskyFactor<0>(n, nk, a);
+}
+
+template <int N>
+static void BatchCholeskySolve(const int n, const int nk, const double *L,
+                               double *X)
+{
+   const DeviceVector d_L(L, n*n*nk);
+   DeviceVector d_X(X, n*nk);
+   MFEM_FORALL(k, nk,
+               BatchCholeskySolveKernel<N>(n, &d_L[k*n*n], &d_X[k*n]););
+}
+
+void BatchCholeskySolve(const DenseTensor &L, Vector &X)
+{
+   const int n = L.SizeI(), nk = L.SizeK();
+   MFEM_VERIFY(L.SizeJ() == n && X.Size() == n*nk, "incompatible sizes");
+   const double *l = L.Data();
+   double *x = X.GetData();
+   switch (n)
+   {
+      case 2: return BatchCholeskySolve<2>(n, nk, l, x);
+      case 3: return BatchCholeskySolve<3>(n, nk, l, x);
+      case 4: return BatchCholeskySolve<4>(n, nk, l, x);
+      case 8: return BatchCholeskySolve<8>(n, nk, l, x);
+      case 9: return BatchCholeskySolve<9>(n, nk, l, x);
+      case 16: return BatchCholeskySolve<16>(n, nk, l, x);
+      case 27: return BatchCholeskySolve<27>(n, nk, l, x);
+   }
+   BatchCholeskySolve<0>(n, nk, l, x);
+}
+
+template <int N>
+static void BatchInverse(const int n, const int nk, double *A)
+{
+   DeviceVector d_A(A, n*n*nk);
+   MFEM_FORALL(k, nk, BatchInverseKernel<N>(n, &d_A[k*n*n]););
+}
+
+void BatchInverse(DenseTensor &A)
+{
+   const int n = A.SizeI(), nk = A.SizeK();
+   MFEM_VERIFY(A.SizeJ() == n, "the matrices must be square");
+   MFEM_VERIFY(n <= batch_max_size, "the matrices are too large: "
+               << n << " > " << batch_max_size);
+   double *a = A.Data();
+   switch (n)
+   {
+      case 2: return BatchInverse<2>(n, nk, a);
+      case 3: return BatchInverse<3>(n, nk, a);
+      case 4: return BatchInverse<4>(n, nk, a);
+      case 8: return BatchInverse<8>(n, nk, a);
+      case 9: return BatchInverse<9>(n, nk, a);
+      case 16: return BatchInverse<16>(n, nk, a);
+      case 27: return BatchInverse<27>(n, nk, a);
+   }
+   BatchInverse<0>(n, nk, a);
+}
+
 }
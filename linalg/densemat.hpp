@@ -218,6 +218,9 @@ public:
    double FNorm2() const { double s, n2; FNorm(s, n2); return s*s*n2; }
 
    /// Compute eigenvalues of A x = ev x where A = *this
+   /** The matrix must be symmetric and the eigenvalues are in ascending
+       order. Without LAPACK, the cyclic Jacobi method is used, which is
+       intended for small matrices. */
    void Eigenvalues(Vector &ev)
    { Eigensystem(ev); }
 
@@ -748,6 +751,49 @@ public:
 };
 
 
+/** @name Batched dense linear algebra
+
+    These functions apply the same operation to all matrices A(k) of a
+    DenseTensor, e.g. the element matrices of a mesh. The loop over the batch
+    is an MFEM_FORALL, so it is threaded with the OpenMP backend and runs on
+    the device with the CUDA backend. The kernels for one matrix access the
+    column-major data with stride one in the innermost loops, and have
+    specialized versions for the common element sizes 2, 3, 4, 8, 9, 16 and
+    27, in which the size is a compile-time constant. */
+///@{
+
+/// Compute C(k) = A(k) B(k) for all k. @a C is resized if necessary.
+void BatchMult(const DenseTensor &A, const DenseTensor &B, DenseTensor &C);
+
+/** @brief Compute the LU factorizations with partial pivoting L.U = P.A(k) of
+    the square matrices A(k) in place. */
+/** The pivots of A(k) are stored in P[k*n],...,P[k*n+n-1] (zero-based), see
+    LUFactors. The matrices must be nonsingular. */
+void BatchLUFactor(DenseTensor &A, Array<int> &P);
+
+/** @brief Solve A(k) x(k) = b(k) for all k, given the factorizations from
+    BatchLUFactor(). The vectors b(k) are stored consecutively in @a X and are
+    overwritten by the solutions x(k). */
+void BatchLUSolve(const DenseTensor &LU, const Array<int> &P, Vector &X);
+
+/** @brief Compute the Cholesky factorizations A(k) = L(k) L(k)^T of the
+    symmetric positive definite matrices A(k) in place. */
+/** The factors L(k) overwrite the lower triangles of A(k); the strict upper
+    triangles are not referenced. */
+void BatchCholeskyFactor(DenseTensor &A);
+
+/** @brief Solve A(k) x(k) = b(k) for all k, given the factorizations from
+    BatchCholeskyFactor(), see BatchLUSolve(). */
+void BatchCholeskySolve(const DenseTensor &L, Vector &X);
+
+/** @brief Replace the square matrices A(k) with their inverses, using
+    Gauss-Jordan elimination with partial pivoting. */
+/** The size of the matrices is limited to 256. */
+void BatchInverse(DenseTensor &A);
+
+///@}
+
+
 // Inline methods
 
 inline double &DenseMatrix::operator()(int i, int j)
@@ -0,0 +1,396 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of incomplete factorization preconditioners
+
+#include "ilu.hpp"
+#include "../general/device.hpp"
+#include "../general/sort_pairs.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <queue>
+
+namespace mfem
+{
+
+using namespace std;
+
+void IncompleteLUSolver::SetOperator(const Operator &a)
+{
+   oper = dynamic_cast<const SparseMatrix*>(&a);
+   if (oper == NULL)
+   {
+      mfem_error("IncompleteLUSolver::SetOperator : not a SparseMatrix!");
+   }
+   MFEM_VERIFY(oper->Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(oper->Height() == oper->Width(),
+               "the SparseMatrix must be square");
+   height = width = oper->Height();
+
+   if (Factorize()) { BuildLevels(); }
+}
+
+bool IncompleteLUSolver::CopyMatrix()
+{
+   const int n = height;
+   const int *aI = oper->GetI(), *aJ = oper->GetJ();
+   const double *aA = oper->GetData();
+   const int nnz = aI[n];
+
+   const bool new_pattern =
+      (a_I.Size() != n+1 || a_J.Size() != nnz ||
+       memcmp(a_I.GetData(), aI, (n+1)*sizeof(int)) != 0 ||
+       memcmp(a_J.GetData(), aJ, nnz*sizeof(int)) != 0);
+   if (new_pattern)
+   {
+      a_I.SetSize(n+1);
+      a_J.SetSize(nnz);
+      memcpy(a_I.GetData(), aI, (n+1)*sizeof(int));
+      memcpy(a_J.GetData(), aJ, nnz*sizeof(int));
+
+      // Sort the columns of every row, remembering the original positions.
+      a_I.Copy(I);
+      J.SetSize(nnz);
+      a_pos.SetSize(nnz);
+      diag_pos.SetSize(n);
+      Array<Pair<int,int> > row;
+      for (int i = 0; i < n; i++)
+      {
+         row.SetSize(aI[i+1] - aI[i]);
+         for (int k = 0; k < row.Size(); k++)
+         {
+            row[k].one = aJ[aI[i]+k];
+            row[k].two = aI[i]+k;
+         }
+         row.Sort();
+         diag_pos[i] = -1;
+         for (int k = 0; k < row.Size(); k++)
+         {
+            J[aI[i]+k] = row[k].one;
+            a_pos[aI[i]+k] = row[k].two;
+            if (row[k].one == i) { diag_pos[i] = aI[i]+k; }
+         }
+         MFEM_VERIFY(diag_pos[i] >= 0, "missing diagonal entry in row " << i);
+      }
+   }
+
+   LU.SetSize(nnz);
+   for (int k = 0; k < nnz; k++) { LU(k) = aA[a_pos[k]]; }
+   inv_diag.SetSize(n);
+   return new_pattern;
+}
+
+// Group the rows by level: the level of a row is one more than the maximal
+// level of the rows in the range [begin[i], end[i]) of the row.
+static void LevelSchedule(int n, const int *J, const int *begin,
+                          const int *end, bool forward,
+                          Array<int> &offsets, Array<int> &rows)
+{
+   Array<int> level(n);
+   int num_levels = 0;
+   for (int ii = 0; ii < n; ii++)
+   {
+      const int i = forward ? ii : n-1-ii;
+      int l = 0;
+      for (int k = begin[i]; k < end[i]; k++)
+      {
+         l = std::max(l, level[J[k]] + 1);
+      }
+      level[i] = l;
+      num_levels = std::max(num_levels, l + 1);
+   }
+   offsets.SetSize(num_levels+1);
+   offsets = 0;
+   for (int i = 0; i < n; i++) { offsets[level[i]+1]++; }
+   offsets.PartialSum();
+   Array<int> pos(num_levels);
+   for (int l = 0; l < num_levels; l++) { pos[l] = offsets[l]; }
+   rows.SetSize(n);
+   for (int i = 0; i < n; i++) { rows[pos[level[i]]++] = i; }
+}
+
+void IncompleteLUSolver::BuildLevels()
+{
+   const int n = height;
+   Array<int> upper_begin(n);
+   for (int i = 0; i < n; i++) { upper_begin[i] = diag_pos[i] + 1; }
+   LevelSchedule(n, J, I, diag_pos, true, fw_offsets, fw_rows);
+   LevelSchedule(n, J, upper_begin, I.GetData() + 1, false,
+                 bw_offsets, bw_rows);
+}
+
+void IncompleteLUSolver::Mult(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(x.Size() == width && y.Size() == height,
+               "invalid vector sizes");
+
+   const int *Ip = I, *Jp = J, *dp = diag_pos;
+   const double *A = LU.GetData(), *dinv = inv_diag.GetData();
+   const double *xp = x.GetData();
+   double *yp = y.GetData();
+#ifdef MFEM_USE_OPENMP
+   const bool use_omp = Device::AllowsHostOpenMP();
+#endif
+
+   // Forward solve L z = x, with z stored in y.
+   for (int l = 0; l < fw_offsets.Size() - 1; l++)
+   {
+      const int *rows = fw_rows.GetData();
+      const int begin = fw_offsets[l], end = fw_offsets[l+1];
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for if (use_omp && end - begin > 64)
+#endif
+      for (int p = begin; p < end; p++)
+      {
+         const int i = rows[p];
+         double s = xp[i];
+         for (int k = Ip[i]; k < dp[i]; k++)
+         {
+            s -= A[k] * yp[Jp[k]];
+         }
+         yp[i] = s;
+      }
+   }
+
+   // Backward solve U y = z.
+   for (int l = 0; l < bw_offsets.Size() - 1; l++)
+   {
+      const int *rows = bw_rows.GetData();
+      const int begin = bw_offsets[l], end = bw_offsets[l+1];
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for if (use_omp && end - begin > 64)
+#endif
+      for (int p = begin; p < end; p++)
+      {
+         const int i = rows[p];
+         double s = yp[i];
+         for (int k = dp[i] + 1; k < Ip[i+1]; k++)
+         {
+            s -= A[k] * yp[Jp[k]];
+         }
+         yp[i] = s * dinv[i];
+      }
+   }
+}
+
+
+bool ILU0Solver::Factorize()
+{
+   const bool new_pattern = CopyMatrix();
+   const int n = height;
+
+   // IKJ variant of Gaussian elimination restricted to the pattern of A.
+   Array<int> pos(n);
+   pos = -1;
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++) { pos[J[k]] = k; }
+      for (int k = I[i]; k < diag_pos[i]; k++)
+      {
+         const int c = J[k];
+         const double lik = (LU(k) *= inv_diag(c));
+         for (int q = diag_pos[c] + 1; q < I[c+1]; q++)
+         {
+            const int kj = pos[J[q]];
+            if (kj >= 0) { LU(kj) -= lik * LU(q); }
+         }
+      }
+      const double d = LU(diag_pos[i]);
+      MFEM_VERIFY(d != 0.0, "zero pivot in row " << i);
+      inv_diag(i) = 1.0 / d;
+      for (int k = I[i]; k < I[i+1]; k++) { pos[J[k]] = -1; }
+   }
+   return new_pattern;
+}
+
+
+bool IC0Solver::Factorize()
+{
+   const bool new_pattern = CopyMatrix();
+   const int n = height;
+
+   // Right-looking IC(0) on the upper triangle: row k of R is computed and
+   // then used to update the upper parts of the rows j > k in its pattern.
+   Array<int> pos(n);
+   pos = -1;
+   for (int k = 0; k < n; k++)
+   {
+      const double d = LU(diag_pos[k]);
+      MFEM_VERIFY(d > 0.0, "IC(0) breakdown in row " << k
+                  << ": the matrix is not positive definite");
+      const double rkk = sqrt(d);
+      LU(diag_pos[k]) = rkk;
+      const int end = I[k+1];
+      for (int q = diag_pos[k] + 1; q < end; q++) { LU(q) /= rkk; }
+      for (int q = diag_pos[k] + 1; q < end; q++)
+      {
+         const int j = J[q];
+         const double rkj = LU(q);
+         for (int t = diag_pos[j]; t < I[j+1]; t++) { pos[J[t]] = t; }
+         for (int t = q; t < end; t++)
+         {
+            const int jl = pos[J[t]];
+            if (jl >= 0) { LU(jl) -= rkj * LU(t); }
+         }
+         for (int t = diag_pos[j]; t < I[j+1]; t++) { pos[J[t]] = -1; }
+      }
+   }
+
+   // Write A ~ R^T R = L U with L = (D^{-1} R)^T and U = D R, D = diag(R).
+   for (int k = 0; k < n; k++)
+   {
+      const double rkk = LU(diag_pos[k]);
+      for (int q = diag_pos[k] + 1; q < I[k+1]; q++)
+      {
+         const int j = J[q];
+         const int *row = J.GetData() + I[j];
+         const int *lkj = std::lower_bound(row, row + (diag_pos[j] - I[j]), k);
+         MFEM_VERIFY(lkj < row + (diag_pos[j] - I[j]) && *lkj == k,
+                     "the sparsity pattern must be symmetric");
+         LU(lkj - J.GetData()) = LU(q) / rkk;
+      }
+   }
+   for (int k = 0; k < n; k++)
+   {
+      const double rkk = LU(diag_pos[k]);
+      for (int q = diag_pos[k] + 1; q < I[k+1]; q++) { LU(q) *= rkk; }
+      LU(diag_pos[k]) = rkk * rkk;
+      inv_diag(k) = 1.0 / (rkk * rkk);
+   }
+   return new_pattern;
+}
+
+
+bool ILUTSolver::Factorize()
+{
+   const int n = height;
+   const int *aI = oper->GetI(), *aJ = oper->GetJ();
+   const double *aA = oper->GetData();
+
+   Array<int> fI(n+1), fJ, diag;
+   Array<double> fA;
+   fI[0] = 0;
+   diag.SetSize(n);
+   inv_diag.SetSize(n);
+
+   // Dense work row w with the list of its nonzero columns; the columns of the
+   // L part are processed in increasing order using a min-heap.
+   Vector w(n);
+   w = 0.0;
+   Array<bool> used(n);
+   used = false;
+   Array<int> cols;
+   Array<Pair<double,int> > lower, upper;
+   Array<Pair<int,double> > row;
+   priority_queue<int, vector<int>, greater<int> > heap;
+
+   for (int i = 0; i < n; i++)
+   {
+      double norm = 0.0;
+      cols.SetSize(0);
+      for (int k = aI[i]; k < aI[i+1]; k++)
+      {
+         const int j = aJ[k];
+         norm += aA[k] * aA[k];
+         if (!used[j])
+         {
+            used[j] = true;
+            cols.Append(j);
+            if (j < i) { heap.push(j); }
+         }
+         w(j) += aA[k];
+      }
+      norm = sqrt(norm);
+      const double thr = tau * norm;
+
+      while (!heap.empty())
+      {
+         const int c = heap.top();
+         heap.pop();
+         const double wc = w(c) * inv_diag(c);
+         w(c) = wc;
+         if (fabs(wc) < thr || wc == 0.0) { w(c) = 0.0; continue; }
+         for (int q = diag[c] + 1; q < fI[c+1]; q++)
+         {
+            const int j = fJ[q];
+            if (!used[j])
+            {
+               used[j] = true;
+               cols.Append(j);
+               if (j < i) { heap.push(j); }
+            }
+            w(j) -= wc * fA[q];
+         }
+      }
+
+      // Keep the p largest entries above the threshold in each of L and U.
+      lower.SetSize(0);
+      upper.SetSize(0);
+      for (int t = 0; t < cols.Size(); t++)
+      {
+         const int j = cols[t];
+         const double wj = w(j);
+         if (j == i || fabs(wj) < thr || wj == 0.0) { continue; }
+         Array<Pair<double,int> > &part = (j < i) ? lower : upper;
+         part.Append(Pair<double,int>(-fabs(wj), j));
+      }
+      double d = w(i);
+      if (d == 0.0) { d = (norm > 0.0) ? (1e-4 + tau) * norm : 1.0; }
+
+      for (int part = 0; part < 2; part++)
+      {
+         Array<Pair<double,int> > &ent = (part == 0) ? lower : upper;
+         if (ent.Size() > p)
+         {
+            std::nth_element(ent.GetData(), ent.GetData() + p,
+                             ent.GetData() + ent.Size());
+            ent.SetSize(p);
+         }
+         row.SetSize(ent.Size());
+         for (int t = 0; t < ent.Size(); t++)
+         {
+            row[t].one = ent[t].two;
+            row[t].two = w(ent[t].two);
+         }
+         SortPairs<int,double>(row, row.Size());
+         if (part == 1)
+         {
+            diag[i] = fJ.Size();
+            fJ.Append(i);
+            fA.Append(d);
+            inv_diag(i) = 1.0 / d;
+         }
+         for (int t = 0; t < row.Size(); t++)
+         {
+            fJ.Append(row[t].one);
+            fA.Append(row[t].two);
+         }
+      }
+      fI[i+1] = fJ.Size();
+
+      for (int t = 0; t < cols.Size(); t++)
+      {
+         w(cols[t]) = 0.0;
+         used[cols[t]] = false;
+      }
+   }
+
+   fI.Copy(I);
+   fJ.Copy(J);
+   diag.Copy(diag_pos);
+   LU.SetSize(fA.Size());
+   for (int k = 0; k < fA.Size(); k++) { LU(k) = fA[k]; }
+   return true;
+}
+
+}
@@ -0,0 +1,150 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_ILU
+#define MFEM_ILU
+
+// Incomplete factorization preconditioners for sparse matrices
+
+#include "../config/config.hpp"
+#include "sparsemat.hpp"
+#include "solvers.hpp"
+#include <algorithm>
+
+namespace mfem
+{
+
+/** @brief Abstract base class for incomplete LU-type factorizations
+    A ~ L U of a SparseMatrix, used as preconditioners. */
+/** The factors are stored in a single CSR structure with sorted columns: the
+    strictly lower part holds L (which has unit diagonal), while the diagonal
+    and the strictly upper part hold U.
+
+    The triangular solves in Mult() are level-scheduled: the rows are grouped
+    in levels such that the rows of one level depend only on rows of previous
+    levels. With the "omp" backend, the rows of each level are processed by
+    all threads in parallel. */
+class IncompleteLUSolver : public Solver
+{
+protected:
+   const SparseMatrix *oper;
+
+   /// @name The factors L and U in CSR format with sorted columns.
+   ///@{
+   Array<int> I, J;
+   /// Position of the diagonal entry of each row in #J and #LU.
+   Array<int> diag_pos;
+   Vector LU;
+   /// Inverse of the diagonal of U.
+   Vector inv_diag;
+   ///@}
+
+   /// @name Level scheduling of the forward (L) and backward (U) solves.
+   /** The rows of level l are rows[offsets[l]...offsets[l+1]). */
+   ///@{
+   Array<int> fw_offsets, fw_rows, bw_offsets, bw_rows;
+   ///@}
+
+   /// @name Copy of the sparsity pattern of the last factored matrix.
+   ///@{
+   Array<int> a_I, a_J;
+   /// Position in the matrix of every entry of the sorted pattern #J.
+   Array<int> a_pos;
+   ///@}
+
+   /** @brief Copy the matrix into #LU, with the (sorted) pattern of the
+       matrix. Returns true if the pattern is different from the one of the
+       previously factored matrix. */
+   bool CopyMatrix();
+
+   /// Compute the levels of the forward and backward solves.
+   void BuildLevels();
+
+   /** @brief Compute the factorization of #oper. Returns true if the pattern
+       of the factors changed, i.e. the levels have to be recomputed. */
+   virtual bool Factorize() = 0;
+
+public:
+   IncompleteLUSolver() : oper(NULL) { }
+
+   /** @brief Set the (finalized, square) SparseMatrix and compute its
+       factorization. */
+   /** If the sparsity pattern of @a a is the same as the one of the previous
+       matrix (e.g. when only the values changed), the symbolic data is
+       reused. */
+   virtual void SetOperator(const Operator &a);
+
+   /// Solve L U y = x.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// Returns the number of nonzeros stored in the factors.
+   int NumNonZeroElems() const { return J.Size(); }
+
+   /// Returns the number of levels of the forward and backward solves.
+   int GetNumLevels() const
+   { return std::max(fw_offsets.Size(), bw_offsets.Size()) - 1; }
+};
+
+
+/// Incomplete LU factorization without fill-in, ILU(0).
+/** The factors have the same sparsity pattern as the matrix. */
+class ILU0Solver : public IncompleteLUSolver
+{
+protected:
+   virtual bool Factorize();
+
+public:
+   ILU0Solver() { }
+
+   ILU0Solver(const SparseMatrix &a) { SetOperator(a); }
+};
+
+
+/** @brief Incomplete Cholesky factorization without fill-in, IC(0), for
+    symmetric positive definite matrices. */
+/** The factorization A ~ R^T R uses only the upper triangle of the matrix
+    and gives a symmetric preconditioner for PCG. The matrix must have a
+    symmetric sparsity pattern. */
+class IC0Solver : public IncompleteLUSolver
+{
+protected:
+   virtual bool Factorize();
+
+public:
+   IC0Solver() { }
+
+   IC0Solver(const SparseMatrix &a) { SetOperator(a); }
+};
+
+
+/// Incomplete LU factorization with threshold dropping, ILUT(tau, p).
+/** In row i, the entries smaller than @a tau times the l2-norm of row i of the
+    matrix are dropped, and only the @a p largest entries in each of the L and
+    U parts are kept. A zero pivot is replaced by (1e-4 + @a tau) times the
+    norm of the row. */
+class ILUTSolver : public IncompleteLUSolver
+{
+protected:
+   double tau;
+   int p;
+
+   virtual bool Factorize();
+
+public:
+   ILUTSolver(double tau_ = 1e-3, int p_ = 20) : tau(tau_), p(p_) { }
+
+   ILUTSolver(const SparseMatrix &a, double tau_ = 1e-3, int p_ = 20)
+      : tau(tau_), p(p_) { SetOperator(a); }
+};
+
+}
+
+#endif
@@ -20,12 +20,18 @@
 #include "sparsemat.hpp"
 #include "complex_operator.hpp"
 #include "blockvector.hpp"
+#include "multivector.hpp"
 #include "blockmatrix.hpp"
 #include "blockoperator.hpp"
 #include "sparsesmoothers.hpp"
+#include "bsrmat.hpp"
+#include "symsparsemat.hpp"
+#include "ilu.hpp"
+#include "amg.hpp"
 #include "densemat.hpp"
 #include "ode.hpp"
 #include "solvers.hpp"
+#include "sparsechol.hpp"
 #include "handle.hpp"
 #include "invariants.hpp"
 
@@ -0,0 +1,112 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "multivector.hpp"
+#include "../general/device.hpp"
+
+#include <algorithm>
+
+namespace mfem
+{
+
+// The kernels process the rows in blocks, so that the blocks of all vectors
+// stay in cache while they are combined.
+static const int multivector_block = 256;
+
+void MultiVector::InnerProducts(const MultiVector &Y, DenseMatrix &G) const
+{
+   MFEM_VERIFY(vsize == Y.vsize, "incompatible vector sizes");
+   const int p = nvec, q = Y.nvec;
+   G.SetSize(p, q);
+   if (Device::Allows(Backend::CUDA_MASK))
+   {
+      Vector x, y;
+      for (int j = 0; j < q; j++)
+      {
+         Y.GetVectorView(j, y);
+         for (int i = 0; i < p; i++)
+         {
+            GetVectorView(i, x);
+            G(i,j) = x * y;
+         }
+      }
+      return;
+   }
+   G = 0.0;
+   for (int k0 = 0; k0 < vsize; k0 += multivector_block)
+   {
+      const int k1 = std::min(k0 + multivector_block, vsize);
+      for (int j = 0; j < q; j++)
+      {
+         const double *yd = Y.GetVectorData(j);
+         for (int i = 0; i < p; i++)
+         {
+            const double *xd = GetVectorData(i);
+            double d = 0.0;
+            for (int k = k0; k < k1; k++) { d += xd[k] * yd[k]; }
+            G(i,j) += d;
+         }
+      }
+   }
+}
+
+void MultiVector::Dots(const MultiVector &Y, Vector &d) const
+{
+   MFEM_VERIFY(vsize == Y.vsize && nvec == Y.nvec,
+               "incompatible multivectors");
+   d.SetSize(nvec);
+   Vector x, y;
+   for (int j = 0; j < nvec; j++)
+   {
+      GetVectorView(j, x);
+      Y.GetVectorView(j, y);
+      d(j) = x * y;
+   }
+}
+
+void MultiVector::AddMult(const MultiVector &X, const DenseMatrix &C,
+                          double a)
+{
+   MFEM_VERIFY(vsize == X.vsize && C.Height() == X.nvec && C.Width() == nvec,
+               "incompatible sizes");
+   const int p = X.nvec;
+   if (Device::Allows(Backend::CUDA_MASK))
+   {
+      Vector x, y;
+      for (int j = 0; j < nvec; j++)
+      {
+         GetVectorView(j, y);
+         for (int i = 0; i < p; i++)
+         {
+            X.GetVectorView(i, x);
+            y.Add(a * C(i,j), x);
+         }
+      }
+      return;
+   }
+   for (int k0 = 0; k0 < vsize; k0 += multivector_block)
+   {
+      const int k1 = std::min(k0 + multivector_block, vsize);
+      for (int j = 0; j < nvec; j++)
+      {
+         double *yd = GetVectorData(j);
+         for (int i = 0; i < p; i++)
+         {
+            const double *xd = X.GetVectorData(i);
+            const double c = a * C(i,j);
+            if (c == 0.0) { continue; }
+            for (int k = k0; k < k1; k++) { yd[k] += c * xd[k]; }
+         }
+      }
+   }
+}
+
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_MULTIVECTOR
+#define MFEM_MULTIVECTOR
+
+#include "../config/config.hpp"
+#include "vector.hpp"
+#include "densemat.hpp"
+
+namespace mfem
+{
+
+/** @brief A set of vectors of the same size, e.g. the solutions for several
+    right-hand sides. */
+/** All data is contained in Vector::data: vector j occupies the entries
+    j*VectorSize(),...,(j+1)*VectorSize()-1, i.e. the layout is the same as
+    the one of a column-major DenseMatrix with one column per vector.
+
+    Operators act on all vectors at once with Operator::BatchMult(). */
+class MultiVector : public Vector
+{
+protected:
+   /// Size of each vector.
+   int vsize;
+   /// Number of vectors.
+   int nvec;
+
+public:
+   MultiVector() : vsize(0), nvec(0) { }
+
+   /// Create @a nvec_ vectors of size @a vsize_.
+   MultiVector(int vsize_, int nvec_)
+      : Vector(vsize_*nvec_), vsize(vsize_), nvec(nvec_) { }
+
+   /// View constructor, the data array is not owned.
+   MultiVector(double *data_, int vsize_, int nvec_)
+      : Vector(data_, vsize_*nvec_), vsize(vsize_), nvec(nvec_) { }
+
+   /// Resize to @a nvec_ vectors of size @a vsize_, see Vector::SetSize().
+   void SetSize(int vsize_, int nvec_)
+   { Vector::SetSize(vsize_*nvec_); vsize = vsize_; nvec = nvec_; }
+
+   /// Set all entries equal to @a value.
+   MultiVector &operator=(double value)
+   { Vector::operator=(value); return *this; }
+
+   /// Size of each vector.
+   int VectorSize() const { return vsize; }
+
+   /// Number of vectors.
+   int NumVectors() const { return nvec; }
+
+   /// Pointer to the data of vector @a j.
+   double *GetVectorData(int j) { return data + j*vsize; }
+   /// Pointer to the data of vector @a j (const version).
+   const double *GetVectorData(int j) const { return data + j*vsize; }
+
+   /** @brief Make @a v a view of vector @a j. The data is not copied, so
+       writing into @a v modifies this MultiVector. */
+   void GetVectorView(int j, Vector &v) const
+   { v.NewDataAndSize(data + j*vsize, vsize); }
+
+   /// Compute the local inner products G(i,j) = (X_i, Y_j) with X = *this.
+   /** All pairs are computed in a single pass over the data. */
+   void InnerProducts(const MultiVector &Y, DenseMatrix &G) const;
+
+   /// Compute the local inner products d(j) = (X_j, Y_j) with X = *this.
+   void Dots(const MultiVector &Y, Vector &d) const;
+
+   /** @brief Add the linear combinations @a a X C to *this, i.e. add
+       @a a sum_i C(i,j) X_i to vector j. */
+   void AddMult(const MultiVector &X, const DenseMatrix &C, double a = 1.0);
+};
+
+}
+
+#endif
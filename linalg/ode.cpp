@@ -11,6 +11,11 @@
 
 #include "operator.hpp"
 #include "ode.hpp"
+#include "dtensor.hpp"
+#include "../general/forall.hpp"
+
+#include <algorithm>
+#include <cmath>
 
 namespace mfem
 {
@@ -338,6 +343,179 @@ const double RK8Solver::c[] =
 };
 
 
+void LowStorageRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   k.SetSize(n);
+   dxdt.SetSize(n);
+}
+
+// Fused stage update of the 2N-storage methods: k = a k + dt F, x += b k.
+static void LowStorageUpdate(const double a, const double dt, const double b,
+                             const Vector &F, Vector &k, Vector &x)
+{
+   const int N = x.Size();
+   const DeviceVector d_F(F, N);
+   DeviceVector d_k(k, N);
+   DeviceVector d_x(x, N);
+   if (a == 0.0)
+   {
+      MFEM_FORALL(i, N,
+      {
+         const double ki = dt * d_F[i];
+         d_k[i] = ki;
+         d_x[i] += b * ki;
+      });
+   }
+   else
+   {
+      MFEM_FORALL(i, N,
+      {
+         const double ki = a * d_k[i] + dt * d_F[i];
+         d_k[i] = ki;
+         d_x[i] += b * ki;
+      });
+   }
+}
+
+void LowStorageRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   for (int i = 0; i < s; i++)
+   {
+      f->SetTime(t + c[i]*dt);
+      f->Mult(x, dxdt);
+      // k = 0 before the first stage
+      LowStorageUpdate((i == 0) ? 0.0 : A[i], dt, B[i], dxdt, k, x);
+   }
+   t += dt;
+}
+
+const double LowStorageRK3Solver::A[] = { 0., -5./9, -153./128 };
+const double LowStorageRK3Solver::B[] = { 1./3, 15./16, 8./15 };
+const double LowStorageRK3Solver::c[] = { 0., 1./3, 3./4 };
+
+const double LowStorageRK4Solver::A[] =
+{
+   0.,
+   -567301805773./1357537059087,
+   -2404267990393./2016746695238,
+   -3550918686646./2091501179385,
+   -1275806237668./842570457699
+};
+const double LowStorageRK4Solver::B[] =
+{
+   1432997174477./9575080441755,
+   5161836677717./13612068292357,
+   1720146321549./2090206949498,
+   3134564353537./4481467310338,
+   2277821191437./14882151754819
+};
+const double LowStorageRK4Solver::c[] =
+{
+   0.,
+   1432997174477./9575080441755,
+   2526269341429./6820363962896,
+   2006345519317./3224310063776,
+   2802321613138./2924317926251
+};
+
+
+LowStorageSSPRKSolver::LowStorageSSPRKSolver(int _order, int _s)
+   : order(_order), s(_s)
+{
+   const int n = (int) std::floor(std::sqrt(double(s)) + 0.5);
+   MFEM_VERIFY((order == 2 && s >= 2) || (order == 3 && n >= 2 && n*n == s) ||
+               (order == 4 && s == 10),
+               "unsupported SSP method: order " << order << ", " << s
+               << " stages");
+}
+
+double LowStorageSSPRKSolver::GetSSPCoefficient() const
+{
+   switch (order)
+   {
+      case 2: return s - 1;
+      case 3: return s - std::sqrt(double(s));
+      default: return 6.0;
+   }
+}
+
+void LowStorageSSPRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   int n = f->Width();
+   q.SetSize(n);
+   dxdt.SetSize(n);
+}
+
+void LowStorageSSPRKSolver::EulerStage(Vector &x, double &tx, double h)
+{
+   f->SetTime(tx);
+   f->Mult(x, dxdt);
+   x.Add(h, dxdt);
+   tx += h;
+}
+
+void LowStorageSSPRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   // The solution x is the first register, q the second one. Their times tx
+   // and tq follow the linear combinations of the stages.
+   const double h = dt / GetSSPCoefficient();
+   double tx = t, tq = t;
+   if (order == 2)
+   {
+      q = x;
+      for (int i = 1; i < s; i++) { EulerStage(x, tx, h); }
+      // x = ((s-1) (x + h f(x)) + q) / s
+      f->SetTime(tx);
+      f->Mult(x, dxdt);
+      AddAndDot(1.0/s, q, (s-1)*h/s, dxdt, (s-1.0)/s, x);
+   }
+   else if (order == 3)
+   {
+      const int n = (int) std::floor(std::sqrt(double(s)) + 0.5);
+      int i = 1;
+      for ( ; i <= (n-1)*(n-2)/2; i++) { EulerStage(x, tx, h); }
+      q = x;
+      tq = tx;
+      for ( ; i <= n*(n+1)/2 - 1; i++) { EulerStage(x, tx, h); }
+      // x = (n q + (n-1) (x + h f(x))) / (2n-1)
+      f->SetTime(tx);
+      f->Mult(x, dxdt);
+      const double w = 1.0/(2*n-1);
+      AddAndDot(n*w, q, (n-1)*h*w, dxdt, (n-1)*w, x);
+      tx = (n*tq + (n-1)*(tx + h))*w;
+      for (i++ ; i <= s; i++) { EulerStage(x, tx, h); }
+   }
+   else
+   {
+      q = x;
+      for (int i = 1; i <= 5; i++) { EulerStage(x, tx, h); }
+      // q = q/25 + 9 x/25,  x = 15 q - 5 x
+      {
+         const int N = x.Size();
+         DeviceVector d_q(q, N);
+         DeviceVector d_x(x, N);
+         MFEM_FORALL(i, N,
+         {
+            const double qi = (d_q[i] + 9.0 * d_x[i]) / 25.0;
+            d_q[i] = qi;
+            d_x[i] = 15.0 * qi - 5.0 * d_x[i];
+         });
+         tq = (tq + 9.0*tx)/25.0;
+         tx = 15.0*tq - 5.0*tx;
+      }
+      for (int i = 6; i <= 9; i++) { EulerStage(x, tx, h); }
+      // x = q + 3/5 x + h/10 f(x), with h = dt/6
+      f->SetTime(tx);
+      f->Mult(x, dxdt);
+      AddAndDot(1.0, q, dt/10, dxdt, 0.6, x);
+   }
+   t += dt;
+}
+
+
 void BackwardEulerSolver::Init(TimeDependentOperator &_f)
 {
    ODESolver::Init(_f);
@@ -486,6 +664,477 @@ void SDIRK33Solver::Step(Vector &x, double &t, double &dt)
 }
 
 
+ODEController::ODEController()
+   : rel_tol(1e-4), abs_tol(1e-8), safety(0.9), min_factor(0.2),
+     max_factor(5.0), norm_type(RMS_NORM)
+{
+#ifdef MFEM_USE_MPI
+   parallel = 0;
+#endif
+}
+
+#ifdef MFEM_USE_MPI
+ODEController::ODEController(MPI_Comm comm_)
+   : rel_tol(1e-4), abs_tol(1e-8), safety(0.9), min_factor(0.2),
+     max_factor(5.0), norm_type(RMS_NORM)
+{
+   parallel = 1;
+   comm = comm_;
+}
+#endif
+
+double ODEController::ErrorNorm(const Vector &err, const Vector &x0,
+                                const Vector &x1) const
+{
+   const int n = err.Size();
+   const double *e = err.GetData(), *y0 = x0.GetData(), *y1 = x1.GetData();
+   // sum[0] is the sum of squares (or the maximum), sum[1] the size
+   double sum[2] = { 0.0, double(n) };
+   for (int i = 0; i < n; i++)
+   {
+      const double w = abs_tol + rel_tol*std::max(fabs(y0[i]), fabs(y1[i]));
+      const double r = e[i] / w;
+      if (norm_type == RMS_NORM) { sum[0] += r*r; }
+      else { sum[0] = std::max(sum[0], fabs(r)); }
+   }
+#ifdef MFEM_USE_MPI
+   if (parallel)
+   {
+      if (norm_type == RMS_NORM)
+      {
+         MPI_Allreduce(MPI_IN_PLACE, sum, 2, MPI_DOUBLE, MPI_SUM, comm);
+      }
+      else
+      {
+         MPI_Allreduce(MPI_IN_PLACE, sum, 1, MPI_DOUBLE, MPI_MAX, comm);
+      }
+   }
+#endif
+   if (norm_type == RMS_NORM)
+   {
+      return (sum[1] > 0.0) ? sqrt(sum[0] / sum[1]) : 0.0;
+   }
+   return sum[0];
+}
+
+double ODEController::Accept(double err, double dt, int k)
+{
+   const double factor = AcceptFactor(err, k);
+   return dt * std::min(max_factor, std::max(min_factor, factor));
+}
+
+double ODEController::Reject(double err, double dt, int k)
+{
+   // An error norm which is not finite, e.g. after a blow-up, gives the
+   // largest reduction.
+   double factor = min_factor;
+   if (err < infinity())
+   {
+      factor = std::max(min_factor, safety * pow(err, -1.0/k));
+   }
+   return dt * std::min(factor, safety);
+}
+
+double PIDController::AcceptFactor(double err, int k)
+{
+   // Avoid a division by zero for an exact step.
+   const double e = std::max(err, 1e-10);
+   const double factor = safety * pow(e, -k1/k) * pow(err1, k2/k) *
+                         pow(err2, -k3/k);
+   err2 = err1;
+   err1 = e;
+   return factor;
+}
+
+
+AdaptiveODESolver::AdaptiveODESolver(int est_order_)
+   : controller(new PIController), own_controller(true),
+     est_order(est_order_), dt_next(0.0), dt_min(0.0), dt_max(infinity()),
+     num_accepted(0), num_rejected(0)
+{ }
+
+void AdaptiveODESolver::SetController(ODEController &c, bool own)
+{
+   if (own_controller) { delete controller; }
+   controller = &c;
+   own_controller = own;
+}
+
+void AdaptiveODESolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   x_new.SetSize(f->Width());
+   err.SetSize(f->Width());
+   controller->Reset();
+   num_accepted = num_rejected = 0;
+}
+
+void AdaptiveODESolver::Step(Vector &x, double &t, double &dt,
+                             double &dt_next_)
+{
+   dt = std::min(dt, dt_max);
+   while (true)
+   {
+      TryStep(x, t, dt, x_new, err);
+      const double e = controller->ErrorNorm(err, x, x_new);
+      if (e <= 1.0)
+      {
+         x = x_new;
+         t += dt;
+         AcceptStep();
+         num_accepted++;
+         dt_next = std::min(controller->Accept(e, dt, est_order), dt_max);
+         dt_next_ = dt_next;
+         return;
+      }
+      num_rejected++;
+      dt = controller->Reject(e, dt, est_order);
+      MFEM_VERIFY(dt >= dt_min, "the time step size " << dt << " at time "
+                  << t << " is below the minimum " << dt_min);
+   }
+}
+
+void AdaptiveODESolver::Run(Vector &x, double &t, double &dt, double tf)
+{
+   double h = dt;
+   while (t < tf)
+   {
+      const double rest = tf - t;
+      double h_step = std::min(h, rest), h_next;
+      Step(x, t, h_step, h_next);
+      // End exactly at tf after a step truncated to reach it.
+      if (h_step == rest) { t = tf; }
+      dt = h_step;
+      h = h_next;
+   }
+}
+
+AdaptiveODESolver::~AdaptiveODESolver()
+{
+   if (own_controller) { delete controller; }
+}
+
+// Fused accumulation x += a k, e += b k.
+static void AddStage(const double a, const double b, const Vector &k,
+                     Vector &x, Vector &e)
+{
+   const int N = x.Size();
+   const DeviceVector d_k(k, N);
+   DeviceVector d_x(x, N);
+   DeviceVector d_e(e, N);
+   MFEM_FORALL(i, N,
+   {
+      d_x[i] += a * d_k[i];
+      d_e[i] += b * d_k[i];
+   });
+}
+
+EmbeddedRKSolver::EmbeddedRKSolver(int _s, const double *_a,
+                                   const double *_b, const double *_bh,
+                                   const double *_c, int est_order_,
+                                   bool _fsal)
+   : AdaptiveODESolver(est_order_), s(_s), a(_a), b(_b), bh(_bh), c(_c),
+     fsal(_fsal), k0_valid(false)
+{
+   k = new Vector[s];
+}
+
+void EmbeddedRKSolver::Init(TimeDependentOperator &_f)
+{
+   AdaptiveODESolver::Init(_f);
+   int n = f->Width();
+   y.SetSize(n);
+   for (int i = 0; i < s; i++)
+   {
+      k[i].SetSize(n);
+   }
+   k0_valid = false;
+}
+
+void EmbeddedRKSolver::TryStep(const Vector &x, double t, double dt,
+                               Vector &x1, Vector &e)
+{
+   // The first stage does not depend on dt: it is kept after a rejected
+   // step, and after an accepted one for FSAL methods.
+   if (!k0_valid)
+   {
+      f->SetTime(t);
+      f->Mult(x, k[0]);
+      k0_valid = true;
+   }
+   for (int l = 0, i = 1; i < s; i++)
+   {
+      add(x, a[l++]*dt, k[0], y);
+      for (int j = 1; j < i; j++)
+      {
+         y.Add(a[l++]*dt, k[j]);
+      }
+
+      f->SetTime(t + c[i-1]*dt);
+      f->Mult(y, k[i]);
+   }
+   x1 = x;
+   e = 0.0;
+   for (int i = 0; i < s; i++)
+   {
+      AddStage(b[i]*dt, (b[i] - bh[i])*dt, k[i], x1, e);
+   }
+}
+
+void EmbeddedRKSolver::AcceptStep()
+{
+   if (fsal) { k[0].Swap(k[s-1]); }
+   else { k0_valid = false; }
+}
+
+EmbeddedRKSolver::~EmbeddedRKSolver()
+{
+   delete [] k;
+}
+
+const double BogackiShampineSolver::a[] =
+{
+   1./2,
+   0., 3./4,
+   2./9, 1./3, 4./9
+};
+const double BogackiShampineSolver::b[] = { 2./9, 1./3, 4./9, 0. };
+const double BogackiShampineSolver::bh[] = { 7./24, 1./4, 1./3, 1./8 };
+const double BogackiShampineSolver::c[] = { 1./2, 3./4, 1. };
+
+const double DormandPrinceSolver::a[] =
+{
+   1./5,
+   3./40, 9./40,
+   44./45, -56./15, 32./9,
+   19372./6561, -25360./2187, 64448./6561, -212./729,
+   9017./3168, -355./33, 46732./5247, 49./176, -5103./18656,
+   35./384, 0., 500./1113, 125./192, -2187./6784, 11./84
+};
+const double DormandPrinceSolver::b[] =
+{ 35./384, 0., 500./1113, 125./192, -2187./6784, 11./84, 0. };
+const double DormandPrinceSolver::bh[] =
+{
+   5179./57600, 0., 7571./16695, 393./640, -92097./339200, 187./2100,
+   1./40
+};
+const double DormandPrinceSolver::c[] =
+{ 1./5, 3./10, 4./5, 8./9, 1., 1. };
+
+const double FehlbergSolver::a[] =
+{
+   1./4,
+   3./32, 9./32,
+   1932./2197, -7200./2197, 7296./2197,
+   439./216, -8., 3680./513, -845./4104,
+   -8./27, 2., -3544./2565, 1859./4104, -11./40
+};
+const double FehlbergSolver::b[] =
+{ 25./216, 0., 1408./2565, 2197./4104, -1./5, 0. };
+const double FehlbergSolver::bh[] =
+{ 16./135, 0., 6656./12825, 28561./56430, -9./50, 2./55 };
+const double FehlbergSolver::c[] = { 1./4, 3./8, 12./13, 1., 1./2 };
+
+
+void AdaptiveSDIRK4Solver::Init(TimeDependentOperator &_f)
+{
+   AdaptiveODESolver::Init(_f);
+   int n = f->Width();
+   y.SetSize(n);
+   for (int i = 0; i < 5; i++)
+   {
+      k[i].SetSize(n);
+   }
+}
+
+void AdaptiveSDIRK4Solver::TryStep(const Vector &x, double t, double dt,
+                                   Vector &x1, Vector &e)
+{
+   //  c[i] | a (strictly lower part) + gamma on the diagonal
+   // ------+-------------------------------------------------
+   //       | last row of a, gamma   (stiffly accurate)
+   //       | bh                     (embedded, order 3)
+   for (int l = 0, i = 0; i < 5; i++)
+   {
+      y = x;
+      for (int j = 0; j < i; j++)
+      {
+         y.Add(a[l++]*dt, k[j]);
+      }
+      f->SetTime(t + c[i]*dt);
+      f->ImplicitSolve(gamma*dt, y, k[i]);
+   }
+   add(y, gamma*dt, k[4], x1);
+   e = 0.0;
+   for (int j = 0; j < 5; j++)
+   {
+      const double bj = (j < 4) ? a[6+j] : gamma;
+      e.Add((bj - bh[j])*dt, k[j]);
+   }
+}
+
+const double AdaptiveSDIRK4Solver::gamma = 1./4;
+const double AdaptiveSDIRK4Solver::a[] =
+{
+   1./2,
+   17./50, -1./25,
+   371./1360, -137./2720, 15./544,
+   25./24, -49./48, 125./16, -85./12
+};
+const double AdaptiveSDIRK4Solver::bh[] =
+{ 59./48, -17./96, 225./32, -85./12, 0. };
+const double AdaptiveSDIRK4Solver::c[] = { 1./4, 3./4, 11./20, 1./2, 1. };
+
+
+IMEXRKSolver::IMEXRKSolver(int _s, const double *_aE, const double *_bE,
+                           const double *_aI, const double *_bI,
+                           const double *_c)
+   : s(_s), aE(_aE), bE(_bE), aI(_aI), bI(_bI), c(_c), g(NULL)
+{
+   kE = new Vector[s];
+   kI = new Vector[s];
+
+   // A stage derivative is needed if it has a nonzero weight or it is used by
+   // one of the next stages.
+   use_E.SetSize(s);
+   use_I.SetSize(s);
+   for (int i = 0; i < s; i++)
+   {
+      use_E[i] = (bE[i] != 0.0);
+      use_I[i] = (bI[i] != 0.0);
+      for (int j = i+1; j < s; j++)
+      {
+         use_E[i] = use_E[i] || (aE[j*(j-1)/2+i] != 0.0);
+         use_I[i] = use_I[i] || (aI[j*(j+1)/2+i] != 0.0);
+      }
+   }
+}
+
+void IMEXRKSolver::Init(TimeDependentOperator &_f)
+{
+   ODESolver::Init(_f);
+   g = dynamic_cast<IMEXTimeDependentOperator *>(&_f);
+   MFEM_VERIFY(g != NULL, "IMEXRKSolver requires an "
+               "IMEXTimeDependentOperator");
+   int n = f->Width();
+   y.SetSize(n);
+   for (int i = 0; i < s; i++)
+   {
+      kE[i].SetSize(n);
+      kI[i].SetSize(n);
+   }
+}
+
+void IMEXRKSolver::Step(Vector &x, double &t, double &dt)
+{
+   //  Stage i: Y_i = x + dt sum_{j<i} (aE_ij kE_j + aI_ij kI_j) + dt aI_ii kI_i
+   //  with kI_i = f_I(Y_i, t + c_i dt) and kE_i = f_E(Y_i, t + c_i dt).
+   for (int i = 0; i < s; i++)
+   {
+      const double *aE_i = aE + i*(i-1)/2, *aI_i = aI + i*(i+1)/2;
+      y = x;
+      for (int j = 0; j < i; j++)
+      {
+         if (aE_i[j] != 0.0) { y.Add(aE_i[j]*dt, kE[j]); }
+         if (aI_i[j] != 0.0) { y.Add(aI_i[j]*dt, kI[j]); }
+      }
+      g->SetTime(t + c[i]*dt);
+      if (aI_i[i] != 0.0)
+      {
+         g->ImplicitPartSolve(aI_i[i]*dt, y, kI[i]);
+         y.Add(aI_i[i]*dt, kI[i]);
+      }
+      else if (use_I[i])
+      {
+         g->ImplicitPartMult(y, kI[i]);
+      }
+      if (use_E[i])
+      {
+         g->ExplicitMult(y, kE[i]);
+      }
+   }
+   for (int i = 0; i < s; i++)
+   {
+      if (bE[i] != 0.0) { x.Add(bE[i]*dt, kE[i]); }
+      if (bI[i] != 0.0) { x.Add(bI[i]*dt, kI[i]); }
+   }
+   t += dt;
+}
+
+IMEXRKSolver::~IMEXRKSolver()
+{
+   delete [] kI;
+   delete [] kE;
+}
+
+const double ARS111Solver::aE[] = { 1. };
+const double ARS111Solver::bE[] = { 1., 0. };
+const double ARS111Solver::aI[] =
+{
+   0.,
+   0., 1.
+};
+const double ARS111Solver::bI[] = { 0., 1. };
+const double ARS111Solver::c[] = { 0., 1. };
+
+const double ARS222Solver::gamma = 1. - 1./sqrt(2.);
+const double ARS222Solver::delta = 1. - 1./(2.*gamma);
+const double ARS222Solver::aE[] =
+{
+   gamma,
+   delta, 1. - delta
+};
+const double ARS222Solver::bE[] = { delta, 1. - delta, 0. };
+const double ARS222Solver::aI[] =
+{
+   0.,
+   0., gamma,
+   0., 1. - gamma, gamma
+};
+const double ARS222Solver::bI[] = { 0., 1. - gamma, gamma };
+const double ARS222Solver::c[] = { 0., gamma, 1. };
+
+const double ARS443Solver::aE[] =
+{
+   1./2,
+   11./18, 1./18,
+   5./6, -5./6, 1./2,
+   1./4, 7./4, 3./4, -7./4
+};
+const double ARS443Solver::bE[] = { 1./4, 7./4, 3./4, -7./4, 0. };
+const double ARS443Solver::aI[] =
+{
+   0.,
+   0., 1./2,
+   0., 1./6, 1./2,
+   0., -1./2, 1./2, 1./2,
+   0., 3./2, -3./2, 1./2, 1./2
+};
+const double ARS443Solver::bI[] = { 0., 3./2, -3./2, 1./2, 1./2 };
+const double ARS443Solver::c[] = { 0., 1./2, 2./3, 1./2, 1. };
+
+const double ARK324L2SASolver::gamma = 1767732205903./4055673282236.;
+const double ARK324L2SASolver::aE[] =
+{
+   2.*gamma,
+   5535828885825./10492691773637., 788022342437./10882634858940.,
+   6485989280629./16251701735622., -4246266847089./9704473918619.,
+   10755448449292./10357097424841.
+};
+const double ARK324L2SASolver::b[] =
+{
+   1471266399579./7840856788654., -4482444167858./7529755066697.,
+   11266239266428./11593286722821., gamma
+};
+const double ARK324L2SASolver::aI[] =
+{
+   0.,
+   gamma, gamma,
+   2746238789719./10658868560708., -640167445237./6845629431997., gamma,
+   b[0], b[1], b[2], gamma
+};
+const double ARK324L2SASolver::c[] = { 0., 2.*gamma, 3./5, 1. };
+
 void GeneralizedAlphaSolver::Init(TimeDependentOperator &_f)
 {
    ODESolver::Init(_f);
@@ -15,6 +15,10 @@
 #include "../config/config.hpp"
 #include "operator.hpp"
 
+#ifdef MFEM_USE_MPI
+#include <mpi.h>
+#endif
+
 namespace mfem
 {
 
@@ -208,6 +212,86 @@ public:
 };
 
 
+/** @brief Low-storage explicit Runge-Kutta method in the 2N form of
+    Williamson, defined by the coefficients A, B and c of its s stages. */
+/** Starting with k = 0, the stages i = 0,...,s-1 compute
+        k = A[i] k + dt f(x, t + c[i] dt),   x = x + B[i] k.
+    Besides the solution, only k and the evaluation of f are stored,
+    independently of the number of stages, and the two updates of each stage
+    are fused in a single pass over the vectors. */
+class LowStorageRKSolver : public ODESolver
+{
+private:
+   int s;
+   const double *A, *B, *c;
+   Vector k, dxdt;
+
+public:
+   LowStorageRKSolver(int _s, const double *_A, const double *_B,
+                      const double *_c)
+      : s(_s), A(_A), B(_B), c(_c) { }
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+};
+
+
+/// Williamson's 3-stage, 3rd order low-storage RK method.
+class LowStorageRK3Solver : public LowStorageRKSolver
+{
+private:
+   static const double A[3], B[3], c[3];
+
+public:
+   LowStorageRK3Solver() : LowStorageRKSolver(3, A, B, c) { }
+};
+
+
+/** The 5-stage, 4th order low-storage RK method of Carpenter and Kennedy,
+    "Fourth-order 2N-storage Runge-Kutta schemes" (1994). */
+class LowStorageRK4Solver : public LowStorageRKSolver
+{
+private:
+   static const double A[5], B[5], c[5];
+
+public:
+   LowStorageRK4Solver() : LowStorageRKSolver(5, A, B, c) { }
+};
+
+
+/** @brief Low-storage strong stability preserving (SSP) Runge-Kutta methods
+    with optimal SSP coefficient, from D. Ketcheson, "Highly efficient strong
+    stability preserving Runge-Kutta methods with low-storage
+    implementations" (2008). */
+/** The supported methods are:
+    - order 2 with s >= 2 stages, SSP coefficient s-1,
+    - order 3 with s = n^2 stages, n >= 2, SSP coefficient s-n,
+    - order 4 with s = 10 stages, SSP coefficient 6.
+
+    The stages are forward Euler steps of size dt/C, with C the SSP
+    coefficient, and linear combinations with one additional stored vector. */
+class LowStorageSSPRKSolver : public ODESolver
+{
+private:
+   int order, s;
+   Vector q, dxdt;
+
+   /// Forward Euler step of size @a h from @a x at time @a tx.
+   void EulerStage(Vector &x, double &tx, double h);
+
+public:
+   LowStorageSSPRKSolver(int _order = 3, int _s = 4);
+
+   /// Returns the SSP coefficient of the method.
+   double GetSSPCoefficient() const;
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+};
+
+
 /// Backward Euler ODE solver. L-stable.
 class BackwardEulerSolver : public ODESolver
 {
@@ -283,6 +367,344 @@ public:
 };
 
 
+/** @brief Abstract class for the step size controllers of the adaptive ODE
+    solvers. */
+/** The local error estimate e of a step from x0 to x1 is measured with the
+    norm of the vector with entries e_i / (atol + rtol max(|x0_i|, |x1_i|)),
+    either the root mean square (default) or the maximum norm. The step is
+    accepted when this norm is at most 1. In parallel, the norm is reduced
+    over the processors of the given communicator, so the vectors should
+    contain true (non-overlapping) degrees of freedom. */
+class ODEController
+{
+public:
+   enum NormType { RMS_NORM, MAX_NORM };
+
+protected:
+   double rel_tol, abs_tol;
+   double safety, min_factor, max_factor;
+   NormType norm_type;
+#ifdef MFEM_USE_MPI
+   int parallel;
+   MPI_Comm comm;
+#endif
+
+   /** @brief The factor for the next step size after a step accepted with
+       error norm @a err, where @a k is the order of the error estimate plus
+       one. */
+   virtual double AcceptFactor(double err, int k) = 0;
+
+public:
+   ODEController();
+
+#ifdef MFEM_USE_MPI
+   ODEController(MPI_Comm comm_);
+#endif
+
+   void SetRelTol(double rtol) { rel_tol = rtol; }
+   void SetAbsTol(double atol) { abs_tol = atol; }
+   void SetNormType(NormType type) { norm_type = type; }
+
+   /// Set the safety factor applied to the optimal step size, default 0.9.
+   void SetSafetyFactor(double s) { safety = s; }
+
+   /** @brief Set the bounds of the ratio between two consecutive step sizes,
+       default 0.2 and 5. */
+   void SetFactorLimits(double min_f, double max_f)
+   { min_factor = min_f; max_factor = max_f; }
+
+   /// Returns the (global) error norm of @a err for a step from x0 to x1.
+   double ErrorNorm(const Vector &err, const Vector &x0,
+                    const Vector &x1) const;
+
+   /// Returns the next step size after an accepted step of size @a dt.
+   double Accept(double err, double dt, int k);
+
+   /// Returns the step size for retrying a rejected step of size @a dt.
+   double Reject(double err, double dt, int k);
+
+   /// Forget the history of the error norms, e.g. when restarting.
+   virtual void Reset() { }
+
+   virtual ~ODEController() { }
+};
+
+
+/** @brief PID step size controller of Soderlind: after an accepted step with
+    error norm e_n, the next step size is
+        dt_n+1 = safety dt_n e_n^(-k1/k) e_n-1^(k2/k) e_n-2^(-k3/k),
+    where k is the order of the error estimate plus one. */
+/** The parameters (k1,k2,k3) = (1,0,0) give the elementary I controller, and
+    k3 = 0 a PI controller. The default ones are from ARKODE. */
+class PIDController : public ODEController
+{
+protected:
+   double k1, k2, k3;
+   double err1, err2;
+
+   virtual double AcceptFactor(double err, int k);
+
+public:
+   PIDController(double k1_ = 0.58, double k2_ = 0.21, double k3_ = 0.1)
+      : k1(k1_), k2(k2_), k3(k3_) { Reset(); }
+
+#ifdef MFEM_USE_MPI
+   PIDController(MPI_Comm comm_, double k1_ = 0.58, double k2_ = 0.21,
+                 double k3_ = 0.1)
+      : ODEController(comm_), k1(k1_), k2(k2_), k3(k3_) { Reset(); }
+#endif
+
+   virtual void Reset() { err1 = err2 = 1.0; }
+};
+
+
+/// PI step size controller, with the default parameters of ARKODE.
+class PIController : public PIDController
+{
+public:
+   PIController(double k1_ = 0.8, double k2_ = 0.31)
+      : PIDController(k1_, k2_, 0.0) { }
+
+#ifdef MFEM_USE_MPI
+   PIController(MPI_Comm comm_, double k1_ = 0.8, double k2_ = 0.31)
+      : PIDController(comm_, k1_, k2_, 0.0) { }
+#endif
+};
+
+
+/** @brief Abstract class for ODE solvers with an embedded error estimate and
+    adaptive time step control. */
+/** Step() retries the step with smaller step sizes until the error estimate
+    is accepted by the controller. On return, @a dt is the accepted step size
+    and GetNextTimeStep() is the step size suggested for the next step. Run()
+    uses the suggested step sizes and ends exactly at the final time. */
+class AdaptiveODESolver : public ODESolver
+{
+protected:
+   ODEController *controller;
+   bool own_controller;
+   /// Order of the error estimate plus one, used by the controller.
+   int est_order;
+   double dt_next, dt_min, dt_max;
+   int num_accepted, num_rejected;
+   Vector x_new, err;
+
+   /** @brief Compute the solution @a x1 after a step of size @a dt from
+       @a x at time @a t, and the local error estimate @a e. */
+   virtual void TryStep(const Vector &x, double t, double dt, Vector &x1,
+                        Vector &e) = 0;
+
+   /// Called when the step computed by the last TryStep() is accepted.
+   virtual void AcceptStep() { }
+
+public:
+   AdaptiveODESolver(int est_order_);
+
+   /// Use the controller @a c, owned by the solver if @a own is true.
+   void SetController(ODEController &c, bool own = false);
+   ODEController &GetController() { return *controller; }
+
+   /// Set the relative and absolute tolerances of the controller.
+   void SetTolerances(double rtol, double atol)
+   { controller->SetRelTol(rtol); controller->SetAbsTol(atol); }
+
+   /** @brief Set the bounds of the step size; a step fails with an error if
+       its size falls below @a dtmin. */
+   void SetTimeStepLimits(double dtmin, double dtmax)
+   { dt_min = dtmin; dt_max = dtmax; }
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   /** @brief Take one accepted step: @a dt [in] is the first trial step size,
+       @a dt [out] the accepted one and @a dt_next the suggested next one. */
+   virtual void Step(Vector &x, double &t, double &dt, double &dt_next);
+
+   virtual void Step(Vector &x, double &t, double &dt)
+   { Step(x, t, dt, dt_next); }
+
+   virtual void Run(Vector &x, double &t, double &dt, double tf);
+
+   /// Returns the step size suggested after the last accepted step.
+   double GetNextTimeStep() const { return dt_next; }
+
+   int GetNumAcceptedSteps() const { return num_accepted; }
+   int GetNumRejectedSteps() const { return num_rejected; }
+
+   virtual ~AdaptiveODESolver();
+};
+
+
+/** @brief Explicit Runge-Kutta method with an embedded pair: the Butcher
+    tableau of ExplicitRKSolver with the weights @a bh of the embedded
+    method. */
+/** The error estimate is dt sum_i (b[i] - bh[i]) k_i. If @a fsal is true,
+    the last stage is the evaluation at the new solution ("first same as
+    last") and is reused as the first stage of the next step; the solution
+    should then not be modified between consecutive calls to Step(). */
+class EmbeddedRKSolver : public AdaptiveODESolver
+{
+private:
+   int s;
+   const double *a, *b, *bh, *c;
+   bool fsal, k0_valid;
+   Vector y, *k;
+
+protected:
+   virtual void TryStep(const Vector &x, double t, double dt, Vector &x1,
+                        Vector &e);
+   virtual void AcceptStep();
+
+public:
+   EmbeddedRKSolver(int _s, const double *_a, const double *_b,
+                    const double *_bh, const double *_c, int est_order_,
+                    bool _fsal);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual ~EmbeddedRKSolver();
+};
+
+
+/// The Bogacki-Shampine 3(2) pair, with 4 stages (FSAL).
+class BogackiShampineSolver : public EmbeddedRKSolver
+{
+private:
+   static const double a[6], b[4], bh[4], c[3];
+
+public:
+   BogackiShampineSolver() : EmbeddedRKSolver(4, a, b, bh, c, 3, true) { }
+};
+
+
+/// The Dormand-Prince 5(4) pair, with 7 stages (FSAL).
+class DormandPrinceSolver : public EmbeddedRKSolver
+{
+private:
+   static const double a[21], b[7], bh[7], c[6];
+
+public:
+   DormandPrinceSolver() : EmbeddedRKSolver(7, a, b, bh, c, 5, true) { }
+};
+
+
+/** The Runge-Kutta-Fehlberg 4(5) pair, with 6 stages; the solution is
+    advanced with the 4th order method. */
+class FehlbergSolver : public EmbeddedRKSolver
+{
+private:
+   static const double a[15], b[6], bh[6], c[5];
+
+public:
+   FehlbergSolver() : EmbeddedRKSolver(6, a, b, bh, c, 5, false) { }
+};
+
+
+/** Five stage, singly diagonal implicit Runge-Kutta (SDIRK) method of order
+    4, with an embedded method of order 3 for adaptive time stepping, from
+    Hairer and Wanner, "Solving Ordinary Differential Equations II". L-stable
+    and stiffly accurate. */
+class AdaptiveSDIRK4Solver : public AdaptiveODESolver
+{
+private:
+   static const double gamma, a[10], bh[5], c[5];
+   Vector y, k[5];
+
+protected:
+   virtual void TryStep(const Vector &x, double t, double dt, Vector &x1,
+                        Vector &e);
+
+public:
+   AdaptiveSDIRK4Solver() : AdaptiveODESolver(4) { }
+
+   virtual void Init(TimeDependentOperator &_f);
+};
+
+
+/** @brief Implicit-explicit (IMEX) additive Runge-Kutta method for operators
+    of type IMEXTimeDependentOperator. */
+/** The non-stiff part f_E is integrated with an explicit tableau (@a aE, @a
+    bE) and the stiff part f_I with a diagonally implicit one (@a aI, @a bI),
+    both with the @a s nodes @a c. The explicit matrix @a aE stores the
+    strictly lower triangular part by rows, s(s-1)/2 entries, and the implicit
+    one @a aI the lower triangular part with the diagonal, s(s+1)/2 entries.
+
+    Each stage with a nonzero diagonal coefficient requires one call to
+    IMEXTimeDependentOperator::ImplicitPartSolve(), i.e. only the stiff part
+    needs to be solved for. The stage derivatives which are not used by the
+    method, e.g. the implicit one of an explicit first stage in the ARS
+    schemes, are not evaluated. */
+class IMEXRKSolver : public ODESolver
+{
+private:
+   int s;
+   const double *aE, *bE, *aI, *bI, *c;
+   Array<bool> use_E, use_I;
+   IMEXTimeDependentOperator *g;
+   Vector y, *kE, *kI;
+
+public:
+   IMEXRKSolver(int _s, const double *_aE, const double *_bE,
+                const double *_aI, const double *_bI, const double *_c);
+
+   virtual void Init(TimeDependentOperator &_f);
+
+   virtual void Step(Vector &x, double &t, double &dt);
+
+   virtual ~IMEXRKSolver();
+};
+
+
+/** Forward-backward Euler IMEX method, ARS(1,1,1) from Ascher, Ruuth and
+    Spiteri, "Implicit-explicit Runge-Kutta methods for time-dependent partial
+    differential equations". First order. */
+class ARS111Solver : public IMEXRKSolver
+{
+private:
+   static const double aE[1], bE[2], aI[3], bI[2], c[2];
+
+public:
+   ARS111Solver() : IMEXRKSolver(2, aE, bE, aI, bI, c) { }
+};
+
+
+/** Second order IMEX method ARS(2,2,2) of Ascher, Ruuth and Spiteri: two
+    implicit L-stable, stiffly accurate stages and three explicit ones. */
+class ARS222Solver : public IMEXRKSolver
+{
+private:
+   static const double gamma, delta, aE[3], bE[3], aI[6], bI[3], c[3];
+
+public:
+   ARS222Solver() : IMEXRKSolver(3, aE, bE, aI, bI, c) { }
+};
+
+
+/** Third order IMEX method ARS(4,4,3) of Ascher, Ruuth and Spiteri: four
+    implicit L-stable, stiffly accurate stages and five explicit ones. */
+class ARS443Solver : public IMEXRKSolver
+{
+private:
+   static const double aE[10], bE[5], aI[15], bI[5], c[5];
+
+public:
+   ARS443Solver() : IMEXRKSolver(5, aE, bE, aI, bI, c) { }
+};
+
+
+/** Third order additive Runge-Kutta method ARK3(2)4L[2]SA of Kennedy and
+    Carpenter, "Additive Runge-Kutta schemes for convection-diffusion-reaction
+    equations", with 4 stages. The implicit part is an L-stable, stiffly
+    accurate ESDIRK method. */
+class ARK324L2SASolver : public IMEXRKSolver
+{
+private:
+   static const double gamma, aE[6], b[4], aI[10], c[4];
+
+public:
+   ARK324L2SASolver() : IMEXRKSolver(4, aE, b, aI, b, c) { }
+};
+
+
 /// Generalized-alpha ODE solver from "A generalized-α method for integrating
 /// the filtered Navier–Stokes equations with a stabilized finite element
 /// method" by K.E. Jansen, C.H. Whiting and G.M. Hulbert.
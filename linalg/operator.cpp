@@ -12,6 +12,7 @@
 #include "vector.hpp"
 #include "dtensor.hpp"
 #include "operator.hpp"
+#include "multivector.hpp"
 #include "../general/forall.hpp"
 
 #include <iostream>
@@ -20,6 +21,19 @@
 namespace mfem
 {
 
+void Operator::BatchMult(const MultiVector &X, MultiVector &Y) const
+{
+   MFEM_VERIFY(X.VectorSize() == width && Y.VectorSize() == height &&
+               X.NumVectors() == Y.NumVectors(), "incompatible multivectors");
+   Vector x, y;
+   for (int j = 0; j < X.NumVectors(); j++)
+   {
+      X.GetVectorView(j, x);
+      Y.GetVectorView(j, y);
+      Mult(x, y);
+   }
+}
+
 void Operator::FormLinearSystem(const Array<int> &ess_tdof_list,
                                 Vector &x, Vector &b,
                                 Operator* &Aout, Vector &X, Vector &B,
@@ -212,4 +226,41 @@ void ConstrainedOperator::Mult(const Vector &x, Vector &y) const
    });
 }
 
+void ConstrainedOperator::BatchMult(const MultiVector &X, MultiVector &Y) const
+{
+   const int csz = constraint_list.Size();
+   if (csz == 0)
+   {
+      A->BatchMult(X, Y);
+      return;
+   }
+
+   const int nv = X.NumVectors();
+   MultiVector Z(X.VectorSize(), nv);
+   Z = X;
+   const DeviceArray idx(constraint_list, csz);
+   Vector x, y, zj;
+   for (int j = 0; j < nv; j++)
+   {
+      Z.GetVectorView(j, zj);
+      DeviceVector d_z(zj, zj.Size());
+      MFEM_FORALL(i, csz, d_z[idx[i]] = 0.0;);
+   }
+
+   A->BatchMult(Z, Y);
+
+   for (int j = 0; j < nv; j++)
+   {
+      X.GetVectorView(j, x);
+      Y.GetVectorView(j, y);
+      const DeviceVector d_x(x, x.Size());
+      DeviceVector d_y(y, y.Size());
+      MFEM_FORALL(i, csz,
+      {
+         const int id = idx[i];
+         d_y[id] = d_x[id];
+      });
+   }
+}
+
 }
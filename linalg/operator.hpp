@@ -17,6 +17,8 @@
 namespace mfem
 {
 
+class MultiVector;
+
 /// Abstract operator
 class Operator
 {
@@ -47,6 +49,13 @@ public:
    /// Operator application: `y=A(x)`.
    virtual void Mult(const Vector &x, Vector &y) const = 0;
 
+   /** @brief Operator application to several vectors: `Y_j=A(X_j)` for all
+       vectors of the MultiVector @a X. */
+   /** The default implementation calls Mult() for every vector. Derived
+       classes can override it to process all vectors together, e.g. to read
+       the data of the operator only once. */
+   virtual void BatchMult(const MultiVector &X, MultiVector &Y) const;
+
    /** @brief Action of the transpose operator: `y=A^t(x)`. The default behavior
        in class Operator is to generate an error. */
    virtual void MultTranspose(const Vector &x, Vector &y) const
@@ -264,6 +273,79 @@ public:
    virtual ~TimeDependentOperator() { }
 };
 
+
+/** @brief Base abstract class for time dependent operators with an additive
+    splitting f(x,t) = f_E(x,t) + f_I(x,t) into a non-stiff part f_E, treated
+    explicitly, and a stiff part f_I, treated implicitly. */
+/** This is the interface used by the implicit-explicit (IMEX) Runge-Kutta
+    solvers, see IMEXRKSolver. In terms of the general form F(x,k,t) = G(x,t)
+    of TimeDependentOperator, G = f_E and F(x,k,t) = k - f_I(x,t).
+
+    Derived classes must implement ExplicitMult(), ImplicitPartMult() and
+    ImplicitPartSolve(), where the latter involves only the stiff part f_I.
+    ImplicitSolve() keeps its meaning of a solve with the full operator f: it
+    generates an error unless it is re-implemented, so that the implicit
+    solvers which are not IMEX solvers cannot be used with the stiff part
+    only. */
+class IMEXTimeDependentOperator : public TimeDependentOperator
+{
+protected:
+   mutable Vector z; ///< Auxiliary vector used by Mult() and ImplicitMult().
+
+public:
+   /** @brief Construct a "square" IMEXTimeDependentOperator y = f(x,t), where
+       x and y have the same dimension @a n. */
+   explicit IMEXTimeDependentOperator(int n = 0, double t_ = 0.0)
+      : TimeDependentOperator(n, t_, IMPLICIT) { }
+
+   /** @brief Perform the action of the non-stiff part of the operator:
+       @a y = f_E(@a x, t) where t is the current time. */
+   virtual void ExplicitMult(const Vector &x, Vector &y) const = 0;
+
+   /** @brief Perform the action of the stiff part of the operator:
+       @a y = f_I(@a x, t) where t is the current time. */
+   virtual void ImplicitPartMult(const Vector &x, Vector &y) const = 0;
+
+   /// Perform the action of the implicit part F: @a y = @a k - f_I(@a x, t).
+   virtual void ImplicitMult(const Vector &x, const Vector &k, Vector &y) const
+   {
+      z.SetSize(x.Size());
+      ImplicitPartMult(x, z);
+      subtract(k, z, y);
+   }
+
+   /// Perform the action of the full operator: @a y = f_E(x,t) + f_I(x,t).
+   virtual void Mult(const Vector &x, Vector &y) const
+   {
+      z.SetSize(x.Size());
+      ExplicitMult(x, y);
+      ImplicitPartMult(x, z);
+      y += z;
+   }
+
+   /** @brief Solve the equation: @a k = f_I(@a x + @a dt @a k, t), for the
+       unknown @a k at the current time t.
+
+       Unlike ImplicitSolve(), only the stiff part of the operator is involved:
+       for a linear stiff part f_I(x,t) = L x + g(t), this is one linear solve
+       with the matrix (I - @a dt L). */
+   virtual void ImplicitPartSolve(const double dt, const Vector &x,
+                                  Vector &k) = 0;
+
+   /** @brief Solve the equation: @a k = f(@a x + @a dt @a k, t) with the full
+       operator f = f_E + f_I, see TimeDependentOperator::ImplicitSolve().
+
+       If not re-implemented, this method generates an error: use an IMEX
+       solver, which calls ImplicitPartSolve(), or implement the full solve. */
+   virtual void ImplicitSolve(const double dt, const Vector &x, Vector &k)
+   {
+      mfem_error("IMEXTimeDependentOperator::ImplicitSolve() is not "
+                 "overridden! Only ImplicitPartSolve() is available.");
+   }
+
+   virtual ~IMEXTimeDependentOperator() { }
+};
+
 /// Base class for solvers
 class Solver : public Operator
 {
@@ -440,6 +522,9 @@ public:
        the vectors, and "_i" -- the rest of the entries. */
    virtual void Mult(const Vector &x, Vector &y) const;
 
+   /// Constrained operator action on several vectors, see Mult().
+   virtual void BatchMult(const MultiVector &X, MultiVector &Y) const;
+
    /// Destructor: destroys the unconstrained Operator @a A if @a own_A is true.
    virtual ~ConstrainedOperator() { if (own_A) { delete A; } }
 };
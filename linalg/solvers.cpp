@@ -11,6 +11,8 @@
 
 #include "linalg.hpp"
 #include "../general/globals.hpp"
+#include "../general/forall.hpp"
+#include "../general/device.hpp"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
@@ -69,6 +71,160 @@ double IterativeSolver::Dot(const Vector &x, const Vector &y) const
 #endif
 }
 
+void IterativeSolver::StartDots(double *dots, int n) const
+{
+#ifndef MFEM_USE_MPI
+   MFEM_CONTRACT_VAR(dots);
+   MFEM_CONTRACT_VAR(n);
+#else
+   if (dot_prod_type != 0)
+   {
+      MPI_Iallreduce(MPI_IN_PLACE, dots, n, MPI_DOUBLE, MPI_SUM, comm,
+                     &dots_request);
+   }
+#endif
+}
+
+void IterativeSolver::FinishDots() const
+{
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0)
+   {
+      MPI_Wait(&dots_request, MPI_STATUS_IGNORE);
+   }
+#endif
+}
+
+// w -= sum_j h[j] v[j], j = 0,...,nv-1, with a single pass over w.
+static void MultiSubtract(const Array<Vector*> &v, int nv, const double *h,
+                          Vector &w)
+{
+   if (Device::Allows(Backend::CUDA_MASK))
+   {
+      for (int j = 0; j < nv; j++) { w.Add(-h[j], *v[j]); }
+      return;
+   }
+   const int n = w.Size(), bsize = 512;
+   double *wd = w.GetData();
+   for (int i0 = 0; i0 < n; i0 += bsize)
+   {
+      const int i1 = std::min(i0 + bsize, n);
+      for (int j = 0; j < nv; j++)
+      {
+         const double *vd = v[j]->GetData();
+         const double hj = h[j];
+         for (int i = i0; i < i1; i++) { wd[i] -= hj * vd[i]; }
+      }
+   }
+}
+
+void IterativeSolver::Orthogonalize(GramSchmidt::Type type,
+                                    const Array<Vector*> &v, int k, Vector &w,
+                                    double *h) const
+{
+   const int nv = k + 1;
+   if (type == GramSchmidt::MODIFIED)
+   {
+      for (int j = 0; j < nv; j++)
+      {
+         h[j] = Dot(w, *v[j]);
+         w.Add(-h[j], *v[j]);
+      }
+      h[nv] = Norm(w);
+      return;
+   }
+   MFEM_VERIFY(type == GramSchmidt::CLASSICAL_REORTH,
+               "unknown Gram-Schmidt type: " << type);
+
+   // First pass
+   MultiDot(nv, v.GetData(), w, h);
+   StartDots(h, nv);
+   FinishDots();
+   MultiSubtract(v, nv, h, w);
+
+   // Second pass, which also reduces (w, w) before the correction
+   Vector c(nv + 1);
+   MultiDot(nv, v.GetData(), w, c.GetData());
+   c(nv) = w * w;
+   StartDots(c.GetData(), nv + 1);
+   FinishDots();
+   MultiSubtract(v, nv, c.GetData(), w);
+
+   // Norm of the corrected w by the Pythagorean theorem; after the first pass
+   // the correction is small, otherwise compute the norm explicitly.
+   double norm2 = c(nv);
+   for (int j = 0; j < nv; j++)
+   {
+      h[j] += c(j);
+      norm2 -= c(j) * c(j);
+   }
+   h[nv] = (norm2 > 0.5 * c(nv)) ? sqrt(norm2) : Norm(w);
+}
+
+// Cholesky factorization G = T^T T of the Gram matrix G restricted to the
+// selected vectors, which are the ones with a significant component orthogonal
+// to the previously selected ones. T is upper triangular.
+static void DroppingCholesky(const DenseMatrix &G, DenseMatrix &T,
+                             Array<int> &sel)
+{
+   const int nv = G.Height();
+   T.SetSize(nv);
+   sel.SetSize(0);
+   for (int j = 0; j < nv; j++)
+   {
+      const int r = sel.Size();
+      double d = G(j,j);
+      for (int t = 0; t < r; t++)
+      {
+         double c = G(sel[t],j);
+         for (int u = 0; u < t; u++) { c -= T(u,t) * T(u,r); }
+         T(t,r) = c / T(t,t);
+         d -= T(t,r) * T(t,r);
+      }
+      if (d > 1e-12 * G(j,j))
+      {
+         T(r,r) = sqrt(d);
+         sel.Append(j);
+      }
+   }
+}
+
+int IterativeSolver::Orthonormalize(MultiVector &W, MultiVector *U) const
+{
+   const int nv = W.NumVectors();
+   DenseMatrix G;
+   W.InnerProducts(W, G);
+   StartDots(G.Data(), nv*nv);
+   FinishDots();
+
+   DenseMatrix T;
+   Array<int> sel;
+   DroppingCholesky(G, T, sel);
+
+   // W_sel = P T in place, column by column
+   Vector w, p, q;
+   for (int c = 0; c < (U ? 2 : 1); c++)
+   {
+      MultiVector &X = (c == 0) ? W : *U;
+      for (int r = 0; r < sel.Size(); r++)
+      {
+         X.GetVectorView(r, p);
+         if (sel[r] != r)
+         {
+            X.GetVectorView(sel[r], w);
+            p = w;
+         }
+         for (int t = 0; t < r; t++)
+         {
+            X.GetVectorView(t, q);
+            p.Add(-T(t,r), q);
+         }
+         p /= T(r,r);
+      }
+   }
+   return sel.Size();
+}
+
 void IterativeSolver::SetPrintLevel(int print_lvl)
 {
 #ifndef MFEM_USE_MPI
@@ -304,21 +460,674 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
    }
    else
    {
-      r = b;
-      x = 0.0;
+      r = b;
+      x = 0.0;
+   }
+
+   if (prec)
+   {
+      prec->Mult(r, z); // z = B r
+      d = z;
+   }
+   else
+   {
+      d = r;
+   }
+   nom0 = nom = Dot(d, r);
+   MFEM_ASSERT(IsFinite(nom), "nom = " << nom);
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                << nom << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   r0 = std::max(nom*rel_tol*rel_tol, abs_tol*abs_tol);
+   if (nom <= r0)
+   {
+      converged = 1;
+      final_iter = 0;
+      final_norm = sqrt(nom);
+      return;
+   }
+
+   oper->Mult(d, z);  // z = A d
+   den = Dot(z, d);
+   MFEM_ASSERT(IsFinite(den), "den = " << den);
+
+   if (print_level >= 0 && den < 0.0)
+   {
+      mfem::out << "Negative denominator in step 0 of PCG: " << den << '\n';
+   }
+
+   if (den == 0.0)
+   {
+      converged = 0;
+      final_iter = 0;
+      final_norm = sqrt(nom);
+      return;
+   }
+
+   // start iteration
+   converged = 0;
+   final_iter = max_iter;
+   for (i = 1; true; )
+   {
+      alpha = nom/den;
+      //  x = x + alpha d,  r = r - alpha A d  (and (r, r) without prec)
+      betanom = AddTwoAndDot(alpha, d, x, -alpha, z, r, prec ? NULL : &r);
+
+      if (prec)
+      {
+         prec->Mult(r, z);      //  z = B r
+         betanom = Dot(r, z);
+      }
+      else
+      {
+         SumDots(&betanom, 1);
+      }
+      MFEM_ASSERT(IsFinite(betanom), "betanom = " << betanom);
+
+      if (print_level == 1)
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << betanom << '\n';
+      }
+
+      if (betanom < r0)
+      {
+         if (print_level == 2)
+         {
+            mfem::out << "Number of PCG iterations: " << i << '\n';
+         }
+         else if (print_level == 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                      << betanom << '\n';
+         }
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+
+      if (++i > max_iter)
+      {
+         break;
+      }
+
+      beta = betanom/nom;
+      if (prec)
+      {
+         add(z, beta, d, d);   //  d = z + beta d
+      }
+      else
+      {
+         add(r, beta, d, d);
+      }
+      oper->Mult(d, z);       //  z = A d
+      den = Dot(d, z);
+      MFEM_ASSERT(IsFinite(den), "den = " << den);
+      if (den <= 0.0)
+      {
+         if (print_level >= 0 && Dot(d, d) > 0.0)
+            mfem::out << "PCG: The operator is not positive definite. (Ad, d) = "
+                      << den << '\n';
+      }
+      nom = betanom;
+   }
+   if (print_level >= 0 && !converged)
+   {
+      if (print_level != 1)
+      {
+         if (print_level != 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom0 << " ...\n";
+         }
+         mfem::out << "   Iteration : " << setw(3) << final_iter << "  (B r, r) = "
+                   << betanom << '\n';
+      }
+      mfem::out << "PCG: No convergence!" << '\n';
+   }
+   if (print_level >= 1 || (print_level >= 0 && !converged))
+   {
+      mfem::out << "Average reduction factor = "
+                << pow (betanom/nom0, 0.5/final_iter) << '\n';
+   }
+   final_norm = sqrt(betanom);
+}
+
+
+void PipelinedCGSolver::UpdateVectors()
+{
+   r.SetSize(width);
+   u.SetSize(width);
+   w.SetSize(width);
+   m.SetSize(width);
+   n.SetSize(width);
+   p.SetSize(width);
+   s.SetSize(width);
+   q.SetSize(width);
+   z.SetSize(width);
+}
+
+void PipelinedCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   double dots[2], r0 = 0.0, nom0 = 0.0, nom = 0.0, nom_old, den, alpha = 0.0;
+   double beta;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+   if (prec)
+   {
+      prec->Mult(r, u); // u = B r
+   }
+   else
+   {
+      u = r;
+   }
+   oper->Mult(u, w);    // w = A u
+   p = 0.0;
+   s = 0.0;
+   q = 0.0;
+   z = 0.0;
+
+   converged = 0;
+   final_iter = max_iter;
+   for (int i = 0; true; i++)
+   {
+      // Overlap the reduction with m = B w and n = A m
+      dots[0] = r * u;
+      dots[1] = w * u;
+      StartDots(dots, 2);
+      if (prec)
+      {
+         prec->Mult(w, m);
+      }
+      else
+      {
+         m = w;
+      }
+      oper->Mult(m, n);
+      FinishDots();
+
+      nom_old = nom;
+      nom = dots[0];
+      MFEM_ASSERT(IsFinite(nom), "nom = " << nom);
+      if (i == 0)
+      {
+         nom0 = nom;
+         r0 = std::max(nom*rel_tol*rel_tol, abs_tol*abs_tol);
+         if (print_level == 1 || print_level == 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom << (print_level == 3 ? " ...\n" : "\n");
+         }
+      }
+      else if (print_level == 1)
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << nom << '\n';
+      }
+
+      if (i == 0 ? (nom <= r0) : (nom < r0))
+      {
+         if (i > 0 && print_level == 2)
+         {
+            mfem::out << "Number of PCG iterations: " << i << '\n';
+         }
+         else if (i > 0 && print_level == 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                      << nom << '\n';
+         }
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+      if (i == max_iter)
+      {
+         break;
+      }
+
+      // (A d, d) of the equivalent CG search direction d = u + beta d
+      beta = (i == 0) ? 0.0 : nom/nom_old;
+      den = (i == 0) ? dots[1] : dots[1] - beta*nom/alpha;
+      MFEM_ASSERT(IsFinite(den), "den = " << den);
+      if (den <= 0.0)
+      {
+         if (print_level >= 0)
+         {
+            mfem::out << "PCG: The operator is not positive definite. "
+                      "(Ad, d) = " << den << '\n';
+         }
+         if (den == 0.0)
+         {
+            final_iter = i;
+            break;
+         }
+      }
+      alpha = nom/den;
+
+      const int N = x.Size();
+      DeviceVector d_x(x, N), d_r(r, N), d_u(u, N), d_w(w, N);
+      DeviceVector d_p(p, N), d_s(s, N), d_q(q, N), d_z(z, N);
+      const DeviceVector d_m(m, N), d_n(n, N);
+      MFEM_FORALL(k, N,
+      {
+         d_z[k] = d_n[k] + beta * d_z[k];
+         d_q[k] = d_m[k] + beta * d_q[k];
+         d_s[k] = d_w[k] + beta * d_s[k];
+         d_p[k] = d_u[k] + beta * d_p[k];
+         d_x[k] += alpha * d_p[k];
+         d_r[k] -= alpha * d_s[k];
+         d_u[k] -= alpha * d_q[k];
+         d_w[k] -= alpha * d_z[k];
+      });
+   }
+   if (print_level >= 0 && !converged)
+   {
+      if (print_level != 1)
+      {
+         if (print_level != 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom0 << " ...\n";
+         }
+         mfem::out << "   Iteration : " << setw(3) << final_iter
+                   << "  (B r, r) = " << nom << '\n';
+      }
+      mfem::out << "PCG: No convergence!" << '\n';
+   }
+   if (print_level >= 1 || (print_level >= 0 && !converged))
+   {
+      mfem::out << "Average reduction factor = "
+                << pow (nom/nom0, 0.5/final_iter) << '\n';
+   }
+   final_norm = sqrt(nom);
+}
+
+
+void BlockCGSolver::BatchMult(const MultiVector &B, MultiVector &X) const
+{
+   const int n = width, nv = B.NumVectors();
+   MFEM_VERIFY(B.VectorSize() == n && X.VectorSize() == n &&
+               X.NumVectors() == nv, "incompatible multivectors");
+
+   MultiVector R(n, nv), Z(n, nv), M1(n, nv), M2(n, nv);
+   if (iterative_mode)
+   {
+      oper->BatchMult(X, R);
+      subtract(B, R, R); // R = B - A X
+   }
+   else
+   {
+      R = B;
+      X = 0.0;
+   }
+   if (prec)
+   {
+      prec->BatchMult(R, Z); // Z = M R
+   }
+   else
+   {
+      Z = R;
+   }
+
+   // (M r_j, r_j) for all j, followed by the coefficients Q^T Z.
+   Vector nom, dots;
+   Z.Dots(R, nom);
+   StartDots(nom.GetData(), nv);
+   FinishDots();
+   Vector nom0(nom), r0(nv);
+   bool done = true;
+   for (int j = 0; j < nv; j++)
+   {
+      r0(j) = std::max(nom(j)*rel_tol*rel_tol, abs_tol*abs_tol);
+      done = done && (nom(j) <= r0(j));
+   }
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << 0 << "  max (B r, r) = "
+                << nom.Max() << (print_level == 3 ? " ...\n" : "\n");
+   }
+   converged = done;
+   final_iter = 0;
+   if (!done)
+   {
+      // Search directions P and the workspace W for the next ones
+      MultiVector *P = &M1, *W = &M2;
+      *P = Z;
+      int r = Orthonormalize(*P);
+      DenseMatrix PtQ, PtR, QtZ, alpha, beta;
+      final_iter = max_iter;
+      for (int i = 1; r > 0; )
+      {
+         MultiVector Pr(P->GetData(), n, r), Qr(W->GetData(), n, r);
+         oper->BatchMult(Pr, Qr);
+         Pr.InnerProducts(Qr, PtQ);
+         Pr.InnerProducts(R, PtR);
+         dots.SetSize(r*r + r*nv);
+         std::copy(PtQ.Data(), PtQ.Data() + r*r, dots.GetData());
+         std::copy(PtR.Data(), PtR.Data() + r*nv, dots.GetData() + r*r);
+         StartDots(dots.GetData(), dots.Size());
+         FinishDots();
+         std::copy(dots.GetData(), dots.GetData() + r*r, PtQ.Data());
+         std::copy(dots.GetData() + r*r, dots.GetData() + dots.Size(),
+                   PtR.Data());
+
+         DenseMatrixInverse PtQ_inv(PtQ);
+         PtQ_inv.Mult(PtR, alpha);   // alpha = (P^T A P)^{-1} P^T R
+         X.AddMult(Pr, alpha);       // X = X + P alpha
+         R.AddMult(Qr, alpha, -1.0); // R = R - A P alpha
+         if (prec)
+         {
+            prec->BatchMult(R, Z);   // Z = M R
+         }
+         else
+         {
+            Z = R;
+         }
+
+         Qr.InnerProducts(Z, QtZ);
+         Z.Dots(R, nom);
+         dots.SetSize(r*nv + nv);
+         std::copy(QtZ.Data(), QtZ.Data() + r*nv, dots.GetData());
+         std::copy(nom.GetData(), nom.GetData() + nv, dots.GetData() + r*nv);
+         StartDots(dots.GetData(), dots.Size());
+         FinishDots();
+         std::copy(dots.GetData(), dots.GetData() + r*nv, QtZ.Data());
+         std::copy(dots.GetData() + r*nv, dots.GetData() + dots.Size(),
+                   nom.GetData());
+
+         if (print_level == 1)
+         {
+            mfem::out << "   Iteration : " << setw(3) << i
+                      << "  max (B r, r) = " << nom.Max() << '\n';
+         }
+         done = true;
+         for (int j = 0; j < nv; j++) { done = done && (nom(j) <= r0(j)); }
+         if (done)
+         {
+            if (print_level == 2)
+            {
+               mfem::out << "Number of block PCG iterations: " << i << '\n';
+            }
+            else if (print_level == 3)
+            {
+               mfem::out << "   Iteration : " << setw(3) << i
+                         << "  max (B r, r) = " << nom.Max() << '\n';
+            }
+            converged = 1;
+            final_iter = i;
+            break;
+         }
+         if (++i > max_iter)
+         {
+            break;
+         }
+
+         // W = Z + P beta with beta = -(P^T A P)^{-1} Q^T Z
+         PtQ_inv.Mult(QtZ, beta);
+         MultiVector &Wnv = *W;
+         Wnv = Z;
+         Wnv.AddMult(Pr, beta, -1.0);
+         r = Orthonormalize(Wnv);
+         std::swap(P, W);
+      }
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "Block PCG: No convergence!" << '\n';
+   }
+   if (print_level >= 1 || (print_level >= 0 && !converged))
+   {
+      double red = 0.0;
+      for (int j = 0; j < nv; j++)
+      {
+         if (nom0(j) > 0.0) { red = std::max(red, nom(j)/nom0(j)); }
+      }
+      mfem::out << "Average reduction factor = "
+                << pow (red, 0.5/std::max(final_iter, 1)) << '\n';
+   }
+   final_norm = sqrt(nom.Max());
+}
+
+void BlockCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   const MultiVector B(const_cast<double*>(b.GetData()), b.Size(), 1);
+   MultiVector X(x.GetData(), x.Size(), 1);
+   BatchMult(B, X);
+}
+
+RecyclingCGSolver::RecyclingCGSolver()
+   : k(8), m(16), nw(0), AW_valid(false), np(0)
+{ }
+
+#ifdef MFEM_USE_MPI
+RecyclingCGSolver::RecyclingCGSolver(MPI_Comm _comm)
+   : IterativeSolver(_comm), k(8), m(16), nw(0), AW_valid(false), np(0)
+{ }
+#endif
+
+void RecyclingCGSolver::UpdateVectors()
+{
+   r.SetSize(width);
+   z.SetSize(width);
+   p.SetSize(width);
+   q.SetSize(width);
+   W.SetSize(width, k);
+   AW.SetSize(width, k);
+   P.SetSize(width, m);
+   AP.SetSize(width, m);
+}
+
+void RecyclingCGSolver::SetRecycleDim(int k_, int m_)
+{
+   k = k_;
+   m = m_;
+   UpdateVectors();
+   ResetRecycledSpace();
+}
+
+void RecyclingCGSolver::SetOperator(const Operator &op)
+{
+   const int old_width = width;
+   IterativeSolver::SetOperator(op);
+   if (width != old_width || W.VectorSize() != width)
+   {
+      UpdateVectors();
+      ResetRecycledSpace();
+   }
+   AW_valid = false;
+}
+
+void RecyclingCGSolver::SetupDeflation() const
+{
+   MultiVector Wv(W.GetData(), width, nw), AWv(AW.GetData(), width, nw);
+   oper->BatchMult(Wv, AWv);
+   Wv.InnerProducts(AWv, WtAW);
+   StartDots(WtAW.Data(), nw*nw);
+   FinishDots();
+   WtAW.Symmetrize();
+   WtAW_inv.Factor(WtAW);
+   AW_valid = true;
+}
+
+double RecyclingCGSolver::DeflationCoefficients(Vector &mu) const
+{
+   mu.SetSize(nw + 1);
+   if (nw > 0)
+   {
+      MultiVector AWv(AW.GetData(), width, nw), Z(z.GetData(), width, 1);
+      DenseMatrix AWtz(mu.GetData(), nw, 1);
+      AWv.InnerProducts(Z, AWtz);
+   }
+   mu(nw) = z * r;
+   StartDots(mu.GetData(), nw + 1);
+   FinishDots();
+   const double nom = mu(nw);
+   mu.SetSize(nw);
+   if (nw > 0)
+   {
+      Vector rhs(mu);
+      WtAW_inv.Mult(rhs, mu);
+   }
+   return nom;
+}
+
+void RecyclingCGSolver::UpdateRecycledSpace() const
+{
+   const int nz = nw + np;
+   if (np == 0) { return; }
+
+   // Basis Z = [W, P] of the Rayleigh-Ritz space and A Z = [A W, A P]
+   MultiVector Z(width, nz), AZ(width, nz);
+   std::copy(W.GetData(), W.GetData() + nw*width, Z.GetData());
+   std::copy(P.GetData(), P.GetData() + np*width, Z.GetData() + nw*width);
+   std::copy(AW.GetData(), AW.GetData() + nw*width, AZ.GetData());
+   std::copy(AP.GetData(), AP.GetData() + np*width, AZ.GetData() + nw*width);
+
+   // G = Z^T A Z and F = Z^T Z with one reduction
+   DenseMatrix G, F;
+   Z.InnerProducts(AZ, G);
+   Z.InnerProducts(Z, F);
+   Vector dots(2*nz*nz);
+   std::copy(G.Data(), G.Data() + nz*nz, dots.GetData());
+   std::copy(F.Data(), F.Data() + nz*nz, dots.GetData() + nz*nz);
+   StartDots(dots.GetData(), dots.Size());
+   FinishDots();
+   std::copy(dots.GetData(), dots.GetData() + nz*nz, G.Data());
+   std::copy(dots.GetData() + nz*nz, dots.GetData() + 2*nz*nz, F.Data());
+   G.Symmetrize();
+
+   // The Ritz problem G y = theta F y is equivalent to L^{-1} F L^{-T} v =
+   // (1/theta) v with G = L L^T and y = L^{-T} v, so the smallest Ritz values
+   // correspond to the largest eigenvalues.
+   DenseMatrix L(nz);
+   L = 0.0;
+   for (int j = 0; j < nz; j++)
+   {
+      double d = G(j,j);
+      for (int t = 0; t < j; t++) { d -= L(j,t)*L(j,t); }
+      if (!(d > 0.0)) { return; } // not positive definite, keep W
+      L(j,j) = sqrt(d);
+      for (int i = j+1; i < nz; i++)
+      {
+         double c = G(i,j);
+         for (int t = 0; t < j; t++) { c -= L(i,t)*L(j,t); }
+         L(i,j) = c / L(j,j);
+      }
+   }
+   // C = L^{-1} F L^{-T}
+   DenseMatrix C(F);
+   for (int c = 0; c < nz; c++) // columns: C = L^{-1} F
+   {
+      for (int i = 0; i < nz; i++)
+      {
+         for (int t = 0; t < i; t++) { C(i,c) -= L(i,t)*C(t,c); }
+         C(i,c) /= L(i,i);
+      }
+   }
+   for (int rw = 0; rw < nz; rw++) // rows: C = C L^{-T}
+   {
+      for (int j = 0; j < nz; j++)
+      {
+         for (int t = 0; t < j; t++) { C(rw,j) -= C(rw,t)*L(j,t); }
+         C(rw,j) /= L(j,j);
+      }
+   }
+   Vector ev;
+   DenseMatrix V;
+   C.Eigensystem(ev, V);
+
+   // Y = L^{-T} V for the k largest eigenvalues
+   const int knew = std::min(k, nz);
+   DenseMatrix Y(nz, knew);
+   for (int j = 0; j < knew; j++)
+   {
+      for (int i = nz-1; i >= 0; i--)
+      {
+         double y = V(i, nz-1-j);
+         for (int t = i+1; t < nz; t++) { y -= L(t,i)*Y(t,j); }
+         Y(i,j) = y / L(i,i);
+      }
+   }
+   nw = knew;
+   MultiVector Wv(W.GetData(), width, nw), AWv(AW.GetData(), width, nw);
+   Wv = 0.0;
+   AWv = 0.0;
+   Wv.AddMult(Z, Y);
+   AWv.AddMult(AZ, Y);
+
+   // W^T A W = Y^T G Y, without communication
+   DenseMatrix GY(nz, nw);
+   mfem::Mult(G, Y, GY);
+   WtAW.SetSize(nw);
+   MultAtB(Y, GY, WtAW);
+   WtAW.Symmetrize();
+   WtAW_inv.Factor(WtAW);
+   AW_valid = true;
+}
+
+void RecyclingCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   double r0, den, nom, nom0, betanom, alpha, beta;
+   Vector mu;
+
+   if (nw > 0 && !AW_valid) { SetupDeflation(); }
+   MultiVector Wv(W.GetData(), width, nw), AWv(AW.GetData(), width, nw);
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+
+   if (nw > 0)
+   {
+      // Make r orthogonal to W: x += W (W^T A W)^{-1} W^T r
+      DenseMatrix Wtr(nw, 1), c(nw, 1);
+      MultiVector R(r.GetData(), width, 1), X(x.GetData(), width, 1);
+      Wv.InnerProducts(R, Wtr);
+      StartDots(Wtr.Data(), nw);
+      FinishDots();
+      WtAW_inv.Mult(Wtr, c);
+      X.AddMult(Wv, c);
+      R.AddMult(AWv, c, -1.0);
    }
 
    if (prec)
    {
       prec->Mult(r, z); // z = B r
-      d = z;
    }
    else
    {
-      d = r;
+      z = r;
    }
-   nom0 = nom = Dot(d, r);
+   // d = z - W mu, with mu = (W^T A W)^{-1} (A W)^T z
+   nom0 = nom = DeflationCoefficients(mu);
    MFEM_ASSERT(IsFinite(nom), "nom = " << nom);
+   p = z;
+   if (nw > 0)
+   {
+      MultiVector Pd(p.GetData(), width, 1);
+      DenseMatrix Mu(mu.GetData(), nw, 1);
+      Pd.AddMult(Wv, Mu, -1.0);
+   }
 
    if (print_level == 1 || print_level == 3)
    {
@@ -326,50 +1135,53 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
                 << nom << (print_level == 3 ? " ...\n" : "\n");
    }
 
+   np = 0;
    r0 = std::max(nom*rel_tol*rel_tol, abs_tol*abs_tol);
+   betanom = nom;
+   converged = 0;
+   final_iter = max_iter;
    if (nom <= r0)
    {
       converged = 1;
       final_iter = 0;
-      final_norm = sqrt(nom);
-      return;
-   }
-
-   oper->Mult(d, z);  // z = A d
-   den = Dot(z, d);
-   MFEM_ASSERT(IsFinite(den), "den = " << den);
-
-   if (print_level >= 0 && den < 0.0)
-   {
-      mfem::out << "Negative denominator in step 0 of PCG: " << den << '\n';
    }
-
-   if (den == 0.0)
+   for (int i = 1; !converged; )
    {
-      converged = 0;
-      final_iter = 0;
-      final_norm = sqrt(nom);
-      return;
-   }
+      oper->Mult(p, q);  //  q = A d
+      den = Dot(p, q);
+      MFEM_ASSERT(IsFinite(den), "den = " << den);
+      if (den <= 0.0)
+      {
+         if (print_level >= 0 && Dot(p, p) > 0.0)
+            mfem::out << "PCG: The operator is not positive definite. (Ad, d) = "
+                      << den << '\n';
+         if (den == 0.0) { final_iter = i - 1; break; }
+      }
+      else if (np < m)
+      {
+         // Keep the A-normalized search direction for the subspace update
+         const double s = 1.0/sqrt(den);
+         std::copy(p.GetData(), p.GetData() + width, P.GetVectorData(np));
+         std::copy(q.GetData(), q.GetData() + width, AP.GetVectorData(np));
+         Vector pv(P.GetVectorData(np), width), qv(AP.GetVectorData(np), width);
+         pv *= s;
+         qv *= s;
+         np++;
+      }
 
-   // start iteration
-   converged = 0;
-   final_iter = max_iter;
-   for (i = 1; true; )
-   {
       alpha = nom/den;
-      add(x,  alpha, d, x);     //  x = x + alpha d
-      add(r, -alpha, z, r);     //  r = r - alpha A d
+      add(x,  alpha, p, x);     //  x = x + alpha d
+      add(r, -alpha, q, r);     //  r = r - alpha A d
 
       if (prec)
       {
          prec->Mult(r, z);      //  z = B r
-         betanom = Dot(r, z);
       }
       else
       {
-         betanom = Dot(r, r);
+         z = r;
       }
+      betanom = DeflationCoefficients(mu);
       MFEM_ASSERT(IsFinite(betanom), "betanom = " << betanom);
 
       if (print_level == 1)
@@ -400,22 +1212,12 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
       }
 
       beta = betanom/nom;
-      if (prec)
-      {
-         add(z, beta, d, d);   //  d = z + beta d
-      }
-      else
-      {
-         add(r, beta, d, d);
-      }
-      oper->Mult(d, z);       //  z = A d
-      den = Dot(d, z);
-      MFEM_ASSERT(IsFinite(den), "den = " << den);
-      if (den <= 0.0)
+      add(z, beta, p, p);       //  d = z + beta d - W mu
+      if (nw > 0)
       {
-         if (print_level >= 0 && Dot(d, d) > 0.0)
-            mfem::out << "PCG: The operator is not positive definite. (Ad, d) = "
-                      << den << '\n';
+         MultiVector Pd(p.GetData(), width, 1);
+         DenseMatrix Mu(mu.GetData(), nw, 1);
+         Pd.AddMult(Wv, Mu, -1.0);
       }
       nom = betanom;
    }
@@ -428,17 +1230,19 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
             mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
                       << nom0 << " ...\n";
          }
-         mfem::out << "   Iteration : " << setw(3) << final_iter << "  (B r, r) = "
-                   << betanom << '\n';
+         mfem::out << "   Iteration : " << setw(3) << final_iter
+                   << "  (B r, r) = " << betanom << '\n';
       }
       mfem::out << "PCG: No convergence!" << '\n';
    }
    if (print_level >= 1 || (print_level >= 0 && !converged))
    {
       mfem::out << "Average reduction factor = "
-                << pow (betanom/nom0, 0.5/final_iter) << '\n';
+                << pow (betanom/nom0, 0.5/std::max(final_iter, 1)) << '\n';
    }
    final_norm = sqrt(betanom);
+
+   UpdateRecycledSpace();
 }
 
 void CG(const Operator &A, const Vector &b, Vector &x,
@@ -606,13 +1410,8 @@ void GMRESSolver::Mult(const Vector &b, Vector &x) const
             oper->Mult(*v[i], w);
          }
 
-         for (k = 0; k <= i; k++)
-         {
-            H(k,i) = Dot(w, *v[k]);  // H(k,i) = w * v[k]
-            w.Add(-H(k,i), *v[k]);   // w -= H(k,i) * v[k]
-         }
-
-         H(i+1,i) = Norm(w);           // H(i+1,i) = ||w||
+         // H(k,i) = w * v[k], w -= H(k,i) * v[k], H(i+1,i) = ||w||
+         Orthogonalize(orthog, v, i, w, H.GetColumn(i));
          MFEM_ASSERT(IsFinite(H(i+1,i)), "Norm(w) = " << H(i+1,i));
          if (v[i+1] == NULL) { v[i+1] = new Vector(n); }
          v[i+1]->Set(1.0/H(i+1,i), w); // v[i+1] = w / H(i+1,i)
@@ -768,13 +1567,8 @@ void FGMRESSolver::Mult(const Vector &b, Vector &x) const
          }
          oper->Mult(*z[i], r);
 
-         for (k = 0; k <= i; k++)
-         {
-            H(k,i) = Dot( r, *v[k]); // H(k,i) = r * v[k]
-            r.Add(-H(k,i), (*v[k])); // r -= H(k,i) * v[k]
-         }
-
-         H(i+1,i)  = Norm(r);       // H(i+1,i) = ||r||
+         // H(k,i) = r * v[k], r -= H(k,i) * v[k], H(i+1,i) = ||r||
+         Orthogonalize(orthog, v, i, r, H.GetColumn(i));
          if (v[i+1] == NULL) { v[i+1] = new Vector(b.Size()); }
          (*v[i+1]) = 0.0;
          v[i+1] -> Add (1.0/H(i+1,i), r); // v[i+1] = r / H(i+1,i)
@@ -846,6 +1640,243 @@ void FGMRESSolver::Mult(const Vector &b, Vector &x) const
 }
 
 
+RecyclingGMRESSolver::RecyclingGMRESSolver()
+   : m(30), k(10), orthog(GramSchmidt::MODIFIED), nu(0), next(0),
+     C_valid(false)
+{ }
+
+#ifdef MFEM_USE_MPI
+RecyclingGMRESSolver::RecyclingGMRESSolver(MPI_Comm _comm)
+   : IterativeSolver(_comm), m(30), k(10), orthog(GramSchmidt::MODIFIED),
+     nu(0), next(0), C_valid(false)
+{ }
+#endif
+
+void RecyclingGMRESSolver::SetRecycleDim(int k_)
+{
+   k = k_;
+   U.SetSize(width, k);
+   C.SetSize(width, k);
+   ResetRecycledSpace();
+}
+
+void RecyclingGMRESSolver::SetOperator(const Operator &op)
+{
+   const int old_width = width;
+   IterativeSolver::SetOperator(op);
+   if (width != old_width || U.VectorSize() != width)
+   {
+      U.SetSize(width, k);
+      C.SetSize(width, k);
+      ResetRecycledSpace();
+   }
+   C_valid = false;
+}
+
+void RecyclingGMRESSolver::SetupRecycledSpace() const
+{
+   MultiVector Uv(U.GetData(), width, nu), Cv(C.GetData(), width, nu);
+   oper->BatchMult(Uv, Cv);
+   nu = Orthonormalize(Cv, &Uv);
+   next = nu % k;
+   C_valid = true;
+}
+
+void RecyclingGMRESSolver::AddRecycledVector(Vector &u, Vector &c) const
+{
+   if (k == 0) { return; }
+   std::copy(u.GetData(), u.GetData() + width, U.GetVectorData(next));
+   std::copy(c.GetData(), c.GetData() + width, C.GetVectorData(next));
+   // The oldest vector is replaced when the subspace is full
+   next = (next + 1) % k;
+   nu = std::min(nu + 1, k);
+}
+
+void RecyclingGMRESSolver::Mult(const Vector &b, Vector &x) const
+{
+   const int n = width;
+   DenseMatrix H(m+1, m), B;
+   Vector s(m+1), cs(m+1), sn(m+1), y;
+   Vector r(n), w(n), t(n), u(n), c(n);
+   Array<Vector *> v(m+1);
+   v = NULL;
+
+   if (nu > 0 && !C_valid) { SetupRecycledSpace(); }
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r);     // r = b - A x
+   }
+   else
+   {
+      x = 0.0;
+      r = b;
+   }
+   double beta = Norm(r);
+   MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+   final_norm = std::max(rel_tol*beta, abs_tol);
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  ||r|| = " << beta << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   // Minimize the residual over the recycled subspace: x += U C^T r
+   if (nu > 0 && beta > final_norm)
+   {
+      MultiVector Uv(U.GetData(), n, nu), Cv(C.GetData(), n, nu);
+      MultiVector R(r.GetData(), n, 1), X(x.GetData(), n, 1);
+      DenseMatrix Ctr;
+      Cv.InnerProducts(R, Ctr);
+      StartDots(Ctr.Data(), nu);
+      FinishDots();
+      X.AddMult(Uv, Ctr);
+      R.AddMult(Cv, Ctr, -1.0);
+      beta = Norm(r);
+   }
+
+   int it = 0, i = 0;
+   while (beta > final_norm && it < max_iter)
+   {
+      MultiVector Uv(U.GetData(), n, nu), Cv(C.GetData(), n, nu);
+      B.SetSize(nu, m);
+      if (v[0] == NULL) { v[0] = new Vector(n); }
+      v[0]->Set(1.0/beta, r);
+      s = 0.0; s(0) = beta;
+
+      // Arnoldi process for (I - C C^T) A M
+      double resid = beta;
+      for (i = 0; i < m && it < max_iter; )
+      {
+         if (prec)
+         {
+            prec->Mult(*v[i], t);
+            oper->Mult(t, w);        // w = A M v[i]
+         }
+         else
+         {
+            oper->Mult(*v[i], w);
+         }
+         if (nu > 0)
+         {
+            // B(:,i) = C^T w, w -= C B(:,i)
+            MultiVector Wm(w.GetData(), n, 1);
+            DenseMatrix Bi(B.GetColumn(i), nu, 1);
+            Cv.InnerProducts(Wm, Bi);
+            StartDots(Bi.Data(), nu);
+            FinishDots();
+            Wm.AddMult(Cv, Bi, -1.0);
+         }
+         Orthogonalize(orthog, v, i, w, H.GetColumn(i));
+         MFEM_ASSERT(IsFinite(H(i+1,i)), "Norm(w) = " << H(i+1,i));
+         if (v[i+1] == NULL) { v[i+1] = new Vector(n); }
+         v[i+1]->Set(1.0/H(i+1,i), w);
+
+         for (int l = 0; l < i; l++)
+         {
+            ApplyPlaneRotation(H(l,i), H(l+1,i), cs(l), sn(l));
+         }
+         GeneratePlaneRotation(H(i,i), H(i+1,i), cs(i), sn(i));
+         ApplyPlaneRotation(H(i,i), H(i+1,i), cs(i), sn(i));
+         ApplyPlaneRotation(s(i), s(i+1), cs(i), sn(i));
+
+         resid = fabs(s(i+1));
+         MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
+         i++;
+         it++;
+         if (print_level == 1)
+         {
+            mfem::out << "   Pass : " << setw(2) << (it-1)/m+1
+                      << "   Iteration : " << setw(3) << it
+                      << "  ||r|| = " << resid << '\n';
+         }
+         if (resid <= final_norm) { break; }
+      }
+
+      // Solve the least squares problem, y = H^{-1} s
+      y.SetSize(i);
+      for (int l = i-1; l >= 0; l--)
+      {
+         y(l) = s(l);
+         for (int q = l+1; q < i; q++) { y(l) -= H(l,q) * y(q); }
+         y(l) /= H(l,l);
+      }
+
+      // Correction of the cycle u = M V y - U B y and its image c = A u
+      t = 0.0;
+      for (int l = 0; l < i; l++) { t.Add(y(l), *v[l]); }
+      if (prec)
+      {
+         prec->Mult(t, u);
+      }
+      else
+      {
+         u = t;
+      }
+      if (nu > 0)
+      {
+         DenseMatrix By(nu, 1), Bi(B.Data(), nu, i), Y(y.GetData(), i, 1);
+         mfem::Mult(Bi, Y, By);
+         MultiVector Um(u.GetData(), n, 1);
+         Um.AddMult(Uv, By, -1.0);
+      }
+      oper->Mult(u, c);
+      x += u;
+      r -= c;
+      beta = Norm(r);
+      MFEM_ASSERT(IsFinite(beta), "beta = " << beta);
+
+      // Add the normalized correction to the recycled subspace, keeping C
+      // orthonormal
+      if (nu > 0)
+      {
+         MultiVector Cm(c.GetData(), n, 1), Um(u.GetData(), n, 1);
+         DenseMatrix Ctc;
+         Cv.InnerProducts(Cm, Ctc);
+         StartDots(Ctc.Data(), nu);
+         FinishDots();
+         Cm.AddMult(Cv, Ctc, -1.0);
+         Um.AddMult(Uv, Ctc, -1.0);
+      }
+      const double cnorm = Norm(c);
+      if (cnorm > 0.0)
+      {
+         u /= cnorm;
+         c /= cnorm;
+         AddRecycledVector(u, c);
+      }
+
+      if (print_level == 1 && beta > final_norm && it < max_iter)
+      {
+         mfem::out << "Restarting..." << '\n';
+      }
+   }
+
+   final_iter = it;
+   converged = (beta <= final_norm);
+   final_norm = beta;
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << std::max(final_iter-1, 0)/m+1
+                << "   Iteration : " << setw(3) << final_iter
+                << "  ||r|| = " << final_norm << '\n';
+   }
+   else if (print_level == 2)
+   {
+      mfem::out << "GMRES: Number of iterations: " << final_iter << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "GMRES: No convergence!\n";
+   }
+   for (int l = 0; l < v.Size(); l++)
+   {
+      delete v[l];
+   }
+}
+
 int GMRES(const Operator &A, Vector &x, const Vector &b, Solver &M,
           int &max_iter, int m, double &tol, double atol, int printit)
 {
@@ -890,6 +1921,7 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
    int i;
    double resid, tol_goal;
    double rho_1, rho_2=1.0, alpha=1.0, beta, omega=1.0;
+   double dots[2];
 
    if (iterative_mode)
    {
@@ -919,9 +1951,9 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
       return;
    }
 
+   rho_1 = Dot(rtilde, r);
    for (i = 1; i <= max_iter; i++)
    {
-      rho_1 = Dot(rtilde, r);
       if (rho_1 == 0)
       {
          if (print_level >= 0)
@@ -939,8 +1971,8 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
       else
       {
          beta = (rho_1/rho_2) * (alpha/omega);
-         add(p, -omega, v, p);  //  p = p - omega * v
-         add(r, beta, p, p);    //  p = r + beta * p
+         //  p = r + beta * (p - omega * v)
+         AddAndDot(1.0, r, -beta*omega, v, beta, p);
       }
       if (prec)
       {
@@ -952,8 +1984,9 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
       }
       oper->Mult(phat, v);     //  v = A * phat
       alpha = rho_1 / Dot(rtilde, v);
-      add(r, -alpha, v, s); //  s = r - alpha * v
-      resid = Norm(s);
+      resid = AddAndDot(1.0, r, -alpha, v, 0.0, s, &s); //  s = r - alpha * v
+      SumDots(&resid, 1);
+      resid = sqrt(resid);
       MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
       if (resid < tol_goal)
       {
@@ -978,13 +2011,20 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
          shat = s;
       }
       oper->Mult(shat, t);     //  t = A * shat
-      omega = Dot(t, s) / Dot(t, t);
-      x.Add(alpha, phat);   //  x += alpha * phat
-      x.Add(omega, shat);   //  x += omega * shat
-      add(s, -omega, t, r); //  r = s - omega * t
+      const Vector *ts[2] = { &s, &t };
+      MultiDot(2, ts, t, dots); //  (s, t), (t, t)
+      SumDots(dots, 2);
+      omega = dots[0] / dots[1];
+      //  x += alpha * phat + omega * shat
+      AddAndDot(alpha, phat, omega, shat, 1.0, x);
+      AddAndDot(1.0, s, -omega, t, 0.0, r); //  r = s - omega * t
 
       rho_2 = rho_1;
-      resid = Norm(r);
+      const Vector *rr[2] = { &r, &rtilde };
+      MultiDot(2, rr, r, dots); //  (r, r), (rtilde, r)
+      SumDots(dots, 2);
+      resid = sqrt(dots[0]);
+      rho_1 = dots[1];
       MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
       if (print_level >= 0)
       {
@@ -1057,7 +2097,7 @@ void MINRESSolver::Mult(const Vector &b, Vector &x) const
 
    int it;
    double beta, eta, gamma0, gamma1, sigma0, sigma1;
-   double alpha, delta, rho1, rho2, rho3, norm_goal;
+   double alpha, delta, rho1, rho2, rho3, norm_goal, vnorm;
    Vector *z = (prec) ? &u1 : &v1;
 
    converged = 1;
@@ -1106,18 +2146,17 @@ void MINRESSolver::Mult(const Vector &b, Vector &x) const
       oper->Mult(*z, q);
       alpha = Dot(*z, q);
       MFEM_ASSERT(IsFinite(alpha), "alpha = " << alpha);
-      if (it > 1) // (v0 == 0) for (it == 1)
-      {
-         q.Add(-beta, v0);
-      }
-      add(q, -alpha, v1, v0);
+      //  v0 = q - alpha v1 - beta v0  (v0 == 0 for it == 1), and (v0, v0)
+      vnorm = AddAndDot(1.0, q, -alpha, v1, (it > 1) ? -beta : 0.0, v0,
+                        prec ? NULL : &v0);
 
       delta = gamma1*alpha - gamma0*sigma1*beta;
       rho3 = sigma0*beta;
       rho2 = sigma1*alpha + gamma0*gamma1*beta;
       if (!prec)
       {
-         beta = Norm(v0);
+         SumDots(&vnorm, 1);
+         beta = sqrt(vnorm);
       }
       else
       {
@@ -1131,14 +2170,11 @@ void MINRESSolver::Mult(const Vector &b, Vector &x) const
       {
          w0.Set(1./rho1, *z);   // (w0 == 0) and (w1 == 0)
       }
-      else if (it == 2)
-      {
-         add(1./rho1, *z, -rho2/rho1, w1, w0);   // (w0 == 0)
-      }
       else
       {
-         add(-rho3/rho1, w0, -rho2/rho1, w1, w0);
-         w0.Add(1./rho1, *z);
+         //  w0 = (z - rho2 w1 - rho3 w0) / rho1  (w0 == 0 for it == 2)
+         AddAndDot(1./rho1, *z, -rho2/rho1, w1,
+                   (it > 2) ? -rho3/rho1 : 0.0, w0);
       }
 
       gamma0 = gamma1;
@@ -1320,6 +2356,187 @@ void NewtonSolver::Mult(const Vector &b, Vector &x) const
 }
 
 
+InitialGuessExtrapolator::InitialGuessExtrapolator(Type type_, int k)
+   : type(type_), oper(NULL)
+{
+#ifdef MFEM_USE_MPI
+   dot_prod_type = 0;
+#endif
+   t = 0.0;
+   SetHistorySize(k);
+}
+
+#ifdef MFEM_USE_MPI
+InitialGuessExtrapolator::InitialGuessExtrapolator(MPI_Comm comm_, Type type_,
+                                                   int k)
+   : type(type_), oper(NULL)
+{
+   dot_prod_type = 1;
+   comm = comm_;
+   t = 0.0;
+   SetHistorySize(k);
+}
+#endif
+
+void InitialGuessExtrapolator::Reduce(double *dots, int n) const
+{
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0)
+   {
+      MPI_Allreduce(MPI_IN_PLACE, dots, n, MPI_DOUBLE, MPI_SUM, comm);
+   }
+#endif
+}
+
+void InitialGuessExtrapolator::SetHistorySize(int k)
+{
+   MFEM_VERIFY(k > 0, "invalid history size: " << k);
+   X.SetSize(X.VectorSize(), k);
+   AX.SetSize(AX.VectorSize(), k);
+   AX_valid.SetSize(k);
+   AX_valid = false;
+   times.SetSize(k);
+   Reset();
+}
+
+void InitialGuessExtrapolator::SetOperator(const Operator &op)
+{
+   oper = &op;
+   AX_valid = false;
+}
+
+void InitialGuessExtrapolator::Add(const Vector &x)
+{
+   const int k = times.Size();
+   if (X.VectorSize() != x.Size())
+   {
+      X.SetSize(x.Size(), k);
+      Reset();
+   }
+   Vector xj;
+   X.GetVectorView(next, xj);
+   xj = x;
+   times(next) = t;
+   AX_valid[next] = false;
+   next = (next + 1) % k;
+   nx = std::min(nx + 1, k);
+   t += 1.0;
+}
+
+void InitialGuessExtrapolator::GetInitialGuess(const Vector &b, Vector &x)
+{
+   if (nx == 0)
+   {
+      x = 0.0;
+      return;
+   }
+   const int n = X.VectorSize();
+   MFEM_VERIFY(x.Size() == n, "incompatible vector size");
+   // The first nx vectors are the stored ones, in ring buffer order
+   const MultiVector Xv(X.GetData(), n, nx);
+   MultiVector xv(x.GetData(), n, 1);
+   DenseMatrix c(nx, 1);
+   c = 0.0;
+
+   if (type == POLYNOMIAL)
+   {
+      // Lagrange basis functions of the stored times evaluated at t
+      bool distinct = true;
+      for (int i = 0; i < nx; i++)
+      {
+         c(i,0) = 1.0;
+         for (int j = 0; j < nx; j++)
+         {
+            if (j == i) { continue; }
+            if (times(i) == times(j)) { distinct = false; }
+            c(i,0) *= (t - times(j)) / (times(i) - times(j));
+         }
+      }
+      if (!distinct)
+      {
+         // Use the most recent solution
+         c = 0.0;
+         c((next + nx - 1) % nx, 0) = 1.0;
+      }
+   }
+   else
+   {
+      MFEM_VERIFY(oper != NULL, "the Operator is not set (use SetOperator).");
+      MFEM_VERIFY(oper->Width() == n && oper->Height() == b.Size(),
+                  "incompatible Operator");
+      const int m = b.Size(), k = times.Size();
+      if (AX.VectorSize() != m)
+      {
+         AX.SetSize(m, k);
+         AX_valid = false;
+      }
+      MultiVector AXv(AX.GetData(), m, nx);
+      int nvalid = 0;
+      for (int j = 0; j < nx; j++) { nvalid += AX_valid[j]; }
+      if (nvalid == 0)
+      {
+         oper->BatchMult(Xv, AXv);
+      }
+      else
+      {
+         Vector xj, axj;
+         for (int j = 0; j < nx; j++)
+         {
+            if (AX_valid[j]) { continue; }
+            Xv.GetVectorView(j, xj);
+            AXv.GetVectorView(j, axj);
+            oper->Mult(xj, axj);
+         }
+      }
+      for (int j = 0; j < nx; j++) { AX_valid[j] = true; }
+
+      // Normal equations (AX)^T AX c = (AX)^T b with one global reduction
+      DenseMatrix G, g;
+      const MultiVector bv(const_cast<double*>(b.GetData()), m, 1);
+      AXv.InnerProducts(AXv, G);
+      AXv.InnerProducts(bv, g);
+      Vector dots(nx*nx + nx);
+      std::copy(G.Data(), G.Data() + nx*nx, dots.GetData());
+      std::copy(g.Data(), g.Data() + nx, dots.GetData() + nx*nx);
+      Reduce(dots.GetData(), dots.Size());
+      std::copy(dots.GetData(), dots.GetData() + nx*nx, G.Data());
+
+      // Solve T^T T c_sel = g_sel, dropping dependent vectors
+      DenseMatrix T;
+      Array<int> sel;
+      DroppingCholesky(G, T, sel);
+      const int r = sel.Size();
+      Vector y(r);
+      for (int i = 0; i < r; i++)
+      {
+         double d = dots(nx*nx + sel[i]);
+         for (int j = 0; j < i; j++) { d -= T(j,i) * y(j); }
+         y(i) = d / T(i,i);
+      }
+      for (int i = r - 1; i >= 0; i--)
+      {
+         double d = y(i);
+         for (int j = i + 1; j < r; j++) { d -= T(i,j) * y(j); }
+         y(i) = d / T(i,i);
+         c(sel[i],0) = y(i);
+      }
+   }
+
+   x = 0.0;
+   xv.AddMult(Xv, c);
+}
+
+void InitialGuessExtrapolator::Mult(Solver &solver, const Vector &b,
+                                    Vector &x)
+{
+   GetInitialGuess(b, x);
+   const bool mode = solver.iterative_mode;
+   solver.iterative_mode = true;
+   solver.Mult(b, x);
+   solver.iterative_mode = mode;
+   Add(x);
+}
+
 int aGMRES(const Operator &A, Vector &x, const Vector &b,
            const Operator &M, int &max_iter,
            int m_max, int m_min, int m_step, double cf,
@@ -14,6 +14,8 @@
 
 #include "../config/config.hpp"
 #include "operator.hpp"
+#include "multivector.hpp"
+#include "densemat.hpp"
 
 #ifdef MFEM_USE_MPI
 #include <mpi.h>
@@ -28,6 +30,22 @@
 namespace mfem
 {
 
+/// Gram-Schmidt variants for the orthogonalization of Krylov bases.
+class GramSchmidt
+{
+public:
+   enum Type
+   {
+      /// Modified Gram-Schmidt, with one global reduction per basis vector.
+      MODIFIED,
+      /** @brief Classical Gram-Schmidt with reorthogonalization (CGS2). Each
+          of the two passes computes all dot products with one fused kernel
+          and reduces them together, so an iteration needs two global
+          reductions, independently of the size of the basis. */
+      CLASSICAL_REORTH
+   };
+};
+
 /// Abstract base class for iterative solver
 class IterativeSolver : public Solver
 {
@@ -35,6 +53,7 @@ class IterativeSolver : public Solver
 private:
    int dot_prod_type; // 0 - local, 1 - global over 'comm'
    MPI_Comm comm;
+   mutable MPI_Request dots_request;
 #endif
 
 protected:
@@ -51,6 +70,33 @@ protected:
    double Dot(const Vector &x, const Vector &y) const;
    double Norm(const Vector &x) const { return sqrt(Dot(x, x)); }
 
+   /** @brief Start the global sum of the @a n local dot products in @a dots,
+       which are replaced with the global values by FinishDots(). */
+   /** In parallel, the reduction is nonblocking (MPI_Iallreduce), so it can
+       be overlapped with local work, e.g. operator applications. The array
+       @a dots must not be accessed before the call to FinishDots(). */
+   void StartDots(double *dots, int n) const;
+   /// Complete the global sum started with StartDots().
+   void FinishDots() const;
+   /** @brief Replace the @a n local dot products in @a dots with their
+       global sums, e.g. the results of the fused Vector kernels. */
+   void SumDots(double *dots, int n) const { StartDots(dots, n); FinishDots(); }
+
+   /** @brief Orthogonalize @a w against the orthonormal vectors v[0],...,v[k]
+       using the given Gram-Schmidt variant. */
+   /** The projection coefficients are returned in h[0],...,h[k] and the norm
+       of the orthogonalized @a w in h[k+1]. */
+   void Orthogonalize(GramSchmidt::Type type, const Array<Vector*> &v, int k,
+                      Vector &w, double *h) const;
+
+   /** @brief Orthonormalize the vectors of @a W in place, dropping linearly
+       dependent ones. Returns the number r of resulting vectors, which are
+       stored in the first r vectors of @a W. */
+   /** If @a U is not NULL, the same linear combinations are applied to its
+       vectors, e.g. to keep U = A^{-1} W. The Gram matrix of @a W is reduced
+       with a single global reduction (Cholesky QR). */
+   int Orthonormalize(MultiVector &W, MultiVector *U = NULL) const;
+
 public:
    IterativeSolver();
 
@@ -128,6 +174,141 @@ public:
    virtual void Mult(const Vector &b, Vector &x) const;
 };
 
+/// Pipelined conjugate gradient method
+/** The preconditioned pipelined CG method of Ghysels and Vanroose. Each
+    iteration needs a single global reduction for its two dot products, which
+    is started before and completed after the application of the
+    preconditioner and the operator, so that in parallel its latency is hidden
+    behind them. The convergence criterion and the print levels are the same
+    as in CGSolver.
+
+    In exact arithmetic, the iterates are the same as the ones of CGSolver.
+    The additional recurrences need more memory (9 vectors) and more vector
+    updates, and the propagation of rounding errors may limit the attainable
+    accuracy for very small tolerances. */
+class PipelinedCGSolver : public IterativeSolver
+{
+protected:
+   mutable Vector r, u, w, m, n, p, s, q, z;
+
+   void UpdateVectors();
+
+public:
+   PipelinedCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   PipelinedCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+/// Block conjugate gradient method for several right-hand sides
+/** Solves the systems for all vectors of a MultiVector together, see
+    BatchMult(), using the block Krylov space of all residuals. The operator
+    and the preconditioner are applied to all search directions at once with
+    Operator::BatchMult(), e.g. a sparse matrix is read once per iteration for
+    all right-hand sides, and each iteration needs three global reductions,
+    independently of the number of right-hand sides.
+
+    The search directions are orthonormalized in every iteration and linearly
+    dependent ones are dropped (breakdown-free block CG of Ji and Li), so the
+    method remains stable when some systems converge earlier than the others.
+    The iteration stops when (B r_j, r_j) satisfies the tolerances of
+    CGSolver for all right-hand sides j; GetFinalNorm() returns the largest
+    of their square roots. */
+class BlockCGSolver : public IterativeSolver
+{
+public:
+   BlockCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   BlockCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   /** @brief Solve A X_j = B_j for all vectors of @a B. If #iterative_mode is
+       true, @a X is used as initial guess. */
+   virtual void BatchMult(const MultiVector &B, MultiVector &X) const;
+
+   /// Solve a single system; this is equivalent to CGSolver.
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+/// Deflated conjugate gradient method with subspace recycling
+/** Intended for sequences of symmetric positive definite systems that change
+    slowly, e.g. in time stepping or in Newton iterations. Every solve is
+    deflated with a recycled subspace W: the initial residual is made
+    orthogonal to W and the search directions are kept A-orthogonal to W
+    (deflated CG of Saad, Yeung, Erhel and Guyomarc'h). After every solve, W
+    is replaced by the Ritz vectors for the smallest Ritz values of A in the
+    span of W and the first search directions of the solve, which approximate
+    the eigenvectors that slow down the convergence of CG.
+
+    When the operator changes, see SetOperator(), W is kept and A W is
+    recomputed with one Operator::BatchMult() call at the beginning of the
+    next solve. Call ResetRecycledSpace() when the operator changes
+    drastically. The convergence criterion and the print levels are the same
+    as in CGSolver. */
+class RecyclingCGSolver : public IterativeSolver
+{
+protected:
+   int k, m; // see SetRecycleDim()
+
+   /// @name The recycled subspace W (nw vectors) and A W.
+   ///@{
+   mutable MultiVector W, AW;
+   mutable int nw;
+   mutable DenseMatrix WtAW;
+   mutable DenseMatrixInverse WtAW_inv;
+   mutable bool AW_valid;
+   ///@}
+
+   /// The first np A-normalized search directions of a solve and their images.
+   mutable MultiVector P, AP;
+   mutable int np;
+
+   mutable Vector r, z, p, q;
+
+   void UpdateVectors();
+
+   /// Compute A W and factor W^T A W.
+   void SetupDeflation() const;
+
+   /** @brief Compute mu = (W^T A W)^{-1} (A W)^T z and return (z, r), with a
+       single global reduction. */
+   double DeflationCoefficients(Vector &mu) const;
+
+   /// Update W with the Ritz vectors from span{W, P}.
+   void UpdateRecycledSpace() const;
+
+public:
+   RecyclingCGSolver();
+
+#ifdef MFEM_USE_MPI
+   RecyclingCGSolver(MPI_Comm _comm);
+#endif
+
+   /** @brief Set the dimension @a k_ of the recycled subspace and the number
+       @a m_ of search directions of a solve used to update it, default 8 and
+       16. The recycled subspace is reset. */
+   void SetRecycleDim(int k_, int m_);
+
+   /// Discard the recycled subspace, e.g. when the operator changed a lot.
+   void ResetRecycledSpace() { nw = 0; AW_valid = false; }
+
+   /// Returns the current dimension of the recycled subspace.
+   int GetRecycledDim() const { return nw; }
+
+   /** @brief Set a new operator, keeping the recycled subspace if the size
+       is unchanged. */
+   virtual void SetOperator(const Operator &op);
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
 /// Conjugate gradient method. (tolerances are squared)
 void CG(const Operator &A, const Vector &b, Vector &x,
         int print_iter = 0, int max_num_iter = 1000,
@@ -144,17 +325,25 @@ class GMRESSolver : public IterativeSolver
 {
 protected:
    int m; // see SetKDim()
+   GramSchmidt::Type orthog; // see SetOrthogonalization()
 
 public:
-   GMRESSolver() { m = 50; }
+   GMRESSolver() { m = 50; orthog = GramSchmidt::MODIFIED; }
 
 #ifdef MFEM_USE_MPI
-   GMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm) { m = 50; }
+   GMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm)
+   { m = 50; orthog = GramSchmidt::MODIFIED; }
 #endif
 
    /// Set the number of iteration to perform between restarts, default is 50.
    void SetKDim(int dim) { m = dim; }
 
+   /** @brief Set the orthogonalization of the Krylov basis, default is
+       GramSchmidt::MODIFIED. */
+   /** GramSchmidt::CLASSICAL_REORTH needs fewer global reductions and memory
+       passes, which is faster for large bases and in parallel. */
+   void SetOrthogonalization(GramSchmidt::Type type) { orthog = type; }
+
    virtual void Mult(const Vector &b, Vector &x) const;
 };
 
@@ -163,16 +352,85 @@ class FGMRESSolver : public IterativeSolver
 {
 protected:
    int m;
+   GramSchmidt::Type orthog;
 
 public:
-   FGMRESSolver() { m = 50; }
+   FGMRESSolver() { m = 50; orthog = GramSchmidt::MODIFIED; }
 
 #ifdef MFEM_USE_MPI
-   FGMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm) { m = 50; }
+   FGMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm)
+   { m = 50; orthog = GramSchmidt::MODIFIED; }
 #endif
 
    void SetKDim(int dim) { m = dim; }
 
+   /// See GMRESSolver::SetOrthogonalization().
+   void SetOrthogonalization(GramSchmidt::Type type) { orthog = type; }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+/// GMRES method with subspace recycling, GCROT(m,k)
+/** Intended for sequences of systems that change slowly, e.g. in time
+    stepping or in Newton iterations. The method keeps a recycled subspace U
+    with C = A U orthonormal: every solve starts by minimizing the residual
+    over U, and the Arnoldi process of each restart cycle is deflated with C
+    (GCRO of de Sturler). After every cycle, the correction of the cycle is
+    added to U, replacing the oldest vector when U has k vectors (GCROT(m,k)
+    of de Sturler, as in Hicken and Zingg), so the subspace is also used by
+    the following restart cycles of the same solve.
+
+    The preconditioner is applied from the right, so the convergence
+    criterion uses the true residual norm ||b - A x||. When the operator
+    changes, see SetOperator(), U is kept and C is recomputed and
+    orthonormalized at the beginning of the next solve. Call
+    ResetRecycledSpace() when the operator changes drastically. */
+class RecyclingGMRESSolver : public IterativeSolver
+{
+protected:
+   int m, k; // see SetKDim() and SetRecycleDim()
+   GramSchmidt::Type orthog; // see SetOrthogonalization()
+
+   /// @name The recycled subspace U (nu vectors) and C = A U.
+   ///@{
+   mutable MultiVector U, C;
+   mutable int nu, next;
+   mutable bool C_valid;
+   ///@}
+
+   /// Recompute C = A U and orthonormalize it.
+   void SetupRecycledSpace() const;
+
+   /// Add the normalized pair @a u, @a c = A u to the recycled subspace.
+   void AddRecycledVector(Vector &u, Vector &c) const;
+
+public:
+   RecyclingGMRESSolver();
+
+#ifdef MFEM_USE_MPI
+   RecyclingGMRESSolver(MPI_Comm _comm);
+#endif
+
+   /// Set the number of Arnoldi steps per restart cycle, default is 30.
+   void SetKDim(int dim) { m = dim; }
+
+   /** @brief Set the maximal dimension of the recycled subspace, default is
+       10. The recycled subspace is reset. */
+   void SetRecycleDim(int k_);
+
+   /// See GMRESSolver::SetOrthogonalization().
+   void SetOrthogonalization(GramSchmidt::Type type) { orthog = type; }
+
+   /// Discard the recycled subspace, e.g. when the operator changed a lot.
+   void ResetRecycledSpace() { nu = next = 0; C_valid = false; }
+
+   /// Returns the current dimension of the recycled subspace.
+   int GetRecycledDim() const { return nu; }
+
+   /** @brief Set a new operator, keeping the recycled subspace if the size
+       is unchanged. */
+   virtual void SetOperator(const Operator &op);
+
    virtual void Mult(const Vector &b, Vector &x) const;
 };
 
@@ -285,6 +543,91 @@ public:
    { return 1.0; }
 };
 
+/** @brief Initial guesses for a sequence of linear systems, e.g. the implicit
+    solves of a time integrator, computed from the previous solutions. */
+/** The extrapolator keeps the last k solutions and, for the next right-hand
+    side b, forms the initial guess with one of the following methods:
+
+    - POLYNOMIAL: the polynomial (Lagrange) extrapolation in time through the
+      stored solutions, see SetTime(). This does not require the operator and
+      can also be used for nonlinear solvers.
+    - PROJECTION: the least-squares projection, i.e. the vector x in the span
+      X of the stored solutions minimizing |b - A x|, which requires the
+      (linear) operator A, see SetOperator(). The guess is the best one in X,
+      so it can be used with any sequence of solutions, e.g. the stages of a
+      Runge-Kutta method. The products A X are kept until SetOperator() is
+      called again, so usually only one new product is computed per solve.
+
+    The guess is used by setting Solver::iterative_mode, see Mult(). Note that
+    the iterative solvers measure the relative tolerance with respect to the
+    initial residual, so the absolute tolerance should be used to benefit from
+    the better initial guess. */
+class InitialGuessExtrapolator
+{
+public:
+   enum Type { POLYNOMIAL, PROJECTION };
+
+protected:
+   Type type;
+   const Operator *oper;
+#ifdef MFEM_USE_MPI
+   int dot_prod_type; // 0 - local, 1 - global over 'comm'
+   MPI_Comm comm;
+#endif
+
+   /// Stored solutions X, a ring buffer with k vectors.
+   MultiVector X;
+   /// The products A X, valid only for the vectors marked in AX_valid.
+   MultiVector AX;
+   Array<bool> AX_valid;
+   /// The times of the stored solutions.
+   Vector times;
+   /// Number of stored solutions, index of the next one, time of the next one.
+   int nx, next;
+   double t;
+
+   void Reduce(double *dots, int n) const;
+
+public:
+   /// Keep @a k solutions and use the given extrapolation type.
+   InitialGuessExtrapolator(Type type_ = POLYNOMIAL, int k = 3);
+
+#ifdef MFEM_USE_MPI
+   InitialGuessExtrapolator(MPI_Comm comm_, Type type_ = POLYNOMIAL,
+                            int k = 3);
+#endif
+
+   /// Set the number of stored solutions. This resets the history.
+   void SetHistorySize(int k);
+   void SetType(Type type_) { type = type_; }
+
+   /** @brief Set the operator used by the PROJECTION type. This must be
+       called whenever the operator changes. */
+   void SetOperator(const Operator &op);
+
+   /** @brief Set the time of the next solution, used by the POLYNOMIAL type.
+       If not called, the solutions are assumed to be equally spaced. */
+   void SetTime(double t_) { t = t_; }
+
+   /// Forget all stored solutions.
+   void Reset() { nx = next = 0; }
+
+   /// Number of currently stored solutions.
+   int GetHistoryLength() const { return nx; }
+
+   /** @brief Store the solution @a x (at the current time, see SetTime()).
+       The oldest solution is dropped if the history is full. */
+   void Add(const Vector &x);
+
+   /** @brief Compute the initial guess @a x for the system with right-hand
+       side @a b. Without stored solutions, @a x is set to zero. */
+   void GetInitialGuess(const Vector &b, Vector &x);
+
+   /** @brief Solve with @a solver in iterative mode starting from the
+       extrapolated initial guess and add the solution @a x to the history. */
+   void Mult(Solver &solver, const Vector &b, Vector &x);
+};
+
 /** Adaptive restarted GMRES.
     m_max and m_min(=1) are the maximal and minimal restart parameters.
     m_step(=1) is the step to use for going from m_max and m_min.
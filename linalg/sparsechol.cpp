@@ -0,0 +1,695 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of the supernodal sparse Cholesky and LDL^T solver
+
+#include "sparsechol.hpp"
+#include "../general/device.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+
+namespace mfem
+{
+
+using namespace std;
+
+// Subgraphs with at most this many vertices are not dissected further.
+static const int nd_leaf_size = 64;
+
+// Breadth-first search in the subgraph of the vertices with label lab,
+// starting from root. The visited vertices are stored in queue, with their
+// distance to root in lvl, which must be -1 for the unvisited vertices.
+// Returns the number of levels.
+static int LevelStructure(const int *I, const int *J, int root, int lab,
+                          const Array<int> &label, Array<int> &lvl,
+                          Array<int> &queue)
+{
+   queue.SetSize(0);
+   queue.Append(root);
+   lvl[root] = 0;
+   int num_levels = 1;
+   for (int h = 0; h < queue.Size(); h++)
+   {
+      const int v = queue[h];
+      for (int k = I[v]; k < I[v+1]; k++)
+      {
+         const int u = J[k];
+         if (label[u] == lab && lvl[u] < 0)
+         {
+            lvl[u] = lvl[v] + 1;
+            num_levels = lvl[u] + 1;
+            queue.Append(u);
+         }
+      }
+   }
+   return num_levels;
+}
+
+static void ResetLevels(const Array<int> &verts, Array<int> &lvl)
+{
+   for (int i = 0; i < verts.Size(); i++) { lvl[verts[i]] = -1; }
+}
+
+// Append to order the nested dissection ordering of the subgraph with the
+// vertices verts, which all have the same label.
+static void NestedDissection(const int *I, const int *J,
+                             const Array<int> &verts, Array<int> &label,
+                             int &num_labels, Array<int> &lvl,
+                             Array<int> &queue, Array<int> &order)
+{
+   const int nv = verts.Size();
+   if (nv <= nd_leaf_size)
+   {
+      order.Append(verts);
+      return;
+   }
+   const int lab = label[verts[0]];
+   int num_levels = LevelStructure(I, J, verts[0], lab, label, lvl, queue);
+   if (queue.Size() < nv)
+   {
+      // Order the connected components one after the other.
+      ResetLevels(queue, lvl);
+      Array<int> comp;
+      for (int i = 0; i < nv; i++)
+      {
+         if (label[verts[i]] != lab) { continue; }
+         LevelStructure(I, J, verts[i], lab, label, lvl, queue);
+         ResetLevels(queue, lvl);
+         const int comp_lab = num_labels++;
+         for (int k = 0; k < queue.Size(); k++) { label[queue[k]] = comp_lab; }
+         queue.Copy(comp);
+         NestedDissection(I, J, comp, label, num_labels, lvl, queue, order);
+      }
+      return;
+   }
+
+   // Look for a pseudo-peripheral root, giving a deep level structure.
+   for (int it = 0; it < 3; it++)
+   {
+      const int root = queue.Last();
+      ResetLevels(queue, lvl);
+      const int nl = LevelStructure(I, J, root, lab, label, lvl, queue);
+      const bool deeper = (nl > num_levels);
+      num_levels = nl;
+      if (!deeper) { break; }
+   }
+   if (num_levels < 3)
+   {
+      ResetLevels(verts, lvl);
+      order.Append(verts);
+      return;
+   }
+
+   // The separator is taken from the level splitting the vertices in halves:
+   // it contains the vertices of this level connected to the next one.
+   Array<int> count(num_levels);
+   count = 0;
+   for (int i = 0; i < nv; i++) { count[lvl[verts[i]]]++; }
+   int m = 0, below = 0;
+   while (below + count[m] < nv/2) { below += count[m++]; }
+   m = std::max(1, std::min(m, num_levels - 2));
+
+   Array<int> part_a, part_b, sep;
+   for (int i = 0; i < nv; i++)
+   {
+      const int v = verts[i], l = lvl[v];
+      bool in_sep = false;
+      if (l == m)
+      {
+         for (int k = I[v]; k < I[v+1]; k++)
+         {
+            if (label[J[k]] == lab && lvl[J[k]] == m+1) { in_sep = true; break; }
+         }
+      }
+      if (in_sep) { sep.Append(v); }
+      else if (l <= m) { part_a.Append(v); }
+      else { part_b.Append(v); }
+   }
+   ResetLevels(verts, lvl);
+   const int lab_a = num_labels++, lab_b = num_labels++;
+   for (int i = 0; i < part_a.Size(); i++) { label[part_a[i]] = lab_a; }
+   for (int i = 0; i < part_b.Size(); i++) { label[part_b[i]] = lab_b; }
+   for (int i = 0; i < sep.Size(); i++) { label[sep[i]] = -1; }
+
+   NestedDissection(I, J, part_a, label, num_labels, lvl, queue, order);
+   NestedDissection(I, J, part_b, label, num_labels, lvl, queue, order);
+   order.Append(sep);
+}
+
+void NestedDissectionOrdering(int n, const int *I, const int *J,
+                              Array<int> &perm)
+{
+   Array<int> verts(n), label(n), lvl(n), queue;
+   for (int i = 0; i < n; i++) { verts[i] = i; }
+   label = 0;
+   lvl = -1;
+   int num_labels = 1;
+   perm.SetSize(0);
+   perm.Reserve(n);
+   NestedDissection(I, J, verts, label, num_labels, lvl, queue, perm);
+   MFEM_ASSERT(perm.Size() == n, "invalid ordering");
+}
+
+
+void SparseCholeskySolver::SetOrdering(const Array<int> &p)
+{
+   p.Copy(user_perm);
+   a_I.SetSize(0); // force a new analysis
+}
+
+void SparseCholeskySolver::SetOperator(const Operator &a)
+{
+   oper = dynamic_cast<const SparseMatrix*>(&a);
+   if (oper == NULL)
+   {
+      mfem_error("SparseCholeskySolver::SetOperator : not a SparseMatrix!");
+   }
+   MFEM_VERIFY(oper->Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(oper->Height() == oper->Width(),
+               "the SparseMatrix must be square");
+   height = width = oper->Height();
+
+   const int n = height;
+   const int *aI = oper->GetI(), *aJ = oper->GetJ();
+   const int nnz = aI[n];
+   const bool new_pattern =
+      (a_I.Size() != n+1 || a_J.Size() != nnz ||
+       memcmp(a_I.GetData(), aI, (n+1)*sizeof(int)) != 0 ||
+       memcmp(a_J.GetData(), aJ, nnz*sizeof(int)) != 0);
+   if (new_pattern)
+   {
+      a_I.SetSize(n+1);
+      a_J.SetSize(nnz);
+      memcpy(a_I.GetData(), aI, (n+1)*sizeof(int));
+      memcpy(a_J.GetData(), aJ, nnz*sizeof(int));
+      Analyze();
+   }
+   Factorize();
+}
+
+// Compute the lower triangle of P A P^T in CSC format and its elimination
+// tree, where pinv is the inverse of the ordering.
+static void PermutedLower(int n, const int *aI, const int *aJ,
+                          const Array<int> &pinv, Array<int> &low_I,
+                          Array<int> &low_J, Array<int> &low_pos,
+                          Array<int> &parent)
+{
+   low_I.SetSize(n+1);
+   low_I = 0;
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = aI[i]; k < aI[i+1]; k++)
+      {
+         if (pinv[i] >= pinv[aJ[k]]) { low_I[pinv[aJ[k]]+1]++; }
+      }
+   }
+   low_I.PartialSum();
+   low_J.SetSize(low_I[n]);
+   low_pos.SetSize(low_I[n]);
+   Array<int> pos(n);
+   for (int c = 0; c < n; c++) { pos[c] = low_I[c]; }
+   for (int i = 0; i < n; i++)
+   {
+      const int r = pinv[i];
+      for (int k = aI[i]; k < aI[i+1]; k++)
+      {
+         const int c = pinv[aJ[k]];
+         if (r >= c)
+         {
+            low_J[pos[c]] = r;
+            low_pos[pos[c]++] = k;
+         }
+      }
+   }
+
+   // Elimination tree with path compression (Liu's algorithm): the column
+   // entries of the lower triangle are the row entries of the upper one.
+   Array<int> ancestor(n), row_I(n+1), row_J(low_I[n]);
+   row_I = 0;
+   for (int k = 0; k < low_I[n]; k++) { row_I[low_J[k]+1]++; }
+   row_I.PartialSum();
+   for (int r = 0; r < n; r++) { pos[r] = row_I[r]; }
+   for (int c = 0; c < n; c++)
+   {
+      for (int k = low_I[c]; k < low_I[c+1]; k++)
+      {
+         row_J[pos[low_J[k]]++] = c;
+      }
+   }
+   parent.SetSize(n);
+   for (int r = 0; r < n; r++)
+   {
+      parent[r] = -1;
+      ancestor[r] = -1;
+      for (int k = row_I[r]; k < row_I[r+1]; k++)
+      {
+         int i = row_J[k];
+         while (i != -1 && i < r)
+         {
+            const int next = ancestor[i];
+            ancestor[i] = r;
+            if (next == -1) { parent[i] = r; }
+            i = next;
+         }
+      }
+   }
+}
+
+void SparseCholeskySolver::Analyze()
+{
+   const int n = height;
+   const int *aI = oper->GetI(), *aJ = oper->GetJ();
+
+   if (user_perm.Size() > 0)
+   {
+      MFEM_VERIFY(user_perm.Size() == n, "invalid ordering size");
+      user_perm.Copy(perm);
+   }
+   else
+   {
+      NestedDissectionOrdering(*oper, perm);
+   }
+   Array<int> pinv(n);
+   pinv = -1;
+   for (int k = 0; k < n; k++) { pinv[perm[k]] = k; }
+   for (int i = 0; i < n; i++)
+   {
+      MFEM_VERIFY(pinv[i] >= 0, "the ordering is not a permutation");
+   }
+
+   Array<int> parent;
+   PermutedLower(n, aI, aJ, pinv, low_I, low_J, low_pos, parent);
+
+   // Postorder the elimination tree, so that the columns of every subtree
+   // are contiguous, and renumber accordingly.
+   {
+      Array<int> head(n), next(n), stack(n), post(n);
+      head = -1;
+      for (int j = n-1; j >= 0; j--)
+      {
+         if (parent[j] != -1) { next[j] = head[parent[j]]; head[parent[j]] = j; }
+      }
+      int k = 0;
+      bool identity = true;
+      for (int j = 0; j < n; j++)
+      {
+         if (parent[j] != -1) { continue; }
+         int top = 0;
+         stack[0] = j;
+         while (top >= 0)
+         {
+            const int p = stack[top], c = head[p];
+            if (c == -1)
+            {
+               top--;
+               identity = identity && (p == k);
+               post[k++] = p;
+            }
+            else
+            {
+               head[p] = next[c];
+               stack[++top] = c;
+            }
+         }
+      }
+      if (!identity)
+      {
+         Array<int> old_perm(perm);
+         for (int i = 0; i < n; i++) { perm[i] = old_perm[post[i]]; }
+         for (int i = 0; i < n; i++) { pinv[perm[i]] = i; }
+         PermutedLower(n, aI, aJ, pinv, low_I, low_J, low_pos, parent);
+      }
+   }
+
+   // Column counts of L from the row subtrees: the structure of row r of L
+   // is given by the paths in the tree from the entries of row r of A to r.
+   Array<int> colcount(n), mark(n);
+   colcount = 1;
+   mark = -1;
+   {
+      Array<int> row_I(n+1), row_J(low_I[n]), pos(n);
+      row_I = 0;
+      for (int k = 0; k < low_I[n]; k++) { row_I[low_J[k]+1]++; }
+      row_I.PartialSum();
+      for (int r = 0; r < n; r++) { pos[r] = row_I[r]; }
+      for (int c = 0; c < n; c++)
+      {
+         for (int k = low_I[c]; k < low_I[c+1]; k++)
+         {
+            row_J[pos[low_J[k]]++] = c;
+         }
+      }
+      for (int r = 0; r < n; r++)
+      {
+         mark[r] = r;
+         for (int k = row_I[r]; k < row_I[r+1]; k++)
+         {
+            for (int i = row_J[k]; mark[i] != r; i = parent[i])
+            {
+               colcount[i]++;
+               mark[i] = r;
+            }
+         }
+      }
+   }
+
+   // Supernodes: a column is merged with the previous ones when it is the
+   // parent of the previous column and the explicit zeros stay few.
+   sn_first.SetSize(0);
+   sn_first.Append(0);
+   {
+      int nc = 1;
+      double nnz_true = colcount[0];
+      for (int j = 0; j+1 < n; j++)
+      {
+         const int c = j+1;
+         bool merge = false;
+         if (parent[j] == c)
+         {
+            const double nc_new = nc + 1;
+            const double nr_new = nc_new + colcount[c] - 1;
+            const double stored = nc_new*nr_new - nc_new*(nc_new - 1)/2;
+            const double zeros = stored - (nnz_true + colcount[c]);
+            merge = (zeros <= 0.05*stored ||
+                     (nc_new <= 4 && zeros <= 0.5*stored));
+         }
+         if (merge)
+         {
+            nc++;
+            nnz_true += colcount[c];
+         }
+         else
+         {
+            sn_first.Append(c);
+            nc = 1;
+            nnz_true = colcount[c];
+         }
+      }
+   }
+   if (n > 0) { sn_first.Append(n); }
+   const int nsn = sn_first.Size() - 1;
+
+   Array<int> sn_of_col(n), sn_parent(nsn), child_head(nsn), child_next(nsn);
+   for (int s = 0; s < nsn; s++)
+   {
+      for (int c = sn_first[s]; c < sn_first[s+1]; c++) { sn_of_col[c] = s; }
+   }
+   child_head = -1;
+   for (int s = nsn-1; s >= 0; s--)
+   {
+      const int p = parent[sn_first[s+1]-1];
+      sn_parent[s] = (p == -1) ? -1 : sn_of_col[p];
+      if (p != -1)
+      {
+         child_next[s] = child_head[sn_parent[s]];
+         child_head[sn_parent[s]] = s;
+      }
+   }
+
+   // Row structure of the supernodes: the union of the rows of the lower
+   // triangle of A in its columns and of the rows of its children.
+   mark = -1;
+   sn_rows_I.SetSize(nsn+1);
+   sn_rows.SetSize(0);
+   sn_val_I.SetSize(nsn+1);
+   sn_rows_I[0] = sn_val_I[0] = 0;
+   long long num_values = 0;
+   max_block = 0;
+   for (int s = 0; s < nsn; s++)
+   {
+      const int f = sn_first[s], l = sn_first[s+1];
+      for (int c = f; c < l; c++) { sn_rows.Append(c); mark[c] = s; }
+      for (int c = f; c < l; c++)
+      {
+         for (int k = low_I[c]; k < low_I[c+1]; k++)
+         {
+            const int r = low_J[k];
+            if (mark[r] != s) { sn_rows.Append(r); mark[r] = s; }
+         }
+      }
+      for (int cs = child_head[s]; cs != -1; cs = child_next[cs])
+      {
+         const int cs_nc = sn_first[cs+1] - sn_first[cs];
+         for (int p = sn_rows_I[cs] + cs_nc; p < sn_rows_I[cs+1]; p++)
+         {
+            const int r = sn_rows[p];
+            if (mark[r] != s) { sn_rows.Append(r); mark[r] = s; }
+         }
+      }
+      sn_rows_I[s+1] = sn_rows.Size();
+      std::sort(sn_rows.GetData() + sn_rows_I[s] + (l - f),
+                sn_rows.GetData() + sn_rows_I[s+1]);
+      const int nr = sn_rows_I[s+1] - sn_rows_I[s];
+      MFEM_ASSERT(nr == (l - f) + colcount[l-1] - 1,
+                  "inconsistent supernode structure");
+      num_values += (long long) nr * (l - f);
+      MFEM_VERIFY(num_values <= INT_MAX, "the factor is too large");
+      sn_val_I[s+1] = (int) num_values;
+      max_block = std::max(max_block, nr * (l - f));
+   }
+
+   // The supernodes updating each supernode t: supernode d updates t when
+   // some rows of d are columns of t.
+   upd_I.SetSize(nsn+1);
+   upd_I = 0;
+   for (int pass = 0; pass < 2; pass++)
+   {
+      if (pass == 1)
+      {
+         upd_I.PartialSum();
+         upd_sn.SetSize(upd_I[nsn]);
+         upd_pos.SetSize(upd_I[nsn]);
+      }
+      for (int d = 0; d < nsn; d++)
+      {
+         const int d_nc = sn_first[d+1] - sn_first[d];
+         int last = -1;
+         for (int p = sn_rows_I[d] + d_nc; p < sn_rows_I[d+1]; p++)
+         {
+            const int t = sn_of_col[sn_rows[p]];
+            if (t == last) { continue; }
+            last = t;
+            if (pass == 0) { upd_I[t+1]++; continue; }
+            upd_sn[upd_I[t]] = d;
+            upd_pos[upd_I[t]++] = p - sn_rows_I[d];
+         }
+      }
+      if (pass == 1)
+      {
+         for (int t = nsn; t > 0; t--) { upd_I[t] = upd_I[t-1]; }
+         upd_I[0] = 0;
+      }
+   }
+
+   // Levels: the leaves are in level 0, a parent is one level above its
+   // highest child.
+   Array<int> level(nsn);
+   level = 0;
+   int num_levels = (nsn > 0) ? 1 : 0;
+   for (int s = 0; s < nsn; s++)
+   {
+      if (sn_parent[s] != -1)
+      {
+         level[sn_parent[s]] = std::max(level[sn_parent[s]], level[s] + 1);
+         num_levels = std::max(num_levels, level[s] + 2);
+      }
+   }
+   lvl_I.SetSize(num_levels+1);
+   lvl_I = 0;
+   for (int s = 0; s < nsn; s++) { lvl_I[level[s]+1]++; }
+   lvl_I.PartialSum();
+   Array<int> pos(num_levels);
+   for (int l = 0; l < num_levels; l++) { pos[l] = lvl_I[l]; }
+   lvl_sn.SetSize(nsn);
+   for (int s = 0; s < nsn; s++) { lvl_sn[pos[level[s]]++] = s; }
+}
+
+int SparseCholeskySolver::FactorSupernode(int s, int *relpos, double *C)
+{
+   const int f = sn_first[s], nc = sn_first[s+1] - f;
+   const int *rows = sn_rows + sn_rows_I[s];
+   const int nr = sn_rows_I[s+1] - sn_rows_I[s];
+   double *Ls = L.GetData() + sn_val_I[s];
+   const double *aA = oper->GetData();
+   const bool ldlt = (type == LDLT);
+
+   // Copy the columns of the matrix into the dense block.
+   for (int i = 0; i < nr*nc; i++) { Ls[i] = 0.0; }
+   for (int i = 0; i < nr; i++) { relpos[rows[i]] = i; }
+   for (int j = 0; j < nc; j++)
+   {
+      for (int k = low_I[f+j]; k < low_I[f+j+1]; k++)
+      {
+         Ls[relpos[low_J[k]] + j*nr] += aA[low_pos[k]];
+      }
+   }
+
+   // Left-looking updates from the descendants: subtract L_d D_d L_d^T for
+   // the rows of d from position p0, and its columns in [f, f+nc).
+   for (int u = upd_I[s]; u < upd_I[s+1]; u++)
+   {
+      const int d = upd_sn[u], p0 = upd_pos[u];
+      const int d_nc = sn_first[d+1] - sn_first[d];
+      const int *d_rows = sn_rows + sn_rows_I[d];
+      const int d_nr = sn_rows_I[d+1] - sn_rows_I[d];
+      const double *Ld = L.GetData() + sn_val_I[d];
+      int p1 = p0;
+      while (p1 < d_nr && d_rows[p1] < f + nc) { p1++; }
+      const int m = d_nr - p0, q = p1 - p0;
+
+      // C = L_d(p0:, :) D_d L_d(p0:p1, :)^T, lower trapezoid only
+      for (int jj = 0; jj < q; jj++)
+      {
+         double *Cj = C + jj*m;
+         for (int ii = jj; ii < m; ii++) { Cj[ii] = 0.0; }
+         for (int k = 0; k < d_nc; k++)
+         {
+            const double *Ldk = Ld + p0 + k*d_nr;
+            double w = Ldk[jj];
+            if (ldlt) { w *= Ld[k + k*d_nr]; }
+            if (w == 0.0) { continue; }
+            for (int ii = jj; ii < m; ii++) { Cj[ii] += Ldk[ii] * w; }
+         }
+      }
+      for (int jj = 0; jj < q; jj++)
+      {
+         double *Lsj = Ls + (d_rows[p0+jj] - f)*nr;
+         const double *Cj = C + jj*m;
+         for (int ii = jj; ii < m; ii++)
+         {
+            Lsj[relpos[d_rows[p0+ii]]] -= Cj[ii];
+         }
+      }
+   }
+
+   // Dense factorization of the block: the diagonal part is factored and the
+   // rows below are scaled, column by column.
+   for (int j = 0; j < nc; j++)
+   {
+      double *Lj = Ls + j*nr;
+      const double d = Lj[j];
+      if (ldlt)
+      {
+         if (d == 0.0) { return f + j; }
+         const double d_inv = 1.0/d;
+         for (int i = j+1; i < nr; i++) { Lj[i] *= d_inv; }
+         for (int k = j+1; k < nc; k++)
+         {
+            const double w = Lj[k] * d;
+            double *Lk = Ls + k*nr;
+            for (int i = k; i < nr; i++) { Lk[i] -= Lj[i] * w; }
+         }
+      }
+      else
+      {
+         if (!(d > 0.0)) { return f + j; }
+         const double l_jj = std::sqrt(d), l_inv = 1.0/l_jj;
+         Lj[j] = l_jj;
+         for (int i = j+1; i < nr; i++) { Lj[i] *= l_inv; }
+         for (int k = j+1; k < nc; k++)
+         {
+            const double w = Lj[k];
+            double *Lk = Ls + k*nr;
+            for (int i = k; i < nr; i++) { Lk[i] -= Lj[i] * w; }
+         }
+      }
+   }
+   return -1;
+}
+
+void SparseCholeskySolver::Factorize()
+{
+   L.SetSize(sn_val_I.Last());
+   const int num_levels = lvl_I.Size() - 1;
+   int bad_col = -1;
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel if (Device::AllowsHostOpenMP())
+#endif
+   {
+      Array<int> relpos(height);
+      Vector C(max_block);
+      for (int l = 0; l < num_levels; l++)
+      {
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for schedule(dynamic) reduction(max:bad_col)
+#endif
+         for (int k = lvl_I[l]; k < lvl_I[l+1]; k++)
+         {
+            const int col = FactorSupernode(lvl_sn[k], relpos, C.GetData());
+            bad_col = std::max(bad_col, col);
+         }
+      }
+   }
+   MFEM_VERIFY(bad_col < 0, "zero or negative pivot in row " << perm[bad_col]
+               << " of the matrix");
+}
+
+void SparseCholeskySolver::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_ASSERT(b.Size() == width && x.Size() == height,
+               "invalid vector sizes");
+   const int n = height, nsn = NumSupernodes();
+   const bool ldlt = (type == LDLT);
+   work.SetSize(n);
+   double *y = work.GetData();
+   for (int i = 0; i < n; i++) { y[i] = b(perm[i]); }
+
+   // Forward solve with L.
+   for (int s = 0; s < nsn; s++)
+   {
+      const int f = sn_first[s], nc = sn_first[s+1] - f;
+      const int *rows = sn_rows + sn_rows_I[s];
+      const int nr = sn_rows_I[s+1] - sn_rows_I[s];
+      const double *Ls = L.GetData() + sn_val_I[s];
+      for (int j = 0; j < nc; j++)
+      {
+         const double *Lj = Ls + j*nr;
+         if (!ldlt) { y[f+j] /= Lj[j]; }
+         const double yj = y[f+j];
+         for (int i = j+1; i < nr; i++) { y[rows[i]] -= Lj[i] * yj; }
+      }
+   }
+
+   if (ldlt)
+   {
+      for (int s = 0; s < nsn; s++)
+      {
+         const int f = sn_first[s], nc = sn_first[s+1] - f;
+         const int nr = sn_rows_I[s+1] - sn_rows_I[s];
+         const double *Ls = L.GetData() + sn_val_I[s];
+         for (int j = 0; j < nc; j++) { y[f+j] /= Ls[j + j*nr]; }
+      }
+   }
+
+   // Backward solve with L^T.
+   for (int s = nsn-1; s >= 0; s--)
+   {
+      const int f = sn_first[s], nc = sn_first[s+1] - f;
+      const int *rows = sn_rows + sn_rows_I[s];
+      const int nr = sn_rows_I[s+1] - sn_rows_I[s];
+      const double *Ls = L.GetData() + sn_val_I[s];
+      for (int j = nc-1; j >= 0; j--)
+      {
+         const double *Lj = Ls + j*nr;
+         double yj = y[f+j];
+         for (int i = j+1; i < nr; i++) { yj -= Lj[i] * y[rows[i]]; }
+         y[f+j] = ldlt ? yj : yj / Lj[j];
+      }
+   }
+
+   for (int i = 0; i < n; i++) { x(perm[i]) = y[i]; }
+}
+
+}
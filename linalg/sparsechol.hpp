@@ -0,0 +1,167 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SPARSECHOL
+#define MFEM_SPARSECHOL
+
+// Built-in sparse direct solver for symmetric matrices
+
+#include "../config/config.hpp"
+#include "../general/table.hpp"
+#include "sparsemat.hpp"
+#include "solvers.hpp"
+
+namespace mfem
+{
+
+/** @brief Compute a nested dissection ordering of the symmetric graph given by
+    the CSR arrays @a I and @a J with @a n vertices. */
+/** The graph is recursively split in two parts by a vertex separator taken
+    from a level structure rooted at a pseudo-peripheral vertex. On return,
+    @a perm[k] is the vertex numbered k: the vertices of the two parts come
+    first, followed by the ones of the separator. */
+void NestedDissectionOrdering(int n, const int *I, const int *J,
+                              Array<int> &perm);
+
+/// Nested dissection ordering of the graph of the (symmetric) matrix @a A.
+inline void NestedDissectionOrdering(const SparseMatrix &A, Array<int> &perm)
+{ NestedDissectionOrdering(A.Height(), A.GetI(), A.GetJ(), perm); }
+
+/** @brief Nested dissection ordering of a symmetric graph, e.g. the
+    dof-to-dof connectivity of a mesh. */
+inline void NestedDissectionOrdering(const Table &graph, Array<int> &perm)
+{ NestedDissectionOrdering(graph.Size(), graph.GetI(), graph.GetJ(), perm); }
+
+
+/** @brief Supernodal sparse direct solver for symmetric SparseMatrix objects,
+    using the factorization P A P^T = L L^T (Cholesky) or L D L^T. */
+/** The fill-reducing ordering P is a nested dissection ordering of the graph
+    of the matrix, unless a different one is given with SetOrdering(). The
+    columns of L with (nearly) the same structure are grouped in supernodes,
+    stored as dense blocks. The LDLT variant does not pivot: it can be used for
+    symmetric quasi-definite matrices, e.g. negative definite ones.
+
+    The symbolic analysis (ordering, elimination tree and structure of L) is
+    reused when SetOperator() is called with a matrix with the same sparsity
+    pattern. With the "omp" backend, the independent subtrees of the
+    elimination tree are factored in parallel: the supernodes are grouped in
+    levels such that each supernode depends only on supernodes of previous
+    levels.
+
+    Only the lower triangle of the matrix is used, i.e. the matrix must be
+    symmetric and store both triangles of its sparsity pattern. */
+class SparseCholeskySolver : public Solver
+{
+public:
+   enum Type
+   {
+      CHOLESKY, ///< A = L L^T, for symmetric positive definite matrices
+      LDLT      ///< A = L D L^T with unit lower triangular L, no pivoting
+   };
+
+protected:
+   Type type;
+   const SparseMatrix *oper;
+
+   /// Ordering set with SetOrdering(), empty for nested dissection.
+   Array<int> user_perm;
+   /// The ordering: perm[k] is the row of the matrix eliminated k-th.
+   Array<int> perm;
+
+   /// @name Copy of the sparsity pattern of the last analyzed matrix.
+   ///@{
+   Array<int> a_I, a_J;
+   ///@}
+
+   /** @name Lower triangle of P A P^T in CSC format; low_pos gives the
+       position of each entry in the data array of the matrix. */
+   ///@{
+   Array<int> low_I, low_J, low_pos;
+   ///@}
+
+   /** @name The supernodes: supernode s has the columns
+       [sn_first[s], sn_first[s+1]) and the sorted rows
+       sn_rows[sn_rows_I[s]...sn_rows_I[s+1]), starting with its columns. Its
+       values are stored column-major at L[sn_val_I[s]]. */
+   ///@{
+   Array<int> sn_first, sn_rows_I, sn_rows, sn_val_I;
+   ///@}
+
+   /** @name The supernodes which update supernode s are upd_sn[k] for k in
+       [upd_I[s], upd_I[s+1]); the update uses the rows of upd_sn[k] starting
+       at (local) position upd_pos[k]. */
+   ///@{
+   Array<int> upd_I, upd_sn, upd_pos;
+   ///@}
+
+   /// @name Supernodes grouped by level in the supernodal elimination tree.
+   ///@{
+   Array<int> lvl_I, lvl_sn;
+   ///@}
+
+   /// Largest dense block of a supernode, the size of the update workspace.
+   int max_block;
+
+   /// The values of the factor L (and D for LDLT).
+   Vector L;
+
+   mutable Vector work;
+
+   /// Compute the ordering and the symbolic factorization of #oper.
+   void Analyze();
+
+   /// Compute the numerical factorization of #oper.
+   void Factorize();
+
+   /** @brief Factor supernode @a s using the workspaces @a relpos (of size
+       height) and @a C (of size #max_block). Returns the column with a bad
+       pivot, or -1 on success. */
+   int FactorSupernode(int s, int *relpos, double *C);
+
+public:
+   SparseCholeskySolver(Type type_ = CHOLESKY)
+      : type(type_), oper(NULL), max_block(0) { }
+
+   /// Factor the matrix @a a, see SetOperator().
+   SparseCholeskySolver(const SparseMatrix &a, Type type_ = CHOLESKY)
+      : type(type_), oper(NULL), max_block(0) { SetOperator(a); }
+
+   /** @brief Use the ordering @a p, where @a p[k] is the row eliminated k-th,
+       instead of nested dissection. An empty @a p restores the default. */
+   /** The ordering is used by the next call to SetOperator(). */
+   void SetOrdering(const Array<int> &p);
+
+   /** @brief Set the (finalized, square, symmetric) SparseMatrix and compute
+       its factorization. */
+   /** If the sparsity pattern of @a a is the same as the one of the previous
+       matrix, only the numerical factorization is computed. */
+   virtual void SetOperator(const Operator &a);
+
+   /// Solve A x = b.
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// Same as Mult() since the matrix is symmetric.
+   virtual void MultTranspose(const Vector &b, Vector &x) const
+   { Mult(b, x); }
+
+   /// Returns the number of entries stored in the factor L, including zeros.
+   int NumNonZeroElems() const { return L.Size(); }
+
+   /// Returns the number of supernodes.
+   int NumSupernodes() const { return sn_first.Size() - 1; }
+
+   /// Returns the ordering used by the factorization.
+   const Array<int> &GetOrdering() const { return perm; }
+};
+
+}
+
+#endif
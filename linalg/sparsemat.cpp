@@ -24,11 +24,51 @@
 #include <limits>
 #include <cstring>
 
+#ifdef MFEM_USE_OPENMP
+#include <omp.h>
+#endif
+
 namespace mfem
 {
 
 using namespace std;
 
+#ifdef MFEM_USE_OPENMP
+// Returns the first row of block t when the rows of the CSR graph with row
+// offsets I are split into nt contiguous blocks with approximately the same
+// number of nonzeros. Block nt starts at row height.
+static inline int BalancedRowBegin(const int *I, int height, int t, int nt)
+{
+   if (t >= nt) { return height; }
+   const int target = (int)(((long long) I[height] * t) / nt);
+   return (int)(std::lower_bound(I, I + height, target) - I);
+}
+
+// y = a A x (add = false) or y += a A x (add = true) for a CSR matrix, using
+// nnz-balanced static partitioning of the rows among the OpenMP threads.
+static void BalancedSpMV(int height, const int *I, const int *J,
+                         const double *A, const double *x, double *y,
+                         double a, bool add)
+{
+   #pragma omp parallel
+   {
+      const int nt = omp_get_num_threads(), t = omp_get_thread_num();
+      const int i_beg = BalancedRowBegin(I, height, t, nt);
+      const int i_end = BalancedRowBegin(I, height, t+1, nt);
+      for (int i = i_beg; i < i_end; i++)
+      {
+         double d = 0.0;
+         const int end = I[i+1];
+         for (int j = I[i]; j < end; j++)
+         {
+            d += A[j] * x[J[j]];
+         }
+         y[i] = add ? y[i] + a * d : a * d;
+      }
+   }
+}
+#endif
+
 SparseMatrix::SparseMatrix(int nrows, int ncols)
    : AbstractSparseMatrix(nrows, (ncols >= 0) ? ncols : nrows),
      I(NULL),
@@ -58,6 +98,7 @@ SparseMatrix::SparseMatrix(int *i, int *j, double *data, int m, int n)
      J(j),
      A(data),
      Rows(NULL),
+     current_row(-1),
      ColPtrJ(NULL),
      ColPtrNode(NULL),
      ownGraph(true),
@@ -76,6 +117,7 @@ SparseMatrix::SparseMatrix(int *i, int *j, double *data, int m, int n,
      J(j),
      A(data),
      Rows(NULL),
+     current_row(-1),
      ColPtrJ(NULL),
      ColPtrNode(NULL),
      ownGraph(ownij),
@@ -101,6 +143,7 @@ SparseMatrix::SparseMatrix(int *i, int *j, double *data, int m, int n,
 SparseMatrix::SparseMatrix(int nrows, int ncols, int rowsize)
    : AbstractSparseMatrix(nrows, ncols)
    , Rows(NULL)
+   , current_row(-1)
    , ColPtrJ(NULL)
    , ColPtrNode(NULL)
    , ownGraph(true)
@@ -189,6 +232,7 @@ SparseMatrix::SparseMatrix(const SparseMatrix &mat, bool copy_graph)
 SparseMatrix::SparseMatrix(const Vector &v)
    : AbstractSparseMatrix(v.Size(), v.Size())
    , Rows(NULL)
+   , current_row(-1)
    , ColPtrJ(NULL)
    , ColPtrNode(NULL)
    , ownGraph(true)
@@ -417,6 +461,104 @@ void SparseMatrix::MoveDiagonalFirst()
    }
 }
 
+void SparseMatrix::GetRCMOrdering(Array<int> &ordering) const
+{
+   MFEM_VERIFY(Finalized(), "Matrix is not Finalized!");
+   MFEM_VERIFY(height == width, "the matrix must be square");
+
+   // Build the graph of A + A^T.
+   Table graph, graph_t;
+   graph.MakeI(height);
+   for (int i = 0; i < height; i++)
+   {
+      graph.AddColumnsInRow(i, I[i+1] - I[i]);
+   }
+   graph.MakeJ();
+   for (int i = 0; i < height; i++)
+   {
+      graph.AddConnections(i, J + I[i], I[i+1] - I[i]);
+   }
+   graph.ShiftUpI();
+   Transpose(graph, graph_t, width);
+
+   Table sym;
+   Array<int> marker(height);
+   marker = -1;
+   sym.MakeI(height);
+   for (int loop = 0; loop < 2; loop++)
+   {
+      for (int i = 0; i < height; i++)
+      {
+         const Table *tab[2] = { &graph, &graph_t };
+         for (int t = 0; t < 2; t++)
+         {
+            const int *row = tab[t]->GetRow(i);
+            for (int k = 0; k < tab[t]->RowSize(i); k++)
+            {
+               if (marker[row[k]] == i) { continue; }
+               marker[row[k]] = i;
+               if (loop == 0) { sym.AddAColumnInRow(i); }
+               else { sym.AddConnection(i, row[k]); }
+            }
+         }
+      }
+      if (loop == 0) { sym.MakeJ(); marker = -1; }
+   }
+   sym.ShiftUpI();
+
+   mfem::GetRCMOrdering(sym, ordering);
+}
+
+void SparseMatrix::PermuteRowsCols(const Array<int> &ordering)
+{
+   MFEM_VERIFY(Finalized(), "Matrix is not Finalized!");
+   MFEM_VERIFY(height == width && ordering.Size() == height,
+               "invalid matrix or ordering size");
+
+   const int nnz = I[height];
+   int *newI = mfem::New<int>(height+1);
+   int *newJ = mfem::New<int>(nnz);
+   double *newA = mfem::New<double>(nnz);
+
+   newI[0] = 0;
+   for (int i = 0; i < height; i++)
+   {
+      newI[ordering[i]+1] = I[i+1] - I[i];
+   }
+   for (int i = 0; i < height; i++)
+   {
+      newI[i+1] += newI[i];
+   }
+   for (int i = 0; i < height; i++)
+   {
+      for (int k = I[i], p = newI[ordering[i]]; k < I[i+1]; k++, p++)
+      {
+         newJ[p] = ordering[J[k]];
+         newA[p] = A[k];
+      }
+   }
+
+   const bool sorted = isSorted;
+   SparseMatrix tmp(newI, newJ, newA, height, width);
+   Swap(tmp);
+   if (sorted) { SortColumnIndices(); }
+}
+
+int SparseMatrix::GetBandwidth() const
+{
+   MFEM_VERIFY(Finalized(), "Matrix is not Finalized!");
+
+   int bw = 0;
+   for (int i = 0; i < height; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         bw = std::max(bw, std::abs(J[k] - i));
+      }
+   }
+   return bw;
+}
+
 double &SparseMatrix::Elem(int i, int j)
 {
    return operator()(i,j);
@@ -546,10 +688,79 @@ void SparseMatrix::ToDenseMatrix(DenseMatrix & B) const
 
 void SparseMatrix::Mult(const Vector &x, Vector &y) const
 {
+#if defined(MFEM_USE_OPENMP) && !defined(MFEM_USE_LEGACY_OPENMP)
+   if (A != NULL && Device::AllowsHostOpenMP())
+   {
+      MFEM_ASSERT(width == x.Size() && height == y.Size(),
+                  "invalid vector sizes");
+      BalancedSpMV(height, I, J, A, x.GetData(), y.GetData(), 1.0, false);
+      return;
+   }
+#endif
    y = 0.0;
    AddMult(x, y);
 }
 
+// Y_{j0+j} = A X_{j0+j}, j = 0,...,NB-1, for the CSR matrix (I,J,A) with h
+// rows. The NB input vectors are interleaved in xt, so that the entries
+// needed for one matrix entry are contiguous, and the NB sums of a row are
+// accumulated in registers.
+template <int NB>
+static void SpMMBlock(int h, const int *I, const int *J, const double *A,
+                      const double *xt, double *y)
+{
+#if defined(MFEM_USE_OPENMP) && !defined(MFEM_USE_LEGACY_OPENMP)
+   #pragma omp parallel for if(Device::AllowsHostOpenMP())
+#endif
+   for (int i = 0; i < h; i++)
+   {
+      double s[NB];
+      for (int j = 0; j < NB; j++) { s[j] = 0.0; }
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const double a = A[k];
+         const double *xc = xt + (long long) J[k] * NB;
+         for (int j = 0; j < NB; j++) { s[j] += a * xc[j]; }
+      }
+      for (int j = 0; j < NB; j++) { y[(long long) j * h + i] = s[j]; }
+   }
+}
+
+void SparseMatrix::BatchMult(const MultiVector &X, MultiVector &Y) const
+{
+   MFEM_VERIFY(X.VectorSize() == width && Y.VectorSize() == height &&
+               X.NumVectors() == Y.NumVectors(), "incompatible multivectors");
+   if (A == NULL || Device::Allows(Backend::DEVICE_MASK))
+   {
+      Operator::BatchMult(X, Y);
+      return;
+   }
+
+   // Process the vectors in blocks of 8 (then 4 and 1), so that the matrix is
+   // read once per block while the interleaved block of input vectors stays
+   // small enough for the cache.
+   const int nv = X.NumVectors();
+   Vector Xt(width * std::min(nv, 8));
+   double *xt = Xt.GetData();
+   for (int j0 = 0; j0 < nv; )
+   {
+      const int nb = (nv - j0 >= 8) ? 8 : (nv - j0 >= 4) ? 4 : 1;
+      for (int j = 0; j < nb; j++)
+      {
+         const double *xj = X.GetVectorData(j0 + j);
+         for (int c = 0; c < width; c++) { xt[(long long) c * nb + j] = xj[c]; }
+      }
+      double *yd = Y.GetVectorData(j0);
+      switch (nb)
+      {
+         case 8: SpMMBlock<8>(height, I, J, A, xt, yd); break;
+         case 4: SpMMBlock<4>(height, I, J, A, xt, yd); break;
+         default: SpMMBlock<1>(height, I, J, A, xt, yd); break;
+      }
+      j0 += nb;
+   }
+}
+
 void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
 {
    MFEM_ASSERT(width == x.Size(),
@@ -582,6 +793,16 @@ void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
 
    int *Jp = J, *Ip = I;
 
+#if defined(MFEM_USE_OPENMP) && !defined(MFEM_USE_LEGACY_OPENMP)
+   if (Device::AllowsHostOpenMP())
+   {
+      // Rows of very different lengths (e.g. from hanging node constraints or
+      // DG face couplings) do not cause load imbalance.
+      BalancedSpMV(height, Ip, Jp, Ap, xp, yp, a, true);
+      return;
+   }
+#endif
+
    if (a == 1.0)
    {
 #ifndef MFEM_USE_LEGACY_OPENMP
@@ -658,6 +879,77 @@ void SparseMatrix::AddMultTranspose(const Vector &x, Vector &y,
       }
       return;
    }
+   bool host_sequential = !Device::Allows(~Backend::CPU);
+#if defined(MFEM_USE_OPENMP) && !defined(MFEM_USE_LEGACY_OPENMP)
+   const int max_nt = omp_get_max_threads();
+   // The thread buffers cost O(max_nt*width) per call; when that exceeds the
+   // number of nonzeros, the sequential loop below is faster.
+   const bool threaded = (long)(max_nt-1)*width <= I[height];
+   if (Device::AllowsHostOpenMP() && !threaded) { host_sequential = true; }
+   if (Device::AllowsHostOpenMP() && threaded)
+   {
+      // Each thread scatters the contributions of an nnz-balanced block of
+      // rows into a private buffer (thread 0 uses y directly), followed by a
+      // thread-parallel reduction of the buffers into y.
+      const int *Ip = I, *Jp = J;
+      const double *Ap = A, *xp = x.GetData();
+      double *yp = y.GetData();
+      if (omp_ybuf.Size() < (max_nt-1)*width)
+      {
+         omp_ybuf.SetSize((max_nt-1)*width);
+      }
+      double *bp = omp_ybuf.GetData();
+      #pragma omp parallel num_threads(max_nt)
+      {
+         const int nt = omp_get_num_threads(), t = omp_get_thread_num();
+         double *yt = (t == 0) ? yp : bp + (t-1)*width;
+         if (t > 0)
+         {
+            for (int k = 0; k < width; k++) { yt[k] = 0.0; }
+         }
+         const int i_beg = BalancedRowBegin(Ip, height, t, nt);
+         const int i_end = BalancedRowBegin(Ip, height, t+1, nt);
+         for (int i = i_beg; i < i_end; i++)
+         {
+            const double xi = a * xp[i];
+            const int end = Ip[i+1];
+            for (int j = Ip[i]; j < end; j++)
+            {
+               yt[Jp[j]] += Ap[j] * xi;
+            }
+         }
+         #pragma omp barrier
+         #pragma omp for
+         for (int k = 0; k < width; k++)
+         {
+            double s = 0.0;
+            for (int tt = 1; tt < nt; tt++)
+            {
+               s += bp[(tt-1)*width + k];
+            }
+            yp[k] += s;
+         }
+      }
+      return;
+   }
+#endif
+   if (host_sequential)
+   {
+      // Sequential host execution: avoid the atomic updates below which are
+      // expensive when MFEM_USE_OPENMP is enabled.
+      const double *xp = x.GetData();
+      double *yp = y.GetData();
+      for (int i = 0; i < height; i++)
+      {
+         const double xi = a * xp[i];
+         const int end = I[i+1];
+         for (int j = I[i]; j < end; j++)
+         {
+            yp[J[j]] += A[j] * xi;
+         }
+      }
+      return;
+   }
    // Prepare the lambda capture and get our pointers from the memory manager
    const int d_height = height;
    const DeviceArray d_I(I);
@@ -682,6 +974,9 @@ void SparseMatrix::PartMult(
 {
    MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
 
+#if defined(MFEM_USE_OPENMP) && !defined(MFEM_USE_LEGACY_OPENMP)
+   #pragma omp parallel for if(Device::AllowsHostOpenMP())
+#endif
    for (int i = 0; i < rows.Size(); i++)
    {
       int r = rows[i];
@@ -1725,6 +2020,135 @@ void SparseMatrix::EliminateRowCol(int rc, SparseMatrix &Ae,
    }
 }
 
+void SparseMatrix::EliminateRowsCols(const Array<int> &rows_cols,
+                                     const Vector &sol, Vector &rhs,
+                                     DiagonalPolicy dpolicy)
+{
+   MFEM_ASSERT(sol.Size() == width && rhs.Size() == height,
+               "invalid vector sizes");
+   DoEliminateRowsCols(rows_cols, sol.GetData(), rhs.GetData(), NULL,
+                       dpolicy);
+}
+
+void SparseMatrix::EliminateRowsCols(const Array<int> &rows_cols,
+                                     DiagonalPolicy dpolicy)
+{
+   DoEliminateRowsCols(rows_cols, NULL, NULL, NULL, dpolicy);
+}
+
+void SparseMatrix::EliminateRowsCols(const Array<int> &rows_cols,
+                                     SparseMatrix &Ae, DiagonalPolicy dpolicy)
+{
+   DoEliminateRowsCols(rows_cols, NULL, NULL, &Ae, dpolicy);
+}
+
+void SparseMatrix::DoEliminateRowsCols(const Array<int> &rows_cols,
+                                       const double *sol, double *rhs,
+                                       SparseMatrix *Ae,
+                                       DiagonalPolicy dpolicy)
+{
+   MFEM_VERIFY(height == width, "the matrix must be square");
+   MFEM_VERIFY(dpolicy == DIAG_ONE || dpolicy == DIAG_ZERO ||
+               dpolicy == DIAG_KEEP, "invalid diagonal policy");
+
+   Array<bool> marker(height);
+   marker = false;
+   for (int k = 0; k < rows_cols.Size(); k++)
+   {
+      MFEM_ASSERT(rows_cols[k] >= 0 && rows_cols[k] < height,
+                  "Row " << rows_cols[k] << " not in matrix of height "
+                  << height);
+      marker[rows_cols[k]] = true;
+   }
+   const bool *ess = marker.GetData();
+
+   // Entry (i,col) moves to Ae, unless it is a kept diagonal entry.
+   const bool keep_diag = (dpolicy == DIAG_KEEP);
+   auto eliminated = [ess, keep_diag](int i, int col)
+   {
+      return (col == i) ? (ess[i] && !keep_diag) : (ess[i] || ess[col]);
+   };
+
+   int *Ae_i = NULL, *Ae_j = NULL;
+   double *Ae_data = NULL;
+   if (Ae)
+   {
+      // Symbolic pass: the number of eliminated entries in each row
+      Ae_i = mfem::New<int>(height+1);
+      Ae_i[0] = 0;
+#if defined(MFEM_USE_OPENMP) && !defined(MFEM_USE_LEGACY_OPENMP)
+      #pragma omp parallel for if(Device::AllowsHostOpenMP())
+#endif
+      for (int i = 0; i < height; i++)
+      {
+         int cnt = 0;
+         if (Rows == NULL)
+         {
+            for (int j = I[i]; j < I[i+1]; j++)
+            {
+               if (eliminated(i, J[j])) { cnt++; }
+            }
+         }
+         else
+         {
+            for (RowNode *nd = Rows[i]; nd != NULL; nd = nd->Prev)
+            {
+               if (eliminated(i, nd->Column)) { cnt++; }
+            }
+         }
+         Ae_i[i+1] = cnt;
+      }
+      for (int i = 0; i < height; i++) { Ae_i[i+1] += Ae_i[i]; }
+      Ae_j = mfem::New<int>(Ae_i[height]);
+      Ae_data = mfem::New<double>(Ae_i[height]);
+   }
+
+   // Numeric pass: every row is processed independently
+   const double diag = (dpolicy == DIAG_ONE) ? 1.0 : 0.0;
+   auto eliminate = [&](int i, int col, double &a, int &pos)
+   {
+      if (rhs && col == i && ess[i])
+      {
+         rhs[i] = (keep_diag ? a : diag) * sol[i];
+      }
+      if (!eliminated(i, col)) { return; }
+      if (rhs && !ess[i]) { rhs[i] -= a * sol[col]; }
+      if (Ae)
+      {
+         Ae_j[pos] = col;
+         Ae_data[pos++] = (col == i) ? a - diag : a;
+      }
+      a = (col == i) ? diag : 0.0;
+   };
+#if defined(MFEM_USE_OPENMP) && !defined(MFEM_USE_LEGACY_OPENMP)
+   #pragma omp parallel for if(Device::AllowsHostOpenMP())
+#endif
+   for (int i = 0; i < height; i++)
+   {
+      int pos = Ae ? Ae_i[i] : 0;
+      if (Rows == NULL)
+      {
+         for (int j = I[i]; j < I[i+1]; j++)
+         {
+            eliminate(i, J[j], A[j], pos);
+         }
+      }
+      else
+      {
+         for (RowNode *nd = Rows[i]; nd != NULL; nd = nd->Prev)
+         {
+            eliminate(i, nd->Column, nd->Value, pos);
+         }
+      }
+   }
+
+   if (Ae)
+   {
+      SparseMatrix Ae_new(Ae_i, Ae_j, Ae_data, height, width);
+      Ae->Swap(Ae_new);
+   }
+}
+
 void SparseMatrix::SetDiagIdentity()
 {
    for (int i = 0; i < height; i++)
@@ -2061,6 +2485,46 @@ void SparseMatrix::AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
    int i, j, gi, gj, s, t;
    double a;
 
+   if (Finalized() && isSorted)
+   {
+      // Fixed CSR graph with sorted rows: locate the entries with a binary
+      // search instead of scattering the row into the #ColPtrJ array.
+      for (i = 0; i < rows.Size(); i++)
+      {
+         if ((gi=rows[i]) < 0) { gi = -1-gi, s = -1; }
+         else { s = 1; }
+         MFEM_ASSERT(gi < height,
+                     "Trying to insert a row " << gi << " outside the matrix"
+                     " height " << height);
+         const int *row_beg = J + I[gi], *row_end = J + I[gi+1];
+         const int *p = row_beg;
+         for (j = 0; j < cols.Size(); j++)
+         {
+            if ((gj=cols[j]) < 0) { gj = -1-gj, t = -s; }
+            else { t = s; }
+            MFEM_ASSERT(gj < width,
+                        "Trying to insert a column " << gj << " outside the"
+                        " matrix width " << width);
+            a = subm(i, j);
+            if (skip_zeros && a == 0.0)
+            {
+               if (&rows != &cols || subm(j, i) == 0.0)
+               {
+                  continue;
+               }
+            }
+            if (t < 0) { a = -a; }
+            // The columns are often increasing: search from the last entry.
+            if (p == row_end || gj < *p) { p = row_beg; }
+            p = std::lower_bound(p, row_end, gj);
+            MFEM_VERIFY(p != row_end && *p == gj,
+                        "Entry for column " << gj << " is not allocated.");
+            A[p - J] += a;
+         }
+      }
+      return;
+   }
+
    for (i = 0; i < rows.Size(); i++)
    {
       if ((gi=rows[i]) < 0) { gi = -1-gi, s = -1; }
@@ -2810,6 +3274,144 @@ void SparseMatrixFunction (SparseMatrix & S, double (*f)(double))
    }
 }
 
+#ifdef MFEM_USE_OPENMP
+// Threaded transpose of the m x n CSR matrix (A_i,A_j,A_data). Each thread
+// counts the entries per column in an nnz-balanced block of rows, the counts
+// are turned into offsets with prefix sums, and then each thread scatters its
+// block. The result is the same as the one of the sequential algorithm: the
+// rows in each column of At are sorted. The per-thread counts take O(threads*n)
+// memory and work, so the caller uses it only when that is at most nnz.
+static void OmpTranspose(int m, int n, const int *A_i, const int *A_j,
+                         const double *A_data, int *At_i, int *At_j,
+                         double *At_data)
+{
+   const int max_nt = omp_get_max_threads();
+   Array<int> counts(max_nt*n);
+   int *cnt = counts.GetData();
+   #pragma omp parallel num_threads(max_nt)
+   {
+      const int nt = omp_get_num_threads(), t = omp_get_thread_num();
+      int *ct = cnt + t*n;
+      for (int c = 0; c < n; c++) { ct[c] = 0; }
+      const int i_beg = BalancedRowBegin(A_i, m, t, nt);
+      const int i_end = BalancedRowBegin(A_i, m, t+1, nt);
+      for (int k = A_i[i_beg]; k < A_i[i_end]; k++) { ct[A_j[k]]++; }
+      #pragma omp barrier
+      // Offsets of the blocks within each column, and the column sizes
+      #pragma omp for
+      for (int c = 0; c < n; c++)
+      {
+         int s = 0;
+         for (int tt = 0; tt < nt; tt++)
+         {
+            const int ctc = cnt[tt*n + c];
+            cnt[tt*n + c] = s;
+            s += ctc;
+         }
+         At_i[c+1] = s;
+      }
+      #pragma omp single
+      {
+         At_i[0] = 0;
+         for (int c = 0; c < n; c++) { At_i[c+1] += At_i[c]; }
+      }
+      for (int i = i_beg; i < i_end; i++)
+      {
+         for (int k = A_i[i]; k < A_i[i+1]; k++)
+         {
+            const int pos = At_i[A_j[k]] + ct[A_j[k]]++;
+            At_j[pos] = i;
+            At_data[pos] = A_data[k];
+         }
+      }
+   }
+}
+
+// Threaded C = A B for CSR matrices. A symbolic pass computes the number of
+// entries in each row of C, which are turned into the row offsets of C, and
+// a numeric pass computes the entries. Both passes use nnz-balanced blocks of
+// rows of A, with a dense marker array per thread; the threads process their
+// rows in increasing order, so that the entries of each row of C are in the
+// same order as in the sequential algorithm. If C_i is given, the symbolic
+// pass is skipped and C_j is not written.
+static int OmpSpGEMM(int nrowsA, int ncolsB,
+                     const int *A_i, const int *A_j, const double *A_data,
+                     const int *B_i, const int *B_j, const double *B_data,
+                     int *&C_i, int *&C_j, double *&C_data)
+{
+   const bool symbolic = (C_i == NULL);
+   if (symbolic) { C_i = mfem::New<int>(nrowsA+1); }
+   int mismatch = 0;
+   #pragma omp parallel reduction(+:mismatch)
+   {
+      const int nt = omp_get_num_threads(), t = omp_get_thread_num();
+      const int i_beg = BalancedRowBegin(A_i, nrowsA, t, nt);
+      const int i_end = BalancedRowBegin(A_i, nrowsA, t+1, nt);
+      Array<int> marker(ncolsB);
+      int *B_marker = marker.GetData();
+      if (symbolic)
+      {
+         for (int jb = 0; jb < ncolsB; jb++) { B_marker[jb] = -1; }
+         for (int ic = i_beg; ic < i_end; ic++)
+         {
+            int row_nnz = 0;
+            for (int ia = A_i[ic]; ia < A_i[ic+1]; ia++)
+            {
+               const int ja = A_j[ia];
+               for (int ib = B_i[ja]; ib < B_i[ja+1]; ib++)
+               {
+                  const int jb = B_j[ib];
+                  if (B_marker[jb] != ic)
+                  {
+                     B_marker[jb] = ic;
+                     row_nnz++;
+                  }
+               }
+            }
+            C_i[ic+1] = row_nnz;
+         }
+         #pragma omp barrier
+         #pragma omp single
+         {
+            C_i[0] = 0;
+            for (int ic = 0; ic < nrowsA; ic++) { C_i[ic+1] += C_i[ic]; }
+            C_j    = mfem::New<int>(C_i[nrowsA]);
+            C_data = mfem::New<double>(C_i[nrowsA]);
+         }
+      }
+      for (int jb = 0; jb < ncolsB; jb++) { B_marker[jb] = -1; }
+      for (int ic = i_beg; ic < i_end; ic++)
+      {
+         const int row_start = C_i[ic];
+         int counter = row_start;
+         for (int ia = A_i[ic]; ia < A_i[ic+1]; ia++)
+         {
+            const int ja = A_j[ia];
+            const double a_entry = A_data[ia];
+            for (int ib = B_i[ja]; ib < B_i[ja+1]; ib++)
+            {
+               const int jb = B_j[ib];
+               const double b_entry = B_data[ib];
+               if (B_marker[jb] < row_start)
+               {
+                  B_marker[jb] = counter;
+                  if (symbolic) { C_j[counter] = jb; }
+                  C_data[counter] = a_entry*b_entry;
+                  counter++;
+               }
+               else
+               {
+                  C_data[B_marker[jb]] += a_entry*b_entry;
+               }
+            }
+         }
+         if (counter != C_i[ic+1]) { mismatch++; }
+      }
+   }
+   return mismatch;
+}
+#endif
+
 SparseMatrix *Transpose (const SparseMatrix &A)
 {
    MFEM_VERIFY(
@@ -2831,6 +3433,14 @@ SparseMatrix *Transpose (const SparseMatrix &A)
    At_j = mfem::New<int>(nnz);
    At_data = mfem::New<double>(nnz);
 
+#ifdef MFEM_USE_OPENMP
+   if (Device::AllowsHostOpenMP() && (long)omp_get_max_threads()*n <= nnz)
+   {
+      OmpTranspose(m, n, A_i, A_j, A_data, At_i, At_j, At_data);
+      return new SparseMatrix(At_i, At_j, At_data, n, m);
+   }
+#endif
+
    for (i = 0; i <= n; i++)
    {
       At_i[i] = 0;
@@ -2968,6 +3578,32 @@ SparseMatrix *Mult (const SparseMatrix &A, const SparseMatrix &B,
    B_j    = B.GetJ();
    B_data = B.GetData();
 
+#ifdef MFEM_USE_OPENMP
+   if (Device::AllowsHostOpenMP())
+   {
+      if (OAB != NULL)
+      {
+         MFEM_VERIFY(nrowsA == OAB->Height() && ncolsB == OAB->Width(),
+                     "Input matrix sizes do not match output sizes");
+         C_i    = OAB->GetI();
+         C_j    = OAB->GetJ();
+         C_data = OAB->GetData();
+      }
+      else
+      {
+         C_i = C_j = NULL;
+         C_data = NULL;
+      }
+      const int mismatch = OmpSpGEMM(nrowsA, ncolsB, A_i, A_j, A_data,
+                                     B_i, B_j, B_data, C_i, C_j, C_data);
+      MFEM_VERIFY(mismatch == 0, "With pre-allocated output matrix, the "
+                  "number of non-zeros in " << mismatch << " rows did not "
+                  "match the matrix-matrix multiply");
+      return (OAB != NULL) ? OAB :
+             new SparseMatrix(C_i, C_j, C_data, nrowsA, ncolsB);
+   }
+#endif
+
    B_marker = new int[ncolsB];
 
    for (ib = 0; ib < ncolsB; ib++)
@@ -3220,12 +3856,12 @@ SparseMatrix *RAP (const SparseMatrix &A, const SparseMatrix &R,
 }
 
 SparseMatrix *RAP(const SparseMatrix &Rt, const SparseMatrix &A,
-                  const SparseMatrix &P)
+                  const SparseMatrix &P, SparseMatrix *ORAP)
 {
    SparseMatrix * R = Transpose(Rt);
    SparseMatrix * RA = Mult(*R,A);
    delete R;
-   SparseMatrix * out = Mult(*RA, P);
+   SparseMatrix * out = Mult(*RA, P, ORAP);
    delete RA;
    return out;
 }
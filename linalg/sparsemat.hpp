@@ -77,9 +77,18 @@ protected:
    /// Are the columns sorted already.
    bool isSorted;
 
+   /// Per-thread buffers of the threaded AddMultTranspose(), kept between calls.
+   mutable Vector omp_ybuf;
+
    void Destroy();   // Delete all owned data
    void SetEmpty();  // Init all entries with empty values
 
+   // Implementation of the EliminateRowsCols() methods; sol, rhs and Ae may
+   // be NULL.
+   void DoEliminateRowsCols(const Array<int> &rows_cols, const double *sol,
+                            double *rhs, SparseMatrix *Ae,
+                            DiagonalPolicy dpolicy);
+
 public:
    /// Create an empty SparseMatrix.
    SparseMatrix() { SetEmpty(); }
@@ -172,6 +181,20 @@ public:
        preserving the order of the rest of the columns. */
    void MoveDiagonalFirst();
 
+   /** @brief Compute a bandwidth-reducing Reverse Cuthill-McKee ordering of
+       the square matrix, based on the sparsity pattern of A + A^T. */
+   /** On output, @a ordering maps the old row (and column) number to the new
+       one, see mfem::GetRCMOrdering(). The ordering can be applied with
+       PermuteRowsCols(). */
+   void GetRCMOrdering(Array<int> &ordering) const;
+
+   /** @brief Replace the square matrix A with P A P^T, where @a ordering maps
+       the old row (and column) number to the new one. */
+   void PermuteRowsCols(const Array<int> &ordering);
+
+   /// Returns the bandwidth, i.e. the maximal |i-j| over the stored entries.
+   int GetBandwidth() const;
+
    /// Returns reference to a_{ij}.
    virtual double &Elem(int i, int j);
 
@@ -196,13 +219,27 @@ public:
    /// Matrix vector multiplication.
    virtual void Mult(const Vector &x, Vector &y) const;
 
-   /// y += A * x (default)  or  y += a * A * x
+   /** @brief Sparse matrix times multivector (SpMM): Y_j = A X_j for all
+       vectors of @a X. */
+   /** The matrix is read once for all vectors, so this is faster than
+       multiplying the vectors one by one. The rows are processed in parallel
+       with the host OpenMP backend. */
+   virtual void BatchMult(const MultiVector &X, MultiVector &Y) const;
+
+   /** @brief y += A * x (default)  or  y += a * A * x */
+   /** When the host OpenMP backend is enabled, the rows are statically split
+       among the threads in blocks with equal number of nonzeros. */
    void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
 
    /// Multiply a vector with the transposed matrix. y = At * x
    void MultTranspose(const Vector &x, Vector &y) const;
 
-   /// y += At * x (default)  or  y += a * At * x
+   /** @brief y += At * x (default)  or  y += a * At * x */
+   /** When the host OpenMP backend is enabled, each thread accumulates an
+       nnz-balanced block of rows into a private buffer of size #width; the
+       buffers are then summed into @a y. The buffers are kept between calls.
+       The sequential loop is used when the buffers would be larger than the
+       number of nonzeros. */
    void AddMultTranspose(const Vector &x, Vector &y,
                          const double a = 1.0) const;
 
@@ -282,6 +319,30 @@ public:
    void EliminateRowCol(int rc, SparseMatrix &Ae,
                         DiagonalPolicy dpolicy = DIAG_ONE);
 
+   /** @brief Eliminate the rows and columns @a rows_cols and modify the
+       @a rhs using @a sol, with the same result as calling
+       EliminateRowCol(int, const double, Vector &, DiagonalPolicy) for each
+       of them. */
+   /** All rows and columns are eliminated in one thread-parallel pass over
+       the matrix, instead of searching the column entries of each row. The
+       sparsity pattern does not need to be symmetric. */
+   void EliminateRowsCols(const Array<int> &rows_cols, const Vector &sol,
+                          Vector &rhs, DiagonalPolicy dpolicy = DIAG_ONE);
+
+   /// Eliminate the rows and columns @a rows_cols in one pass.
+   void EliminateRowsCols(const Array<int> &rows_cols,
+                          DiagonalPolicy dpolicy = DIAG_ONE);
+
+   /** @brief Eliminate the rows and columns @a rows_cols in one pass and
+       return the eliminated entries in @a Ae, so that (*this) + Ae is equal
+       to the original matrix. */
+   /** The previous content of @a Ae is replaced by a finalized matrix. For
+       new values of the eliminated unknowns, the r.h.s. can then be updated
+       with Ae without repeating the elimination, see
+       BilinearForm::EliminateVDofsInRHS(). */
+   void EliminateRowsCols(const Array<int> &rows_cols, SparseMatrix &Ae,
+                          DiagonalPolicy dpolicy = DIAG_ONE);
+
    /// If a row contains only one diag entry of zero, set it to 1.
    void SetDiagIdentity();
    /// If a row contains only zeros, set its diagonal to 1.
@@ -446,7 +507,9 @@ public:
 void SparseMatrixFunction(SparseMatrix &S, double (*f)(double));
 
 
-/// Transpose of a sparse matrix. A must be finalized.
+/** Transpose of a sparse matrix. A must be finalized. With the host OpenMP
+    backend, the transpose is computed by all threads if A has at least as
+    many nonzeros per column, on average, as there are threads. */
 SparseMatrix *Transpose(const SparseMatrix &A);
 /// Transpose of a sparse matrix. A does not need to be a CSR matrix.
 SparseMatrix *TransposeAbstractSparseMatrix (const AbstractSparseMatrix &A,
@@ -457,7 +520,10 @@ SparseMatrix *TransposeAbstractSparseMatrix (const AbstractSparseMatrix &A,
     of A.B and store the result in OAB.
     If OAB is NULL, we create a new SparseMatrix to store
     the result and return a pointer to it.
-    All matrices must be finalized. */
+    All matrices must be finalized.
+    With the host OpenMP backend, the product is computed by all threads in
+    a symbolic and a numeric pass (only the latter if OAB is given); the
+    result is the same as the sequential one. */
 SparseMatrix *Mult(const SparseMatrix &A, const SparseMatrix &B,
                    SparseMatrix *OAB = NULL);
 
@@ -482,9 +548,11 @@ DenseMatrix *RAP(DenseMatrix &A, const SparseMatrix &P);
 SparseMatrix *RAP(const SparseMatrix &A, const SparseMatrix &R,
                   SparseMatrix *ORAP = NULL);
 
-/// General RAP with given R^T, A and P
+/** General RAP with given R^T, A and P. ORAP is like OAB above: when only
+    the values of A change, passing the previous result reuses its sparsity
+    pattern for the final product. */
 SparseMatrix *RAP(const SparseMatrix &Rt, const SparseMatrix &A,
-                  const SparseMatrix &P);
+                  const SparseMatrix &P, SparseMatrix *ORAP = NULL);
 
 /// Matrix multiplication A^t D A. All matrices must be finalized.
 SparseMatrix *Mult_AtDA(const SparseMatrix &A, const Vector &D,
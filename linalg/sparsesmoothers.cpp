@@ -15,6 +15,7 @@
 #include "matrix.hpp"
 #include "sparsemat.hpp"
 #include "sparsesmoothers.hpp"
+#include "../general/device.hpp"
 #include <iostream>
 
 namespace mfem
@@ -51,6 +52,135 @@ void GSSmoother::Mult(const Vector &x, Vector &y) const
    }
 }
 
+MulticolorGSSmoother::MulticolorGSSmoother(const SparseMatrix &a, int t,
+                                           int it, double w)
+{
+   type = t;
+   iterations = it;
+   omega = w;
+   SetOperator(a);
+}
+
+void MulticolorGSSmoother::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   MFEM_VERIFY(oper->Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(height == width, "the SparseMatrix must be square");
+
+   const int n = height;
+   const int *I = oper->GetI(), *J = oper->GetJ();
+   const double *A = oper->GetData();
+
+   // The graph of A^T, to color the graph of A + A^T.
+   Array<int> tI(n+1), tJ(I[n]);
+   tI = 0;
+   for (int k = 0; k < I[n]; k++) { tI[J[k]+1]++; }
+   for (int i = 0; i < n; i++) { tI[i+1] += tI[i]; }
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++) { tJ[tI[J[k]]++] = i; }
+   }
+   for (int i = n; i > 0; i--) { tI[i] = tI[i-1]; }
+   tI[0] = 0;
+
+   // Greedy coloring: the smallest color not used by the neighbors.
+   Array<int> color(n), mark;
+   color = -1;
+   int num_colors = 0;
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         const int c = color[J[k]];
+         if (c >= 0) { mark[c] = i; }
+      }
+      for (int k = tI[i]; k < tI[i+1]; k++)
+      {
+         const int c = color[tJ[k]];
+         if (c >= 0) { mark[c] = i; }
+      }
+      int c = 0;
+      while (c < num_colors && mark[c] == i) { c++; }
+      if (c == num_colors) { mark.Append(-1); num_colors++; }
+      color[i] = c;
+   }
+
+   // Permute the rows by color, keeping their relative order.
+   color_offsets.SetSize(num_colors+1);
+   color_offsets = 0;
+   for (int i = 0; i < n; i++) { color_offsets[color[i]+1]++; }
+   color_offsets.PartialSum();
+   color_rows.SetSize(n);
+   mark.SetSize(num_colors);
+   for (int c = 0; c < num_colors; c++) { mark[c] = color_offsets[c]; }
+   for (int i = 0; i < n; i++) { color_rows[mark[color[i]]++] = i; }
+
+   inv_diag.SetSize(n);
+   for (int i = 0; i < n; i++)
+   {
+      double d = 0.0;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (J[k] == i) { d += A[k]; }
+      }
+      MFEM_VERIFY(d != 0.0, "zero diagonal in row " << i);
+      inv_diag(i) = 1.0 / d;
+   }
+}
+
+void MulticolorGSSmoother::Sweep(const Vector &x, Vector &y,
+                                 bool forward) const
+{
+   const int *I = oper->GetI(), *J = oper->GetJ(), *rows = color_rows;
+   const double *A = oper->GetData(), *xp = x.GetData();
+   const double *dinv = inv_diag.GetData();
+   double *yp = y.GetData();
+   const double w = omega;
+   const int nc = GetNumColors();
+#ifdef MFEM_USE_OPENMP
+   const bool use_omp = Device::AllowsHostOpenMP();
+#endif
+
+   for (int cc = 0; cc < nc; cc++)
+   {
+      const int c = forward ? cc : nc-1-cc;
+      const int begin = color_offsets[c], end = color_offsets[c+1];
+      // The rows of one color do not couple, so they are updated in parallel.
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for if (use_omp)
+#endif
+      for (int p = begin; p < end; p++)
+      {
+         const int i = rows[p];
+         double sum = xp[i];
+         for (int k = I[i]; k < I[i+1]; k++)
+         {
+            if (J[k] != i) { sum -= A[k] * yp[J[k]]; }
+         }
+         yp[i] += w * (sum * dinv[i] - yp[i]);
+      }
+   }
+}
+
+void MulticolorGSSmoother::Mult(const Vector &x, Vector &y) const
+{
+   if (!iterative_mode)
+   {
+      y = 0.0;
+   }
+   for (int i = 0; i < iterations; i++)
+   {
+      if (type != 2)
+      {
+         Sweep(x, y, true);
+      }
+      if (type != 1)
+      {
+         Sweep(x, y, false);
+      }
+   }
+}
+
 /// Create the Jacobi smoother.
 DSmoother::DSmoother(const SparseMatrix &a, int t, double s, int it)
    : SparseSmoother(a)
@@ -51,6 +51,51 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const;
 };
 
+/** @brief Multicolor Gauss-Seidel (or SOR) smoother of sparse matrix, with
+    the rows of each color swept in parallel. */
+/** When the operator is set, the graph of A + A^T is colored greedily, so that
+    rows of the same color do not couple, and the rows are permuted by color.
+    Every sweep goes through the colors in order (backward sweeps: in reverse
+    order) and, with the "omp" backend, the rows of one color are updated by
+    all threads in parallel.
+
+    This is the Gauss-Seidel method for the matrix permuted by color, so its
+    convergence differs slightly from GSSmoother. The symmetric version (type
+    0) is symmetric (SSOR with @a omega != 1) and can be used as a
+    preconditioner in PCG. */
+class MulticolorGSSmoother : public SparseSmoother
+{
+protected:
+   int type; // 0, 1, 2 - symmetric, forward, backward
+   int iterations;
+   double omega; // relaxation parameter
+
+   /// The rows of color c are color_rows[color_offsets[c]...color_offsets[c+1]).
+   Array<int> color_offsets, color_rows;
+   Vector inv_diag;
+
+   /// One forward or backward (@a forward = false) sweep for A y = x.
+   void Sweep(const Vector &x, Vector &y, bool forward) const;
+
+public:
+   /// Create MulticolorGSSmoother.
+   MulticolorGSSmoother(int t = 0, int it = 1, double w = 1.0)
+   { type = t; iterations = it; omega = w; }
+
+   /// Create MulticolorGSSmoother.
+   MulticolorGSSmoother(const SparseMatrix &a, int t = 0, int it = 1,
+                        double w = 1.0);
+
+   /// Set the (finalized, square) SparseMatrix and compute its coloring.
+   virtual void SetOperator(const Operator &a);
+
+   /// Returns the number of colors of the matrix graph.
+   int GetNumColors() const { return color_offsets.Size() - 1; }
+
+   /// Matrix vector multiplication with the multicolor GS smoother.
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
 /// Data type for scaled Jacobi-type smoother of sparse matrix
 class DSmoother : public SparseSmoother
 {
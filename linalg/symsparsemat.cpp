@@ -0,0 +1,402 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of symmetric sparse matrices with upper-triangular storage
+
+#include "symsparsemat.hpp"
+
+#include <cmath>
+
+namespace mfem
+{
+
+using namespace std;
+
+SymmetricSparseMatrix::SymmetricSparseMatrix(const SparseMatrix &A)
+   : AbstractSparseMatrix(A.Height())
+{
+   MFEM_VERIFY(A.Finalized(), "the SparseMatrix must be finalized");
+   MFEM_VERIFY(A.Height() == A.Width(), "the SparseMatrix must be square");
+
+   const int n = height;
+   const int *aI = A.GetI(), *aJ = A.GetJ();
+   const double *aA = A.GetData();
+
+   // Count the upper-triangular entries, reserving space for the diagonal.
+   int *I = mfem::New<int>(n+1);
+   I[0] = 0;
+   for (int i = 0; i < n; i++)
+   {
+      int cnt = 1;
+      for (int k = aI[i]; k < aI[i+1]; k++)
+      {
+         if (aJ[k] > i) { cnt++; }
+      }
+      I[i+1] = I[i] + cnt;
+   }
+   int *J = mfem::New<int>(I[n]);
+   double *data = mfem::New<double>(I[n]);
+   for (int i = 0; i < n; i++)
+   {
+      int p = I[i];
+      J[p] = i;
+      data[p] = 0.0;
+      p++;
+      for (int k = aI[i]; k < aI[i+1]; k++)
+      {
+         if (aJ[k] == i) { data[I[i]] += aA[k]; }
+         else if (aJ[k] > i) { J[p] = aJ[k]; data[p] = aA[k]; p++; }
+      }
+   }
+   SparseMatrix tmp(I, J, data, n, n);
+   U.Swap(tmp);
+}
+
+void SymmetricSparseMatrix::AddSubMatrix(const Array<int> &dofs,
+                                         const DenseMatrix &subm)
+{
+   const int n = dofs.Size();
+   DenseMatrix subu(n);
+   for (int j = 0; j < n; j++)
+   {
+      const int gj = (dofs[j] >= 0) ? dofs[j] : -1-dofs[j];
+      for (int i = 0; i < n; i++)
+      {
+         const int gi = (dofs[i] >= 0) ? dofs[i] : -1-dofs[i];
+         subu(i,j) = (gi <= gj) ? subm(i,j) : 0.0;
+      }
+   }
+   // Use a separate column array so that the zeroed lower-triangular entries
+   // are skipped by SparseMatrix::AddSubMatrix().
+   Array<int> cols(dofs);
+   U.AddSubMatrix(dofs, cols, subu, 1);
+}
+
+void SymmetricSparseMatrix::Finalize(int skip_zeros)
+{
+   if (!U.Finalized())
+   {
+      // Make sure every row has a diagonal entry.
+      for (int i = 0; i < height; i++)
+      {
+         U.Add(i, i, 0.0);
+      }
+      U.Finalize(0);
+      if (skip_zeros)
+      {
+         // Remove the zero off-diagonal entries in place.
+         int *I = U.GetI(), *J = U.GetJ();
+         double *A = U.GetData();
+         int nnz = 0;
+         for (int i = 0; i < height; i++)
+         {
+            const int beg = I[i], end = I[i+1];
+            I[i] = nnz;
+            for (int k = beg; k < end; k++)
+            {
+               if (A[k] != 0.0 || J[k] == i)
+               {
+                  J[nnz] = J[k];
+                  A[nnz] = A[k];
+                  nnz++;
+               }
+            }
+         }
+         I[height] = nnz;
+      }
+   }
+   U.MoveDiagonalFirst();
+}
+
+const double &SymmetricSparseMatrix::Upper(int i, int j) const
+{
+   const int *I = U.GetI(), *J = U.GetJ();
+   for (int k = I[i]; k < I[i+1]; k++)
+   {
+      if (J[k] == j) { return U.GetData()[k]; }
+   }
+   MFEM_ABORT("Did not find i = " << i << ", j = " << j << " in matrix.");
+   return U.GetData()[0];
+}
+
+SparseMatrix *SymmetricSparseMatrix::ToSparseMatrix() const
+{
+   MFEM_VERIFY(Finalized(), "the matrix must be finalized");
+   const int n = height;
+   const int *uI = U.GetI(), *uJ = U.GetJ();
+   const double *uA = U.GetData();
+
+   int *I = mfem::New<int>(n+1);
+   for (int i = 0; i <= n; i++) { I[i] = 0; }
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = uI[i]; k < uI[i+1]; k++)
+      {
+         I[i+1]++;
+         if (uJ[k] != i) { I[uJ[k]+1]++; }
+      }
+   }
+   for (int i = 0; i < n; i++) { I[i+1] += I[i]; }
+
+   int *J = mfem::New<int>(I[n]);
+   double *data = mfem::New<double>(I[n]);
+   Array<int> pos(n);
+   for (int i = 0; i < n; i++) { pos[i] = I[i]; }
+   // Every row of the full matrix gets its lower-triangular entries first.
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = uI[i]; k < uI[i+1]; k++)
+      {
+         const int j = uJ[k];
+         J[pos[i]] = j;
+         data[pos[i]++] = uA[k];
+         if (j != i)
+         {
+            J[pos[j]] = i;
+            data[pos[j]++] = uA[k];
+         }
+      }
+   }
+   return new SparseMatrix(I, J, data, n, n);
+}
+
+double &SymmetricSparseMatrix::Elem(int i, int j)
+{
+   return const_cast<double &>(Upper(std::min(i, j), std::max(i, j)));
+}
+
+const double &SymmetricSparseMatrix::Elem(int i, int j) const
+{
+   return Upper(std::min(i, j), std::max(i, j));
+}
+
+MatrixInverse *SymmetricSparseMatrix::Inverse() const
+{
+   mfem_error("SymmetricSparseMatrix::Inverse() is not implemented!");
+   return NULL;
+}
+
+int SymmetricSparseMatrix::NumNonZeroElems() const
+{
+   const int *I = U.GetI(), *J = U.GetJ();
+   int nnz = 0;
+   for (int i = 0; i < height; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         nnz += (J[k] == i) ? 1 : 2;
+      }
+   }
+   return nnz;
+}
+
+int SymmetricSparseMatrix::GetRow(const int row, Array<int> &cols,
+                                  Vector &srow) const
+{
+   const int *I = U.GetI(), *J = U.GetJ();
+   const double *A = U.GetData();
+   cols.SetSize(0);
+   Array<double> vals;
+   for (int i = 0; i < row; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (J[k] == row) { cols.Append(i); vals.Append(A[k]); }
+      }
+   }
+   for (int k = I[row]; k < I[row+1]; k++)
+   {
+      cols.Append(J[k]);
+      vals.Append(A[k]);
+   }
+   srow.SetSize(cols.Size());
+   for (int p = 0; p < cols.Size(); p++) { srow(p) = vals[p]; }
+   return 0;
+}
+
+void SymmetricSparseMatrix::EliminateZeroRows(const double threshold)
+{
+   const int *I = U.GetI(), *J = U.GetJ();
+   double *A = U.GetData();
+   Vector norm(height);
+   norm = 0.0;
+   for (int i = 0; i < height; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         norm(i) += fabs(A[k]);
+         if (J[k] != i) { norm(J[k]) += fabs(A[k]); }
+      }
+   }
+   for (int i = 0; i < height; i++)
+   {
+      if (norm(i) <= threshold) { A[I[i]] = 1.0; }
+   }
+}
+
+void SymmetricSparseMatrix::Mult(const Vector &x, Vector &y) const
+{
+   y = 0.0;
+   AddMult(x, y);
+}
+
+void SymmetricSparseMatrix::AddMult(const Vector &x, Vector &y,
+                                    const double a) const
+{
+   MFEM_ASSERT(x.Size() == width && y.Size() == height,
+               "invalid vector sizes");
+   MFEM_ASSERT(Finalized(), "the matrix must be finalized");
+
+   const int *I = U.GetI(), *J = U.GetJ();
+   const double *A = U.GetData(), *xp = x.GetData();
+   double *yp = y.GetData();
+   for (int i = 0; i < height; i++)
+   {
+      const double axi = a * xp[i];
+      const int end = I[i+1];
+      // The diagonal entry is first in the row.
+      double d = A[I[i]] * xp[i];
+      for (int k = I[i]+1; k < end; k++)
+      {
+         const int j = J[k];
+         d += A[k] * xp[j];
+         yp[j] += A[k] * axi;
+      }
+      yp[i] += a * d;
+   }
+}
+
+void SymmetricSparseMatrix::GetDiag(Vector &d) const
+{
+   const int *I = U.GetI();
+   const double *A = U.GetData();
+   d.SetSize(height);
+   for (int i = 0; i < height; i++) { d(i) = A[I[i]]; }
+}
+
+void SymmetricSparseMatrix::EliminateRowsCols(const Array<int> &ess_dofs,
+                                              const Vector &sol, Vector &rhs)
+{
+   const int *I = U.GetI(), *J = U.GetJ();
+   double *A = U.GetData();
+
+   Array<bool> ess(height);
+   ess = false;
+   for (int p = 0; p < ess_dofs.Size(); p++)
+   {
+      const int s = ess_dofs[p];
+      ess[(s >= 0) ? s : (-1-s)] = true;
+   }
+   for (int i = 0; i < height; i++)
+   {
+      if (ess[i]) { A[I[i]] = 1.0; }
+      for (int k = I[i]+1; k < I[i+1]; k++)
+      {
+         const int j = J[k];
+         if (!ess[i] && !ess[j]) { continue; }
+         if (!ess[i]) { rhs(i) -= A[k] * sol(j); }
+         if (!ess[j]) { rhs(j) -= A[k] * sol(i); }
+         A[k] = 0.0;
+      }
+   }
+   for (int i = 0; i < height; i++)
+   {
+      if (ess[i]) { rhs(i) = sol(i); }
+   }
+}
+
+void SymmetricSparseMatrix::Gauss_Seidel_forw(const Vector &b,
+                                              Vector &x) const
+{
+   const int *I = U.GetI(), *J = U.GetJ();
+   const double *A = U.GetData();
+   // z holds b minus the lower-triangular part applied to the new values.
+   Vector z(b);
+   for (int i = 0; i < height; i++)
+   {
+      double s = z(i);
+      const int end = I[i+1];
+      for (int k = I[i]+1; k < end; k++)
+      {
+         s -= A[k] * x(J[k]);
+      }
+      const double diag = A[I[i]];
+      MFEM_VERIFY(diag != 0.0, "zero diagonal in row " << i);
+      const double xi = x(i) = s / diag;
+      for (int k = I[i]+1; k < end; k++)
+      {
+         z(J[k]) -= A[k] * xi;
+      }
+   }
+}
+
+void SymmetricSparseMatrix::Gauss_Seidel_back(const Vector &b,
+                                              Vector &x) const
+{
+   const int *I = U.GetI(), *J = U.GetJ();
+   const double *A = U.GetData();
+   // z = (strictly lower triangle) x, using the values before the sweep.
+   Vector z(height);
+   z = 0.0;
+   for (int i = 0; i < height; i++)
+   {
+      const double xi = x(i);
+      for (int k = I[i]+1; k < I[i+1]; k++)
+      {
+         z(J[k]) += A[k] * xi;
+      }
+   }
+   for (int i = height-1; i >= 0; i--)
+   {
+      double s = b(i) - z(i);
+      for (int k = I[i]+1; k < I[i+1]; k++)
+      {
+         s -= A[k] * x(J[k]);
+      }
+      const double diag = A[I[i]];
+      MFEM_VERIFY(diag != 0.0, "zero diagonal in row " << i);
+      x(i) = s / diag;
+   }
+}
+
+
+void SymmetricGSSmoother::SetOperator(const Operator &a)
+{
+   oper = dynamic_cast<const SymmetricSparseMatrix*>(&a);
+   if (oper == NULL)
+   {
+      mfem_error("SymmetricGSSmoother::SetOperator : not a "
+                 "SymmetricSparseMatrix!");
+   }
+   height = oper->Height();
+   width = oper->Width();
+}
+
+void SymmetricGSSmoother::Mult(const Vector &x, Vector &y) const
+{
+   if (!iterative_mode)
+   {
+      y = 0.0;
+   }
+   for (int i = 0; i < iterations; i++)
+   {
+      if (type != 2)
+      {
+         oper->Gauss_Seidel_forw(x, y);
+      }
+      if (type != 1)
+      {
+         oper->Gauss_Seidel_back(x, y);
+      }
+   }
+}
+
+}
@@ -0,0 +1,152 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SYMSPARSEMAT
+#define MFEM_SYMSPARSEMAT
+
+// Data type for symmetric sparse matrices with upper-triangular storage
+
+#include "../config/config.hpp"
+#include "sparsemat.hpp"
+#include "solvers.hpp"
+
+namespace mfem
+{
+
+/** @brief Symmetric sparse matrix storing only the upper triangle, including
+    the diagonal, in a SparseMatrix. */
+/** Compared to SparseMatrix with both triangles, this roughly halves the
+    memory and the data traffic of Mult().
+
+    The matrix is built in two stages: entries are added with AddSubMatrix()
+    (only the upper-triangular part of the added blocks is used), and then
+    Finalize() converts the storage to CSR with the diagonal entry first in
+    every row. All other methods require a finalized matrix. */
+class SymmetricSparseMatrix : public AbstractSparseMatrix
+{
+protected:
+   /// Upper triangle: U(i,j) = A(i,j) for j >= i.
+   SparseMatrix U;
+
+   /// Entry A(i,j) = A(j,i) with i <= j; aborts if it is not stored.
+   const double &Upper(int i, int j) const;
+
+public:
+   /// Create an empty symmetric matrix of size @a n in the assembly stage.
+   explicit SymmetricSparseMatrix(int n = 0) : AbstractSparseMatrix(n), U(n) { }
+
+   /** @brief Create the symmetric matrix from the upper triangle of the
+       finalized SparseMatrix @a A, which is assumed to be symmetric. */
+   explicit SymmetricSparseMatrix(const SparseMatrix &A);
+
+   /** @brief Add the symmetric block @a subm with rows and columns @a dofs.
+       Only the entries with global row <= global column are stored. */
+   /** Negative indices in @a dofs denote dofs with sign change, as in
+       SparseMatrix::AddSubMatrix(). */
+   void AddSubMatrix(const Array<int> &dofs, const DenseMatrix &subm);
+
+   /// Convert to CSR storage with the diagonal entry first in every row.
+   /** Every row gets a (possibly zero) diagonal entry. If @a skip_zeros is
+       nonzero, the zero off-diagonal entries are removed, like in
+       SparseMatrix::Finalize(); the diagonal entries are always kept. */
+   virtual void Finalize(int skip_zeros = 1);
+
+   bool Finalized() const { return U.Finalized(); }
+
+   /// Return the stored upper triangle.
+   const SparseMatrix &GetUpper() const { return U; }
+   SparseMatrix &GetUpper() { return U; }
+
+   /// Convert to a new SparseMatrix storing both triangles.
+   SparseMatrix *ToSparseMatrix() const;
+
+   /// Returns a reference to a_{ij}; modifying it also modifies a_{ji}.
+   virtual double &Elem(int i, int j);
+
+   /// Returns constant reference to a_{ij}.
+   virtual const double &Elem(int i, int j) const;
+
+   /// Not implemented.
+   virtual MatrixInverse *Inverse() const;
+
+   /// Returns the number of nonzeros of the full (both triangles) matrix.
+   virtual int NumNonZeroElems() const;
+
+   /** @brief Gets the columns indexes and values for row @a row of the full
+       matrix. This requires a search through the whole upper triangle. */
+   virtual int GetRow(const int row, Array<int> &cols, Vector &srow) const;
+
+   /// Set the diagonal of the rows with zero l1-norm (up to @a threshold).
+   virtual void EliminateZeroRows(const double threshold = 1e-12);
+
+   /// Matrix vector multiplication, y = A x.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// y += a A x
+   virtual void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// Same as Mult(), since the matrix is symmetric.
+   virtual void MultTranspose(const Vector &x, Vector &y) const
+   { Mult(x, y); }
+
+   /// Same as AddMult(), since the matrix is symmetric.
+   virtual void AddMultTranspose(const Vector &x, Vector &y,
+                                 const double a = 1.0) const
+   { AddMult(x, y, a); }
+
+   /// Returns the diagonal of the matrix.
+   void GetDiag(Vector &d) const;
+
+   /** @brief Eliminate the rows and columns @a ess_dofs, keeping the matrix
+       symmetric: the eliminated columns are moved to @a rhs using the values
+       in @a sol, the eliminated diagonal entries are set to one and the
+       corresponding entries of @a rhs are set to the values in @a sol. */
+   void EliminateRowsCols(const Array<int> &ess_dofs, const Vector &sol,
+                          Vector &rhs);
+
+   /// One forward Gauss-Seidel sweep for A x = b (x is updated in place).
+   void Gauss_Seidel_forw(const Vector &b, Vector &x) const;
+
+   /// One backward Gauss-Seidel sweep for A x = b (x is updated in place).
+   void Gauss_Seidel_back(const Vector &b, Vector &x) const;
+
+   /// Print the upper triangle in the SparseMatrix format.
+   virtual void Print(std::ostream &out = mfem::out, int width_ = 4) const
+   { U.Print(out, width_); }
+};
+
+
+/// Gauss-Seidel smoother for a SymmetricSparseMatrix.
+class SymmetricGSSmoother : public Solver
+{
+protected:
+   const SymmetricSparseMatrix *oper;
+   int type; // 0, 1, 2 - symmetric, forward, backward
+   int iterations;
+
+public:
+   /// Create SymmetricGSSmoother.
+   SymmetricGSSmoother(int t = 0, int it = 1)
+      : oper(NULL) { type = t; iterations = it; }
+
+   /// Create SymmetricGSSmoother.
+   SymmetricGSSmoother(const SymmetricSparseMatrix &a, int t = 0, int it = 1)
+      : oper(NULL) { type = t; iterations = it; SetOperator(a); }
+
+   virtual void SetOperator(const Operator &a);
+
+   /// Apply the Gauss-Seidel sweeps.
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+}
+
+#endif
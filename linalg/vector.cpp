@@ -24,6 +24,7 @@
 #include <iomanip>
 #include <cmath>
 #include <cstdlib>
+#include <algorithm>
 #include <ctime>
 #include <limits>
 
@@ -961,6 +962,136 @@ double Dot(const int N, const double *x, const double *y)
    return dot;
 }
 
+// z = a x + b y + c z, returning (z, w) when DOT is true. The old values of z
+// are used only when READ_Z is true.
+template <bool READ_Z, bool DOT>
+static double AddAndDotKernel(const int N, const double a, const double *x,
+                              const double b, const double *y, const double c,
+                              double *z, const double *w)
+{
+   double dot = 0.0;
+#if defined(MFEM_USE_OPENMP) && !defined(MFEM_USE_LEGACY_OPENMP)
+   #pragma omp parallel for reduction(+:dot) \
+   if(Device::AllowsHostOpenMP())
+#elif defined(MFEM_USE_LEGACY_OPENMP)
+   #pragma omp parallel for reduction(+:dot)
+#endif
+   for (int i = 0; i < N; i++)
+   {
+      const double zi = READ_Z ? a * x[i] + b * y[i] + c * z[i] :
+                        a * x[i] + b * y[i];
+      z[i] = zi;
+      if (DOT) { dot += zi * w[i]; }
+   }
+   return dot;
+}
+
+double AddAndDot(const double a, const Vector &x, const double b,
+                 const Vector &y, const double c, Vector &z, const Vector *w)
+{
+   const int N = z.Size();
+   MFEM_ASSERT(x.Size() == N && y.Size() == N && (!w || w->Size() == N),
+               "incompatible vector sizes");
+   if (Device::Allows(Backend::CUDA_MASK))
+   {
+      // Each entry of z depends only on the same entries of x, y and z, so
+      // the vectors may coincide.
+      const DeviceVector d_x(x, N);
+      const DeviceVector d_y(y, N);
+      DeviceVector d_z(z, N);
+      if (c == 0.0)
+      {
+         MFEM_FORALL(i, N, d_z[i] = a * d_x[i] + b * d_y[i];);
+      }
+      else
+      {
+         MFEM_FORALL(i, N, d_z[i] = a * d_x[i] + b * d_y[i] + c * d_z[i];);
+      }
+      return w ? Dot(N, z.GetData(), w->GetData()) : 0.0;
+   }
+   const double *xd = x.GetData(), *yd = y.GetData();
+   const double *wd = w ? w->GetData() : NULL;
+   double *zd = z.GetData();
+   if (c == 0.0)
+   {
+      return w ? AddAndDotKernel<false,true>(N, a, xd, b, yd, c, zd, wd) :
+             AddAndDotKernel<false,false>(N, a, xd, b, yd, c, zd, wd);
+   }
+   return w ? AddAndDotKernel<true,true>(N, a, xd, b, yd, c, zd, wd) :
+          AddAndDotKernel<true,false>(N, a, xd, b, yd, c, zd, wd);
+}
+
+// x += a p, r += b q, returning (r, w) when DOT is true.
+template <bool DOT>
+static double AddTwoAndDotKernel(const int N, const double a, const double *p,
+                                 double *x, const double b, const double *q,
+                                 double *r, const double *w)
+{
+   double dot = 0.0;
+#if defined(MFEM_USE_OPENMP) && !defined(MFEM_USE_LEGACY_OPENMP)
+   #pragma omp parallel for reduction(+:dot) \
+   if(Device::AllowsHostOpenMP())
+#elif defined(MFEM_USE_LEGACY_OPENMP)
+   #pragma omp parallel for reduction(+:dot)
+#endif
+   for (int i = 0; i < N; i++)
+   {
+      x[i] += a * p[i];
+      const double ri = r[i] + b * q[i];
+      r[i] = ri;
+      if (DOT) { dot += ri * w[i]; }
+   }
+   return dot;
+}
+
+double AddTwoAndDot(const double a, const Vector &p, Vector &x,
+                    const double b, const Vector &q, Vector &r,
+                    const Vector *w)
+{
+   const int N = r.Size();
+   MFEM_ASSERT(p.Size() == x.Size() && q.Size() == N &&
+               (!w || w->Size() == N), "incompatible vector sizes");
+   if (Device::Allows(Backend::CUDA_MASK))
+   {
+      // Unfused device operations
+      x.Add(a, p);
+      r.Add(b, q);
+      return w ? Dot(N, r.GetData(), w->GetData()) : 0.0;
+   }
+   MFEM_ASSERT(x.Size() == N, "incompatible vector sizes");
+   return w ?
+          AddTwoAndDotKernel<true>(N, a, p.GetData(), x.GetData(), b,
+                                   q.GetData(), r.GetData(), w->GetData()) :
+          AddTwoAndDotKernel<false>(N, a, p.GetData(), x.GetData(), b,
+                                    q.GetData(), r.GetData(), NULL);
+}
+
+void MultiDot(const int nv, const Vector *const *v, const Vector &w,
+              double *dots)
+{
+   if (Device::Allows(Backend::CUDA_MASK))
+   {
+      for (int j = 0; j < nv; j++) { dots[j] = (*v[j]) * w; }
+      return;
+   }
+   // The rows are processed in blocks, so that the block of w stays in cache
+   // while it is multiplied with all v[j].
+   const int n = w.Size(), bsize = 512;
+   const double *wd = w.GetData();
+   for (int j = 0; j < nv; j++) { dots[j] = 0.0; }
+   for (int i0 = 0; i0 < n; i0 += bsize)
+   {
+      const int i1 = std::min(i0 + bsize, n);
+      for (int j = 0; j < nv; j++)
+      {
+         const double *vd = v[j]->GetData();
+         double d = 0.0;
+         for (int i = i0; i < i1; i++) { d += vd[i] * wd[i]; }
+         dots[j] += d;
+      }
+   }
+}
+
 #ifdef MFEM_USE_SUNDIALS
 
 #ifndef SUNTRUE
@@ -454,6 +454,37 @@ double Min(const int N, const double *x);
 /// Kernel of the inner product of arrays x and y of size N
 double Dot(const int N, const double *x, const double *y);
 
+/** @name Fused kernels for Krylov solvers
+
+    These kernels combine vector updates with the inner products that the
+    iterative solvers need next, so that each vector is read from memory once
+    instead of once per operation. The returned inner products are local, i.e.
+    they are not reduced over MPI ranks. */
+///@{
+
+/** @brief Set z = a * x + b * y + c * z and return the local inner product
+    (z, w) of the result, or 0 if @a w is NULL. */
+/** The vectors @a x, @a y and @a w may coincide with @a z. If @a c is zero,
+    the old values of @a z are not used. */
+double AddAndDot(const double a, const Vector &x, const double b,
+                 const Vector &y, const double c, Vector &z,
+                 const Vector *w = NULL);
+
+/** @brief Set x += a * p and r += b * q and return the local inner product
+    (r, w) of the updated @a r, or 0 if @a w is NULL. */
+/** This is the solution and residual update of CG-type methods, with the
+    norm of the new residual for w = r. */
+double AddTwoAndDot(const double a, const Vector &p, Vector &x,
+                    const double b, const Vector &q, Vector &r,
+                    const Vector *w = NULL);
+
+/** @brief Compute the local inner products dots[j] = (v[j], w) for
+    j = 0,...,nv-1 with a single pass over @a w. */
+void MultiDot(const int nv, const Vector *const *v, const Vector &w,
+              double *dots);
+
+///@}
+
 /// Class for a simple Vector of size 3
 class Vector3
 {
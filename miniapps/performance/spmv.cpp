@@ -0,0 +1,180 @@
+//                    MFEM SpMV Benchmark
+//
+// Compile with: make spmv
+//
+// Sample runs:  spmv -d omp
+//               spmv -d omp -m ../../data/fichera.mesh -o 2 -amr 2
+//               spmv -d omp -m ../../data/star.mesh -o 3 -r 3 -dg
+//
+// Description:  This miniapp benchmarks the multithreaded SparseMatrix::Mult
+//               and SparseMatrix::MultTranspose methods, which statically
+//               split the rows among the threads in blocks with equal number
+//               of nonzeros, against a plain row-parallel loop (the generic
+//               MFEM_FORALL path) and an atomic-update transpose product.
+//
+//               The test matrices are H1 diffusion matrices on meshes with
+//               random nonconforming refinement (hanging node constraints) or
+//               interior penalty DG matrices, both of which lead to rows with
+//               very different lengths.
+
+#include "mfem.hpp"
+#include <iostream>
+#include <iomanip>
+
+#ifdef MFEM_USE_OPENMP
+#include <omp.h>
+#endif
+
+using namespace std;
+using namespace mfem;
+
+// Reference y = A x: one parallel loop over the rows.
+static void RefMult(const SparseMatrix &A, const Vector &x, Vector &y)
+{
+   const int *I = A.GetI(), *J = A.GetJ(), height = A.Height();
+   const double *a = A.GetData(), *xp = x.GetData();
+   double *yp = y.GetData();
+   #pragma omp parallel for
+   for (int i = 0; i < height; i++)
+   {
+      double d = 0.0;
+      for (int j = I[i]; j < I[i+1]; j++) { d += a[j] * xp[J[j]]; }
+      yp[i] = d;
+   }
+}
+
+// Reference y = A^t x: one parallel loop over the rows with atomic updates.
+static void RefMultTranspose(const SparseMatrix &A, const Vector &x, Vector &y)
+{
+   const int *I = A.GetI(), *J = A.GetJ(), height = A.Height();
+   const double *a = A.GetData(), *xp = x.GetData();
+   double *yp = y.GetData();
+   y = 0.0;
+   #pragma omp parallel for
+   for (int i = 0; i < height; i++)
+   {
+      for (int j = I[i]; j < I[i+1]; j++)
+      {
+         #pragma omp atomic
+         yp[J[j]] += a[j] * xp[i];
+      }
+   }
+}
+
+int main(int argc, char *argv[])
+{
+   // 1. Parse command-line options.
+   const char *mesh_file = "../../data/star.mesh";
+   int order = 2;
+   int ref_levels = 2;
+   int amr_levels = 2;
+   bool dg = false;
+   int nmult = 50;
+   const char *device = "omp";
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&mesh_file, "-m", "--mesh",
+                  "Mesh file to use.");
+   args.AddOption(&order, "-o", "--order",
+                  "Finite element order (polynomial degree).");
+   args.AddOption(&ref_levels, "-r", "--refine",
+                  "Number of uniform refinements.");
+   args.AddOption(&amr_levels, "-amr", "--amr-levels",
+                  "Number of random nonconforming refinements.");
+   args.AddOption(&dg, "-dg", "--discontinuous", "-no-dg",
+                  "--no-discontinuous", "Use an interior penalty DG matrix.");
+   args.AddOption(&nmult, "-n", "--num-mult",
+                  "Number of products to time.");
+   args.AddOption(&device, "-d", "--device",
+                  "Device configuration string, see Device::Configure().");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      return 1;
+   }
+   args.PrintOptions(cout);
+   Device::Configure(device);
+   Device::Print();
+
+   // 2. Build the mesh and the test matrix.
+   Mesh mesh(mesh_file, 1, 1);
+   const int dim = mesh.Dimension();
+   for (int l = 0; l < ref_levels; l++) { mesh.UniformRefinement(); }
+   if (!dg) { mesh.EnsureNCMesh(); }
+   srand(0);
+   for (int l = 0; l < amr_levels; l++) { mesh.RandomRefinement(0.3); }
+
+   FiniteElementCollection *fec;
+   if (dg) { fec = new DG_FECollection(order, dim); }
+   else { fec = new H1_FECollection(order, dim); }
+   FiniteElementSpace fes(&mesh, fec);
+
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   if (dg)
+   {
+      const double sigma = -1.0, kappa = (order+1)*(order+1);
+      a.AddInteriorFaceIntegrator(new DGDiffusionIntegrator(one, sigma, kappa));
+   }
+   a.Assemble();
+   a.Finalize();
+   const SparseMatrix &A = a.SpMat();
+
+   int min_row = A.Width(), max_row = 0;
+   for (int i = 0; i < A.Height(); i++)
+   {
+      min_row = std::min(min_row, A.RowSize(i));
+      max_row = std::max(max_row, A.RowSize(i));
+   }
+   cout << "Matrix size: " << A.Height() << ", nnz: " << A.NumNonZeroElems()
+        << ", row sizes: [" << min_row << ", " << max_row << "]" << endl;
+#ifdef MFEM_USE_OPENMP
+   cout << "Threads: " << omp_get_max_threads() << endl;
+#endif
+
+   // 3. Switch to the configured backend, time the products and compare the
+   //    results.
+   Device::Enable();
+   Vector x(A.Width()), y(A.Height()), y_ref(A.Height());
+   Vector xt(A.Height()), yt(A.Width()), yt_ref(A.Width());
+   x.Randomize(1);
+   xt.Randomize(2);
+
+   StopWatch sw;
+   const double gb = 1e-9*(12.0*A.NumNonZeroElems() + 8.0*A.Height() +
+                           8.0*A.Width());
+   struct { const char *name; int kind; } tests[4] =
+   {
+      { "Mult (reference)", 0 }, { "Mult", 1 },
+      { "MultTranspose (reference)", 2 }, { "MultTranspose", 3 }
+   };
+   for (int k = 0; k < 4; k++)
+   {
+      sw.Clear();
+      sw.Start();
+      for (int it = 0; it < nmult; it++)
+      {
+         switch (tests[k].kind)
+         {
+            case 0: RefMult(A, x, y_ref); break;
+            case 1: A.Mult(x, y); break;
+            case 2: RefMultTranspose(A, xt, yt_ref); break;
+            case 3: A.MultTranspose(xt, yt); break;
+         }
+      }
+      sw.Stop();
+      const double t = sw.RealTime()/nmult;
+      cout << setw(28) << left << tests[k].name << ": " << t*1e3 << " ms, "
+           << gb/t << " GB/s" << endl;
+   }
+
+   y -= y_ref;
+   yt -= yt_ref;
+   cout << "|y - y_ref|_max = " << y.Normlinf()
+        << ", |yt - yt_ref|_max = " << yt.Normlinf() << endl;
+
+   delete fec;
+   return 0;
+}
@@ -0,0 +1,258 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+#include <limits>
+
+using namespace mfem;
+
+TEST_CASE("AssemblyLevel::AUTO cost model",
+          "[BilinearForm]")
+{
+   ConstantCoefficient one(1.0);
+   AssemblyCostModel model;
+   model.SetMachineParameters(1e10, 1e10);
+   model.SetMemoryBudget(1e9); // every level fits: pick the fastest
+   model.SetNumMult(100);
+
+   SECTION("Low order prefers full assembly")
+   {
+      Mesh mesh(4, 4, Element::QUADRILATERAL);
+      H1_FECollection fec(1, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+
+      REQUIRE(model.IsSupported(a, AssemblyLevel::PARTIAL));
+      REQUIRE(!model.IsSupported(a, AssemblyLevel::ELEMENT));
+      AssemblyCostModel::Estimate fa =
+         model.GetEstimate(a, AssemblyLevel::FULL);
+      AssemblyCostModel::Estimate pa =
+         model.GetEstimate(a, AssemblyLevel::PARTIAL);
+      REQUIRE(fa.memory < 1e9);
+      REQUIRE(pa.memory < 1e9);
+      REQUIRE(fa.setup_time + 100*fa.mult_time <
+              pa.setup_time + 100*pa.mult_time);
+      REQUIRE(model.Select(a) == AssemblyLevel::FULL);
+   }
+
+   SECTION("High order prefers partial assembly")
+   {
+      Mesh mesh(2, 2, 2, Element::HEXAHEDRON);
+      H1_FECollection fec(4, 3);
+      FiniteElementSpace fes(&mesh, &fec);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+
+      AssemblyCostModel::Estimate fa =
+         model.GetEstimate(a, AssemblyLevel::FULL);
+      AssemblyCostModel::Estimate pa =
+         model.GetEstimate(a, AssemblyLevel::PARTIAL);
+      REQUIRE(fa.memory < 1e9);
+      REQUIRE(pa.memory < fa.memory);
+      REQUIRE(pa.setup_time + 100*pa.mult_time <
+              fa.setup_time + 100*fa.mult_time);
+      REQUIRE(model.Select(a) == AssemblyLevel::PARTIAL);
+   }
+
+   SECTION("Memory budget")
+   {
+      Mesh mesh(8, 8, Element::QUADRILATERAL);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+
+      // Flops are expensive: full assembly is the fastest, partial assembly
+      // uses less memory.
+      AssemblyCostModel slow_flops(model);
+      slow_flops.SetMachineParameters(1e12, 1e8);
+      AssemblyCostModel::Estimate fa =
+         slow_flops.GetEstimate(a, AssemblyLevel::FULL);
+      AssemblyCostModel::Estimate pa =
+         slow_flops.GetEstimate(a, AssemblyLevel::PARTIAL);
+      REQUIRE(pa.memory < fa.memory);
+      REQUIRE(slow_flops.Select(a) == AssemblyLevel::FULL);
+
+      // Full assembly does not fit
+      slow_flops.SetMemoryBudget(0.5*(pa.memory + fa.memory));
+      REQUIRE(slow_flops.Select(a) == AssemblyLevel::PARTIAL);
+
+      // Nothing fits: pick the smallest memory
+      slow_flops.SetMemoryBudget(1.0);
+      REQUIRE(slow_flops.Select(a) == AssemblyLevel::PARTIAL);
+   }
+
+   SECTION("Unsupported partial assembly")
+   {
+      Mesh mesh(4, 4, Element::TRIANGLE);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new MassIntegrator);
+
+      REQUIRE(!model.IsSupported(a, AssemblyLevel::PARTIAL));
+      REQUIRE(model.Select(a) == AssemblyLevel::FULL);
+   }
+
+   SECTION("Action of the selected level")
+   {
+      Mesh mesh(3, 3, Element::QUADRILATERAL);
+      H1_FECollection fec(3, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+
+      BilinearForm a_full(&fes);
+      a_full.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a_full.Assemble();
+      a_full.Finalize();
+
+      AssemblyCostModel pa_model(model);
+      pa_model.SetMemoryBudget(0.0);
+      pa_model.SetMachineParameters(1e10, 1e14); // flops are cheap
+      pa_model.SetNumMult(1000000);
+      BilinearForm a_auto(&fes);
+      a_auto.SetAssemblyLevel(AssemblyLevel::AUTO);
+      a_auto.SetAssemblyCostModel(pa_model);
+      a_auto.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a_auto.Assemble();
+      REQUIRE(a_auto.GetAssemblyLevel() == AssemblyLevel::PARTIAL);
+
+      Array<int> ess_tdof_list;
+      OperatorPtr A_full, A_auto;
+      a_full.FormSystemMatrix(ess_tdof_list, A_full);
+      a_auto.FormSystemMatrix(ess_tdof_list, A_auto);
+
+      Vector x(fes.GetTrueVSize()), y_full(x.Size()), y_auto(x.Size());
+      x.Randomize(1);
+      A_full->Mult(x, y_full);
+      A_auto->Mult(x, y_auto);
+      y_auto -= y_full;
+      REQUIRE(y_auto.Normlinf() < 1e-10*y_full.Normlinf());
+   }
+}
+
+static SparseMatrix *AssembleElasticity(FiniteElementSpace &fes, bool ps)
+{
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fes);
+   a.UsePrecomputedSparsity(ps);
+   a.AddDomainIntegrator(new ElasticityIntegrator(one, one));
+   a.Assemble();
+   a.Finalize();
+   return a.LoseMat();
+}
+
+TEST_CASE("Precomputed sparsity", "[BilinearForm]")
+{
+   Mesh mesh(3, 3, 2, Element::HEXAHEDRON);
+   H1_FECollection fec(2, 3);
+   ConstantCoefficient one(1.0);
+
+   SECTION("Vector spaces")
+   {
+      for (int ordering = Ordering::byNODES; ordering <= Ordering::byVDIM;
+           ordering++)
+      {
+         FiniteElementSpace fes(&mesh, &fec, 3, ordering);
+         SparseMatrix *A = AssembleElasticity(fes, false);
+         SparseMatrix *B = AssembleElasticity(fes, true);
+         SparseMatrix *D = Add(1.0, *A, -1.0, *B);
+         REQUIRE(D->MaxNorm() < 1e-12 * A->MaxNorm());
+         delete D;
+         delete B;
+         delete A;
+      }
+   }
+
+   SECTION("DG reassembly reuses the graph")
+   {
+      DG_FECollection dg_fec(2, 3);
+      FiniteElementSpace fes(&mesh, &dg_fec);
+      BilinearForm a(&fes);
+      a.UsePrecomputedSparsity();
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.AddInteriorFaceIntegrator(new DGDiffusionIntegrator(one, -1.0, 9.0));
+      a.Assemble();
+      a.Finalize();
+      const int *I = a.SpMat().GetI(), *J = a.SpMat().GetJ();
+      const double *A = a.SpMat().GetData();
+      const double norm = a.SpMat().MaxNorm();
+
+      a.Update();
+      a.Assemble();
+      a.Finalize();
+      REQUIRE(a.SpMat().GetI() == I);
+      REQUIRE(a.SpMat().GetJ() == J);
+      REQUIRE(a.SpMat().GetData() == A);
+      REQUIRE(a.SpMat().MaxNorm() == Approx(norm));
+   }
+}
+
+TEST_CASE("Single-precision partial assembly", "[BilinearForm]")
+{
+   Mesh mesh(6, 6, 6, Element::HEXAHEDRON);
+   H1_FECollection fec(3, 3);
+   FiniteElementSpace fes(&mesh, &fec);
+   ConstantCoefficient one(1.0);
+   Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdof_list;
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   Vector x(fes.GetTrueVSize()), y_dp(x.Size()), y_sp(x.Size());
+   x.Randomize(1);
+   for (int i = 0; i < ess_tdof_list.Size(); i++) { x(ess_tdof_list[i]) = 0.0; }
+
+   BilinearForm a_dp(&fes), a_sp(&fes);
+   BilinearForm *forms[2] = { &a_dp, &a_sp };
+   OperatorPtr A_dp, A_sp;
+   OperatorPtr *ops[2] = { &A_dp, &A_sp };
+   for (int sp = 0; sp < 2; sp++)
+   {
+      BilinearForm &a = *forms[sp];
+      a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      a.EnableSinglePrecisionPA(sp == 1);
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.AddDomainIntegrator(new MassIntegrator(one));
+      a.Assemble();
+      REQUIRE(a.SinglePrecisionPAIsEnabled() == (sp == 1));
+      a.FormSystemMatrix(ess_tdof_list, *ops[sp]);
+   }
+   A_dp->Mult(x, y_dp);
+   A_sp->Mult(x, y_sp);
+
+   // Changing the precision after assembly takes effect at the next assembly.
+   Vector y(x.Size());
+   a_dp.EnableSinglePrecisionPA();
+   A_dp->Mult(x, y);
+   y -= y_dp;
+   REQUIRE(y.Normlinf() == 0.0);
+
+   // CG converges with the single-precision operator, down to a tolerance
+   // above the float accuracy.
+   Vector u(x.Size());
+   u = 0.0;
+   CGSolver cg;
+   cg.SetOperator(*A_sp);
+   cg.SetRelTol(1e-5);
+   cg.SetMaxIter(500);
+   cg.Mult(y_dp, u);
+   REQUIRE(cg.GetConverged());
+   u -= x;
+   REQUIRE(u.Normlinf() < 1e-3*x.Normlinf());
+
+   y_sp -= y_dp;
+   const double rel_diff = y_sp.Normlinf() / y_dp.Normlinf();
+   const double float_eps = std::numeric_limits<float>::epsilon();
+   REQUIRE(rel_diff > 1e-3*float_eps);
+   REQUIRE(rel_diff < 1e2*float_eps);
+}
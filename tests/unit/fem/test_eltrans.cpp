@@ -0,0 +1,130 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+static void Deform(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.1*sin(3.0*x(x.Size()-1));
+   y(x.Size()-1) += 0.05*x(0)*x(0);
+   if (x.Size() == 3) { y(1) += 0.1*x(0)*x(2); }
+}
+
+static double MaxDiff(const DenseMatrix &A, const DenseMatrix &B)
+{
+   REQUIRE(A.Height() == B.Height());
+   REQUIRE(A.Width() == B.Width());
+   DenseMatrix C(A);
+   C -= B;
+   return C.MaxMaxNorm();
+}
+
+// Compare the fixed-size Jacobian kernels with the generic DenseMatrix
+// functions and the batched evaluation with the point-wise one.
+static void CheckTransformations(Mesh &mesh, int sdim, int dim)
+{
+   const double tol = 1e-12;
+   DenseMatrix J, dshape, adj, inv;
+   DenseTensor Jq, adjq;
+   Vector w;
+   for (int e = 0; e < mesh.GetNE(); e++)
+   {
+      IsoparametricTransformation T;
+      mesh.GetElementTransformation(e, &T);
+      REQUIRE(T.GetSpaceDim() == sdim);
+      REQUIRE(T.GetDimension() == dim);
+
+      const IntegrationRule &ir =
+         IntRules.Get(T.GetGeometryType(), 2*T.OrderJ() + 1);
+      const FiniteElement *fe = T.GetFE();
+      dshape.SetSize(fe->GetDof(), dim);
+      J.SetSize(sdim, dim);
+      adj.SetSize(dim, sdim);
+      inv.SetSize(dim, sdim);
+      for (int q = 0; q < ir.GetNPoints(); q++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(q);
+         fe->CalcDShape(ip, dshape);
+         Mult(T.GetPointMat(), dshape, J);
+         CalcAdjugate(J, adj);
+         CalcInverse(J, inv);
+
+         T.SetIntPoint(&ip);
+         REQUIRE(MaxDiff(T.Jacobian(), J) < tol);
+         REQUIRE(fabs(T.Weight() - J.Weight()) < tol);
+         REQUIRE(MaxDiff(T.AdjugateJacobian(), adj) < tol);
+         REQUIRE(MaxDiff(T.InverseJacobian(), inv) < tol);
+      }
+
+      const IntegrationPoint &ip0 = ir.IntPoint(0);
+      T.SetIntPoint(&ip0);
+      T.CalcJacobians(ir, Jq, &w, &adjq);
+      REQUIRE(&T.GetIntPoint() == &ip0);
+      REQUIRE(Jq.SizeK() == ir.GetNPoints());
+      for (int q = 0; q < ir.GetNPoints(); q++)
+      {
+         T.SetIntPoint(&ir.IntPoint(q));
+         REQUIRE(MaxDiff(Jq(q), T.Jacobian()) < tol);
+         REQUIRE(fabs(w(q) - T.Weight()) < tol);
+         REQUIRE(MaxDiff(adjq(q), T.AdjugateJacobian()) < tol);
+      }
+   }
+}
+
+TEST_CASE("Fixed-size Jacobians", "[ElementTransformation]")
+{
+   SECTION("1D")
+   {
+      Mesh mesh(4);
+      mesh.SetCurvature(2);
+      mesh.Transform(Deform);
+      CheckTransformations(mesh, 1, 1);
+   }
+
+   SECTION("2D")
+   {
+      Mesh mesh(3, 3, Element::QUADRILATERAL);
+      mesh.SetCurvature(2);
+      mesh.Transform(Deform);
+      CheckTransformations(mesh, 2, 2);
+   }
+
+   SECTION("3D")
+   {
+      Mesh mesh(2, 2, 2, Element::TETRAHEDRON);
+      mesh.SetCurvature(2);
+      mesh.Transform(Deform);
+      CheckTransformations(mesh, 3, 3);
+   }
+
+   SECTION("Curves")
+   {
+      for (int sdim = 2; sdim <= 3; sdim++)
+      {
+         Mesh mesh(4);
+         mesh.SetCurvature(2, false, sdim);
+         mesh.Transform(Deform);
+         CheckTransformations(mesh, sdim, 1);
+      }
+   }
+
+   SECTION("Surface")
+   {
+      Mesh mesh(3, 3, Element::TRIANGLE);
+      mesh.SetCurvature(3, false, 3);
+      mesh.Transform(Deform);
+      CheckTransformations(mesh, 3, 2);
+   }
+}
@@ -0,0 +1,120 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+#include <sstream>
+
+using namespace mfem;
+
+static void func(const Vector &x, Vector &v)
+{
+   v(0) = sin(x(0)) + x(1);
+   v(1) = x(0)*x(1);
+}
+
+TEST_CASE("RCM DOF reordering", "[FiniteElementSpace]")
+{
+   Mesh mesh(8, 5, Element::QUADRILATERAL, true, 1.0, 1.0, false);
+   ConstantCoefficient one(1.0);
+   VectorFunctionCoefficient vcoeff(2, func);
+
+   // An ND space tests the dofs with sign changes
+   H1_FECollection h1_fec(2, 2);
+   ND_FECollection nd_fec(2, 2);
+
+   for (int s = 0; s < 2; s++)
+   {
+      const FiniteElementCollection *fec = (s == 0) ?
+                                           (FiniteElementCollection*)&h1_fec :
+                                           (FiniteElementCollection*)&nd_fec;
+      const int vdim = (s == 0) ? 2 : 1;
+      FiniteElementSpace fes(&mesh, fec, vdim, Ordering::byVDIM);
+      FiniteElementSpace rfes(&mesh, fec, vdim, Ordering::byVDIM);
+      rfes.ReorderDofsRCM();
+      const Array<int> &perm = rfes.GetDofPermutation();
+      REQUIRE(perm.Size() == fes.GetNDofs());
+
+      BilinearForm a(&fes), ra(&rfes);
+      for (int k = 0; k < 2; k++)
+      {
+         BilinearForm &form = (k == 0) ? a : ra;
+         if (s == 0)
+         {
+            form.AddDomainIntegrator(new VectorDiffusionIntegrator(one));
+            form.AddDomainIntegrator(new VectorMassIntegrator(one));
+         }
+         else
+         {
+            form.AddDomainIntegrator(new CurlCurlIntegrator(one));
+            form.AddDomainIntegrator(new VectorFEMassIntegrator(one));
+         }
+      }
+      a.Assemble();
+      a.Finalize();
+      ra.Assemble();
+      ra.Finalize();
+      SparseMatrix &A = a.SpMat(), &RA = ra.SpMat();
+      REQUIRE(RA.GetBandwidth() < A.GetBandwidth());
+
+      // The reordered matrix is the symmetric permutation of the original one
+      Array<int> vperm(fes.GetVSize());
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         for (int i = 0; i < fes.GetNDofs(); i++)
+         {
+            vperm[fes.DofToVDof(i, vd)] = fes.DofToVDof(perm[i], vd);
+         }
+      }
+      SparseMatrix PA(A);
+      PA.PermuteRowsCols(vperm);
+      SparseMatrix *D = Add(1.0, PA, -1.0, RA);
+      REQUIRE(D->MaxNorm() < 1e-12 * A.MaxNorm());
+      delete D;
+
+      // Projection and essential DOFs map back to the natural numbering
+      GridFunction x(&fes), rx(&rfes);
+      x.ProjectCoefficient(vcoeff);
+      rx.ProjectCoefficient(vcoeff);
+      Vector nx, rx2;
+      rfes.MapToNaturalDofs(rx, nx);
+      nx -= x;
+      REQUIRE(nx.Normlinf() < 1e-12);
+      rfes.MapFromNaturalDofs(x, rx2);
+      rx2 -= rx;
+      REQUIRE(rx2.Normlinf() < 1e-12);
+
+      Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess, ress;
+      ess_bdr = 1;
+      fes.GetEssentialTrueDofs(ess_bdr, ess);
+      rfes.GetEssentialTrueDofs(ess_bdr, ress);
+      REQUIRE(ess.Size() == ress.Size());
+      for (int i = 0; i < ess.Size(); i++) { ess[i] = vperm[ess[i]]; }
+      ess.Sort();
+      ress.Sort();
+      for (int i = 0; i < ess.Size(); i++) { REQUIRE(ess[i] == ress[i]); }
+
+      // GridFunction::Save() writes the natural numbering
+      std::stringstream ss;
+      ss.precision(16);
+      rx.Save(ss);
+      GridFunction lx(&mesh, ss);
+      lx -= x;
+      REQUIRE(lx.Normlinf() < 1e-12);
+
+      // SparseMatrix-level RCM ordering
+      Array<int> ordering;
+      A.GetRCMOrdering(ordering);
+      PA = A;
+      PA.PermuteRowsCols(ordering);
+      REQUIRE(PA.GetBandwidth() < A.GetBandwidth());
+   }
+}
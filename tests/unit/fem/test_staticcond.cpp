@@ -0,0 +1,67 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+static void AssembleDiffusion(FiniteElementSpace &fes, StaticCondensation &sc)
+{
+   DiffusionIntegrator integ;
+   DenseMatrix elmat;
+   sc.Init(true, false);
+   for (int i = 0; i < fes.GetNE(); i++)
+   {
+      integ.AssembleElementMatrix(*fes.GetFE(i),
+                                  *fes.GetElementTransformation(i), elmat);
+      sc.AssembleMatrix(i, elmat);
+   }
+   sc.Finalize();
+}
+
+TEST_CASE("Static condensation elimination", "[StaticCondensation]")
+{
+   Mesh mesh(4, 4, Element::QUADRILATERAL, true, 1.0, 1.0, false);
+   H1_FECollection fec(3, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+
+   StaticCondensation sc_twice(&fes), sc_once(&fes);
+   AssembleDiffusion(fes, sc_twice);
+   AssembleDiffusion(fes, sc_once);
+   REQUIRE(sc_twice.ReducesTrueVSize());
+
+   Array<int> list1, list2, list_all;
+   const int n = sc_once.GetNExDofs();
+   for (int i = 0; i < n; i += 7) { list1.Append(i); list_all.Append(i); }
+   for (int i = 3; i < n; i += 7) { list2.Append(i); list_all.Append(i); }
+
+   // Eliminating the two lists one after the other gives the same matrices
+   // as eliminating their union at once.
+   sc_twice.EliminateReducedTrueDofs(list1, Matrix::DIAG_ONE);
+   sc_twice.EliminateReducedTrueDofs(list2, Matrix::DIAG_ONE);
+   sc_once.EliminateReducedTrueDofs(list_all, Matrix::DIAG_ONE);
+   REQUIRE(sc_twice.HasEliminatedBC());
+
+   Vector x(n), y_twice(n), y_once(n);
+   x.Randomize(1);
+
+   sc_twice.GetMatrix().Mult(x, y_twice);
+   sc_once.GetMatrix().Mult(x, y_once);
+   y_twice -= y_once;
+   REQUIRE(y_twice.Normlinf() == Approx(0.0));
+
+   sc_twice.GetMatrixElim().Mult(x, y_twice);
+   sc_once.GetMatrixElim().Mult(x, y_once);
+   REQUIRE(y_once.Normlinf() > 0.0);
+   y_twice -= y_once;
+   REQUIRE(y_twice.Normlinf() == Approx(0.0));
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+static int PCGIterations(const SparseMatrix &A, Solver &prec, const Vector &b)
+{
+   Vector x(b.Size());
+   x = 0.0;
+   CGSolver cg;
+   cg.SetRelTol(1e-10);
+   cg.SetMaxIter(1000);
+   cg.SetPrintLevel(-1);
+   cg.SetOperator(A);
+   cg.SetPreconditioner(prec);
+   cg.Mult(b, x);
+   REQUIRE(cg.GetConverged());
+   return cg.GetNumIterations();
+}
+
+TEST_CASE("SmoothedAggregationAMG", "[SmoothedAggregationAMG]")
+{
+   Mesh mesh(32, 32, Element::QUADRILATERAL, true);
+   H1_FECollection fec(2, 2);
+   ConstantCoefficient one(1.0);
+
+   SECTION("Poisson")
+   {
+      FiniteElementSpace fes(&mesh, &fec);
+      Array<int> ess_tdofs, ess_bdr(mesh.bdr_attributes.Max());
+      ess_bdr = 1;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.Assemble();
+      GridFunction x(&fes);
+      x = 0.0;
+      LinearForm b(&fes);
+      b.AddDomainIntegrator(new DomainLFIntegrator(one));
+      b.Assemble();
+      SparseMatrix A;
+      Vector B, X;
+      a.FormLinearSystem(ess_tdofs, x, b, A, X, B);
+
+      SmoothedAggregationAMG amg(A);
+      REQUIRE(amg.GetNumLevels() > 2);
+      REQUIRE(amg.GetOperatorComplexity() < 2.0);
+      const int amg_its = PCGIterations(A, amg, B);
+
+      amg.SetSmoother(SmoothedAggregationAMG::MULTICOLOR_GS);
+      amg.SetOperator(A);
+      const int mc_its = PCGIterations(A, amg, B);
+
+      GSSmoother gs(A);
+      const int gs_its = PCGIterations(A, gs, B);
+
+      REQUIRE(amg_its < 30);
+      REQUIRE(mc_its < 30);
+      REQUIRE(3*amg_its < gs_its);
+
+      // With a single level, the coarsest matrix is larger than the coarse
+      // size, so it is factored with the sparse coarse solver.
+      amg.SetMaxLevels(1);
+      amg.SetOperator(A);
+      REQUIRE(amg.GetNumLevels() == 1);
+      REQUIRE(PCGIterations(A, amg, B) <= 2);
+   }
+
+   SECTION("Elasticity")
+   {
+      FiniteElementSpace fes(&mesh, &fec, 2);
+      Array<int> ess_tdofs, ess_bdr(mesh.bdr_attributes.Max());
+      ess_bdr = 0;
+      ess_bdr[3] = 1;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new ElasticityIntegrator(one, one));
+      a.Assemble();
+      GridFunction x(&fes);
+      x = 0.0;
+      Vector f(2);
+      f(0) = 0.0;
+      f(1) = -1.0;
+      VectorConstantCoefficient force(f);
+      LinearForm b(&fes);
+      b.AddDomainIntegrator(new VectorDomainLFIntegrator(force));
+      b.Assemble();
+      SparseMatrix A;
+      Vector B, X;
+      a.FormLinearSystem(ess_tdofs, x, b, A, X, B);
+
+      // Scalar AMG (no systems options) versus the rigid body modes
+      SmoothedAggregationAMG scalar_amg(A);
+      const int scalar_its = PCGIterations(A, scalar_amg, B);
+
+      SmoothedAggregationAMG amg;
+      amg.SetElasticityOptions(&fes);
+      amg.SetOperator(A);
+      const int rbm_its = PCGIterations(A, amg, B);
+
+      REQUIRE(rbm_its < scalar_its);
+   }
+}
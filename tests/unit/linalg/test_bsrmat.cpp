@@ -0,0 +1,95 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+TEST_CASE("BlockSparseMatrix", "[BlockSparseMatrix]")
+{
+   for (int ordering = Ordering::byNODES; ordering <= Ordering::byVDIM;
+        ordering++)
+   {
+      Mesh mesh(3, 2, 2, Element::HEXAHEDRON, true);
+      const int dim = mesh.Dimension();
+      H1_FECollection fec(2, dim);
+      FiniteElementSpace fes(&mesh, &fec, dim, ordering);
+
+      ConstantCoefficient lambda(1.0), mu(1.0);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new ElasticityIntegrator(lambda, mu));
+      a.AddBoundaryIntegrator(new VectorMassIntegrator);
+      a.Assemble();
+      a.Finalize();
+      const SparseMatrix &A = a.SpMat();
+
+      BlockSparseMatrix *B = a.AssembleBlockSparse();
+      BlockSparseMatrix C(A, dim, ordering == Ordering::byNODES);
+      REQUIRE(B->GetBlockSize() == dim);
+      REQUIRE(B->NumBlockRows() == fes.GetNDofs());
+      REQUIRE(B->NumBlocks() == C.NumBlocks());
+
+      Vector x(A.Width()), y(A.Height()), yb(A.Height()), yc(A.Height());
+      x.Randomize(1);
+
+      SECTION("Mult")
+      {
+         A.Mult(x, y);
+         B->Mult(x, yb);
+         C.Mult(x, yc);
+         yb -= y;
+         yc -= y;
+         REQUIRE(yb.Normlinf() < 1e-12 * y.Normlinf());
+         REQUIRE(yc.Normlinf() < 1e-12 * y.Normlinf());
+      }
+
+      SECTION("MultTranspose")
+      {
+         A.MultTranspose(x, y);
+         B->MultTranspose(x, yb);
+         yb -= y;
+         REQUIRE(yb.Normlinf() < 1e-12 * y.Normlinf());
+      }
+
+      SECTION("ToSparseMatrix")
+      {
+         SparseMatrix *S = B->ToSparseMatrix();
+         SparseMatrix *D = Add(1.0, A, -1.0, *S);
+         REQUIRE(D->MaxNorm() < 1e-12 * A.MaxNorm());
+         delete D;
+         delete S;
+      }
+
+      SECTION("BlockGSSmoother")
+      {
+         Array<int> ess_tdof_list, ess_bdr(mesh.bdr_attributes.Max());
+         ess_bdr = 0;
+         ess_bdr[0] = 1;
+         fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+         Vector b(A.Height()), sol(A.Height());
+         b.Randomize(2);
+         sol = 0.0;
+         B->EliminateRowsCols(ess_tdof_list, sol, b);
+
+         // Symmetric block Gauss-Seidel as a stationary iteration
+         BlockGSSmoother gs(*B, 0, 100);
+         gs.iterative_mode = true;
+         gs.Mult(b, sol);
+         Vector r(b.Size());
+         B->Mult(sol, r);
+         subtract(b, r, r);
+         REQUIRE(r.Norml2() < 1e-2 * b.Norml2());
+      }
+
+      delete B;
+   }
+}
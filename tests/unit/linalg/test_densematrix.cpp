@@ -155,3 +155,61 @@ TEST_CASE("DenseMatrix A*B^T methods",
    }
 }
 
+
+TEST_CASE("Batched dense linear algebra", "[DenseTensor]")
+{
+   const int nk = 5;
+   // Sizes with (4, 9) and without (5, 11) a specialized kernel
+   const int sizes[4] = { 4, 5, 9, 11 };
+   for (int s = 0; s < 4; s++)
+   {
+      const int n = sizes[s];
+      // Random SPD matrices A(k) and nonsymmetric matrices B(k)
+      DenseTensor A(n, n, nk), B(n, n, nk), C;
+      for (int k = 0; k < nk; k++)
+      {
+         DenseMatrix R(n);
+         Vector(R.Data(), n*n).Randomize(k);
+         MultAAt(R, A(k));
+         for (int i = 0; i < n; i++) { A(i,i,k) += 1.0; }
+         Vector(B.GetData(k), n*n).Randomize(nk + k);
+         for (int i = 0; i < n; i++) { B(i,i,k) += n; }
+      }
+
+      BatchMult(A, B, C);
+      DenseTensor LU(B), L(A), Binv(B);
+      Array<int> P;
+      BatchLUFactor(LU, P);
+      BatchCholeskyFactor(L);
+      BatchInverse(Binv);
+
+      Vector b(n*nk), x(n*nk), y(n*nk);
+      b.Randomize(1);
+      x = b;
+      y = b;
+      BatchLUSolve(LU, P, x);
+      BatchCholeskySolve(L, y);
+
+      for (int k = 0; k < nk; k++)
+      {
+         DenseMatrix D(n);
+         Mult(A(k), B(k), D);
+         D -= C(k);
+         REQUIRE(D.MaxMaxNorm() < 1e-12 * C(k).MaxMaxNorm());
+
+         Mult(B(k), Binv(k), D);
+         for (int i = 0; i < n; i++) { D(i,i) -= 1.0; }
+         REQUIRE(D.MaxMaxNorm() < 1e-12);
+
+         // Residuals of the solves
+         Vector bk(b.GetData() + k*n, n), xk(x.GetData() + k*n, n);
+         Vector yk(y.GetData() + k*n, n), r(n);
+         B(k).Mult(xk, r);
+         r -= bk;
+         REQUIRE(r.Normlinf() < 1e-12);
+         A(k).Mult(yk, r);
+         r -= bk;
+         REQUIRE(r.Normlinf() < 1e-12);
+      }
+   }
+}
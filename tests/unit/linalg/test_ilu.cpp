@@ -0,0 +1,145 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+static void velocity(const Vector &x, Vector &v)
+{
+   v(0) = 1.0;
+   v(1) = 0.5;
+}
+
+static int GMRESIterations(const SparseMatrix &A, Solver &M, const Vector &b)
+{
+   GMRESSolver gmres;
+   gmres.SetOperator(A);
+   gmres.SetPreconditioner(M);
+   gmres.SetRelTol(1e-10);
+   gmres.SetMaxIter(1000);
+   gmres.SetKDim(50);
+   gmres.SetPrintLevel(-1);
+   Vector x(b.Size());
+   x = 0.0;
+   gmres.Mult(b, x);
+   REQUIRE(gmres.GetConverged());
+   return gmres.GetNumIterations();
+}
+
+TEST_CASE("Incomplete factorizations", "[ILU]")
+{
+   SECTION("Exact for a tridiagonal matrix")
+   {
+      Mesh mesh(50, 1.0);
+      H1_FECollection fec(1, 1);
+      FiniteElementSpace fes(&mesh, &fec);
+      ConstantCoefficient one(1.0);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.AddDomainIntegrator(new MassIntegrator(one));
+      a.Assemble();
+      a.Finalize();
+      SparseMatrix &A = a.SpMat();
+
+      ILU0Solver ilu0(A);
+      IC0Solver ic0(A);
+      ILUTSolver ilut(A, 0.0);
+      Solver *solvers[3] = { &ilu0, &ic0, &ilut };
+      Vector x(A.Height()), b(A.Height()), y(A.Height());
+      x.Randomize(1);
+      for (int s = 0; s < 3; s++)
+      {
+         for (int pass = 0; pass < 2; pass++)
+         {
+            // The second pass reuses the pattern with new values
+            if (pass == 1) { A *= 2.0; solvers[s]->SetOperator(A); }
+            A.Mult(x, b);
+            solvers[s]->Mult(b, y);
+            y -= x;
+            REQUIRE(y.Normlinf() < 1e-10 * x.Normlinf());
+         }
+         A *= 0.5;
+      }
+      REQUIRE(ilu0.GetNumLevels() == A.Height());
+   }
+
+   SECTION("Convection-diffusion")
+   {
+      Mesh mesh(16, 16, Element::QUADRILATERAL, true);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+
+      Array<int> ess_tdof_list, ess_bdr(mesh.bdr_attributes.Max());
+      ess_bdr = 1;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+      ConstantCoefficient eps(1e-2), one(1.0);
+      VectorFunctionCoefficient vel(2, velocity);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(eps));
+      a.AddDomainIntegrator(new ConvectionIntegrator(vel));
+      a.Assemble();
+      LinearForm b(&fes);
+      b.AddDomainIntegrator(new DomainLFIntegrator(one));
+      b.Assemble();
+      GridFunction x(&fes);
+      x = 0.0;
+      SparseMatrix A;
+      Vector B, X;
+      a.FormLinearSystem(ess_tdof_list, x, b, A, X, B);
+
+      GSSmoother gs(A);
+      ILU0Solver ilu0(A);
+      ILUTSolver ilut(A, 1e-4, 40);
+      const int it_gs = GMRESIterations(A, gs, B);
+      const int it_ilu0 = GMRESIterations(A, ilu0, B);
+      const int it_ilut = GMRESIterations(A, ilut, B);
+      REQUIRE(it_ilu0 < it_gs);
+      REQUIRE(it_ilut < it_ilu0);
+      REQUIRE(ilut.NumNonZeroElems() > A.NumNonZeroElems());
+   }
+
+   SECTION("IC(0) preconditioned CG")
+   {
+      Mesh mesh(16, 16, Element::QUADRILATERAL, true);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      ConstantCoefficient one(1.0);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.AddDomainIntegrator(new MassIntegrator(one));
+      a.Assemble();
+      a.Finalize();
+      SparseMatrix &A = a.SpMat();
+
+      Vector b(A.Height()), x(A.Height());
+      b.Randomize(1);
+      IC0Solver ic0(A);
+      GSSmoother gs(A);
+      int its[2];
+      for (int s = 0; s < 2; s++)
+      {
+         CGSolver cg;
+         cg.SetOperator(A);
+         cg.SetPreconditioner((s == 0) ? (Solver&)ic0 : (Solver&)gs);
+         cg.SetRelTol(1e-10);
+         cg.SetMaxIter(500);
+         cg.SetPrintLevel(-1);
+         x = 0.0;
+         cg.Mult(b, x);
+         REQUIRE(cg.GetConverged());
+         its[s] = cg.GetNumIterations();
+      }
+      REQUIRE(its[0] <= its[1]);
+   }
+}
@@ -0,0 +1,421 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+TEST_CASE("PipelinedCGSolver", "[PipelinedCGSolver]")
+{
+   Mesh mesh(16, 16, Element::QUADRILATERAL, true);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_tdofs, ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.Assemble();
+   LinearForm b(&fes);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+   GridFunction x0(&fes);
+   x0 = 0.0;
+   SparseMatrix A;
+   Vector B, X;
+   a.FormLinearSystem(ess_tdofs, x0, b, A, X, B);
+   const int n = A.Height();
+
+   for (int use_prec = 0; use_prec < 2; use_prec++)
+   {
+      GSSmoother prec(A);
+
+      CGSolver cg;
+      PipelinedCGSolver pcg;
+      IterativeSolver *solvers[2] = { &cg, &pcg };
+      Vector x[2];
+      for (int k = 0; k < 2; k++)
+      {
+         solvers[k]->SetRelTol(1e-10);
+         solvers[k]->SetMaxIter(500);
+         solvers[k]->SetPrintLevel(-1);
+         if (use_prec) { solvers[k]->SetPreconditioner(prec); }
+         solvers[k]->SetOperator(A);
+         x[k].SetSize(n);
+         x[k] = 0.0;
+         solvers[k]->Mult(B, x[k]);
+         REQUIRE(solvers[k]->GetConverged());
+      }
+
+      // Same iterates in exact arithmetic
+      REQUIRE(std::abs(pcg.GetNumIterations() - cg.GetNumIterations()) <= 1);
+      x[1] -= x[0];
+      REQUIRE(x[1].Normlinf() < 1e-7 * x[0].Normlinf());
+
+      // Check the true residual
+      Vector r(n);
+      A.Mult(x[0], r);
+      r -= B;
+      REQUIRE(r.Norml2() < 1e-8 * B.Norml2());
+   }
+}
+
+TEST_CASE("GMRES orthogonalization", "[GMRESSolver]")
+{
+   // Convection-diffusion gives a nonsymmetric system
+   Mesh mesh(16, 16, Element::QUADRILATERAL, true);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_tdofs, ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+
+   ConstantCoefficient one(1.0);
+   Vector velocity(2);
+   velocity(0) = 40.0;
+   velocity(1) = 20.0;
+   VectorConstantCoefficient vel(velocity);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.AddDomainIntegrator(new ConvectionIntegrator(vel));
+   a.Assemble();
+   LinearForm b(&fes);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+   GridFunction x0(&fes);
+   x0 = 0.0;
+   SparseMatrix A;
+   Vector B, X;
+   a.FormLinearSystem(ess_tdofs, x0, b, A, X, B);
+   const int n = A.Height();
+
+   DSmoother prec(A);
+   for (int flexible = 0; flexible < 2; flexible++)
+   {
+      int its[2];
+      Vector x[2];
+      for (int t = 0; t < 2; t++)
+      {
+         GMRESSolver gmres;
+         FGMRESSolver fgmres;
+         IterativeSolver &solver = flexible ? (IterativeSolver &)fgmres :
+                                   (IterativeSolver &)gmres;
+         const GramSchmidt::Type type =
+            t ? GramSchmidt::CLASSICAL_REORTH : GramSchmidt::MODIFIED;
+         gmres.SetKDim(30);
+         fgmres.SetKDim(30);
+         gmres.SetOrthogonalization(type);
+         fgmres.SetOrthogonalization(type);
+         solver.SetRelTol(1e-10);
+         solver.SetMaxIter(1000);
+         solver.SetPrintLevel(-1);
+         solver.SetPreconditioner(prec);
+         solver.SetOperator(A);
+         x[t].SetSize(n);
+         x[t] = 0.0;
+         solver.Mult(B, x[t]);
+         REQUIRE(solver.GetConverged());
+         its[t] = solver.GetNumIterations();
+      }
+      REQUIRE(std::abs(its[0] - its[1]) <= 1);
+      x[1] -= x[0];
+      REQUIRE(x[1].Normlinf() < 1e-6 * x[0].Normlinf());
+   }
+}
+
+TEST_CASE("BlockCGSolver", "[BlockCGSolver]")
+{
+   Mesh mesh(16, 16, Element::QUADRILATERAL, true);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_tdofs, ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.Assemble();
+   a.EliminateEssentialBC(ess_bdr);
+   a.Finalize();
+   SparseMatrix &A = a.SpMat();
+   const int n = A.Height(), nv = 7;
+
+   // Random right-hand sides, including a zero and a repeated one
+   MultiVector B(n, nv), X(n, nv), Y(n, nv);
+   B.Randomize(1);
+   Vector bj, bk;
+   B.GetVectorView(3, bj);
+   bj = 0.0;
+   B.GetVectorView(5, bj);
+   B.GetVectorView(1, bk);
+   bj = bk;
+
+   // Sparse matrix times multivector
+   A.BatchMult(B, Y);
+   Vector y;
+   for (int j = 0; j < nv; j++)
+   {
+      B.GetVectorView(j, bj);
+      Y.GetVectorView(j, y);
+      Vector Ab(n);
+      A.Mult(bj, Ab);
+      Ab -= y;
+      REQUIRE(Ab.Normlinf() < 1e-12 * y.Normlinf() + 1e-15);
+   }
+
+   for (int use_prec = 0; use_prec < 2; use_prec++)
+   {
+      GSSmoother prec(A);
+      BlockCGSolver bcg;
+      bcg.SetRelTol(1e-10);
+      bcg.SetMaxIter(500);
+      bcg.SetPrintLevel(-1);
+      if (use_prec) { bcg.SetPreconditioner(prec); }
+      bcg.SetOperator(A);
+      X = 0.0;
+      bcg.BatchMult(B, X);
+      REQUIRE(bcg.GetConverged());
+
+      CGSolver cg;
+      cg.SetRelTol(1e-10);
+      cg.SetMaxIter(500);
+      cg.SetPrintLevel(-1);
+      if (use_prec) { cg.SetPreconditioner(prec); }
+      cg.SetOperator(A);
+      Vector x(n), xj;
+      int max_its = 0;
+      for (int j = 0; j < nv; j++)
+      {
+         B.GetVectorView(j, bj);
+         X.GetVectorView(j, xj);
+         x = 0.0;
+         cg.Mult(bj, x);
+         REQUIRE(cg.GetConverged());
+         max_its = std::max(max_its, cg.GetNumIterations());
+         x -= xj;
+         REQUIRE(x.Normlinf() < 1e-7 * (xj.Normlinf() + 1.0));
+      }
+      // The shared Krylov space reduces the number of iterations
+      REQUIRE(bcg.GetNumIterations() < max_its);
+   }
+}
+
+TEST_CASE("Recycling Krylov solvers",
+          "[RecyclingCGSolver][RecyclingGMRESSolver]")
+{
+   Mesh mesh(16, 16, Element::QUADRILATERAL, true);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_tdofs, ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+   Vector velocity(2);
+   velocity(0) = 20.0;
+   velocity(1) = 10.0;
+   VectorConstantCoefficient vel(velocity);
+
+   for (int nonsym = 0; nonsym < 2; nonsym++)
+   {
+      // Reference solvers without recycling and the recycling solvers
+      CGSolver cg;
+      RecyclingCGSolver rcg;
+      RecyclingGMRESSolver gmres, rgmres;
+      gmres.SetRecycleDim(0);
+      IterativeSolver *solvers[2];
+      solvers[0] = nonsym ? (IterativeSolver *)&gmres : (IterativeSolver *)&cg;
+      solvers[1] = nonsym ? (IterativeSolver *)&rgmres :
+                   (IterativeSolver *)&rcg;
+
+      // A sequence of slowly changing systems
+      int its[2] = { 0, 0 };
+      for (int step = 0; step < 4; step++)
+      {
+         ConstantCoefficient kappa(1.0 + 0.05*step);
+         BilinearForm a(&fes);
+         a.AddDomainIntegrator(new DiffusionIntegrator(kappa));
+         if (nonsym) { a.AddDomainIntegrator(new ConvectionIntegrator(vel)); }
+         a.Assemble();
+         GridFunction x0(&fes);
+         x0 = 0.0;
+         LinearForm b(&fes);
+         b.AddDomainIntegrator(new DomainLFIntegrator(kappa));
+         b.Assemble();
+         SparseMatrix A;
+         Vector B, X;
+         a.FormLinearSystem(ess_tdofs, x0, b, A, X, B);
+         GSSmoother prec(A);
+
+         for (int t = 0; t < 2; t++)
+         {
+            solvers[t]->SetRelTol(1e-10);
+            solvers[t]->SetMaxIter(1000);
+            solvers[t]->SetPrintLevel(-1);
+            solvers[t]->SetPreconditioner(prec);
+            solvers[t]->SetOperator(A);
+            X = 0.0;
+            solvers[t]->Mult(B, X);
+            REQUIRE(solvers[t]->GetConverged());
+            its[t] = solvers[t]->GetNumIterations();
+
+            Vector r(B.Size());
+            A.Mult(X, r);
+            r -= B;
+            REQUIRE(r.Norml2() < 1e-6 * B.Norml2());
+         }
+      }
+      // The recycled space reduces the iterations of the last solve
+      REQUIRE(5*its[1] < 4*its[0]);
+
+      if (nonsym)
+      {
+         REQUIRE(rgmres.GetRecycledDim() > 0);
+         rgmres.ResetRecycledSpace();
+         REQUIRE(rgmres.GetRecycledDim() == 0);
+      }
+      else
+      {
+         REQUIRE(rcg.GetRecycledDim() > 0);
+         rcg.ResetRecycledSpace();
+         REQUIRE(rcg.GetRecycledDim() == 0);
+      }
+   }
+}
+
+static double SinSin(const Vector &x)
+{
+   return sin(M_PI*x(0)) * sin(M_PI*x(1));
+}
+
+TEST_CASE("InitialGuessExtrapolator", "[InitialGuessExtrapolator]")
+{
+   // Backward Euler for the heat equation: (M + dt K) u_{n+1} = M u_n + dt f
+   Mesh mesh(16, 16, Element::QUADRILATERAL, true);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_tdofs, ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+
+   const double dt = 0.01;
+   ConstantCoefficient one(1.0), dt_coeff(dt);
+   BilinearForm m(&fes), a(&fes);
+   m.AddDomainIntegrator(new MassIntegrator(one));
+   m.Assemble();
+   m.Finalize();
+   a.AddDomainIntegrator(new MassIntegrator(one));
+   a.AddDomainIntegrator(new DiffusionIntegrator(dt_coeff));
+   a.Assemble();
+   a.EliminateEssentialBC(ess_bdr);
+   a.Finalize();
+   SparseMatrix &A = a.SpMat();
+   LinearForm f(&fes);
+   f.AddDomainIntegrator(new DomainLFIntegrator(one));
+   f.Assemble();
+   const int n = A.Height();
+
+   GSSmoother prec(A);
+   CGSolver cg;
+   cg.SetRelTol(0.0);
+   cg.SetAbsTol(1e-12);
+   cg.SetMaxIter(1000);
+   cg.SetPrintLevel(-1);
+   cg.SetPreconditioner(prec);
+   cg.SetOperator(A);
+   cg.iterative_mode = false; // set temporarily by InitialGuessExtrapolator
+
+   InitialGuessExtrapolator poly, proj(InitialGuessExtrapolator::PROJECTION);
+   proj.SetOperator(A);
+   InitialGuessExtrapolator *ext[2] = { &poly, &proj };
+
+   GridFunction u0(&fes);
+   FunctionCoefficient u0_coeff(SinSin);
+   u0.ProjectCoefficient(u0_coeff);
+   Vector u[2] = { u0, u0 };
+   Vector b(n), x(n), r(n);
+   for (int step = 0; step < 8; step++)
+   {
+      double res[3];
+      for (int k = 0; k < 2; k++)
+      {
+         m.Mult(u[k], b);
+         b.Add(dt * (1.0 + 0.1*step), f);
+         for (int i = 0; i < ess_tdofs.Size(); i++) { b(ess_tdofs[i]) = 0.0; }
+
+         // Residual of the previous solution and of the extrapolation
+         A.Mult(u[k], r);
+         r -= b;
+         res[2] = r.Norml2() / b.Norml2();
+         ext[k]->GetInitialGuess(b, x);
+         A.Mult(x, r);
+         r -= b;
+         res[k] = r.Norml2() / b.Norml2();
+
+         ext[k]->Mult(cg, b, u[k]);
+         REQUIRE(cg.GetConverged());
+         REQUIRE(!cg.iterative_mode);
+      }
+      if (step >= 3)
+      {
+         REQUIRE(res[0] < 0.5 * res[2]);
+         REQUIRE(res[1] < 0.1 * res[0]);
+      }
+   }
+   REQUIRE(poly.GetHistoryLength() == 3);
+   u[1] -= u[0];
+   REQUIRE(u[1].Normlinf() < 1e-8 * u[0].Normlinf());
+}
+
+TEST_CASE("Fused vector kernels", "[Vector]")
+{
+   const int n = 1000;
+   Vector x(n), y(n), z(n), w(n), z0(n), ref(n);
+   x.Randomize(1);
+   y.Randomize(2);
+   z0.Randomize(3);
+   w.Randomize(4);
+
+   // z = a x + b y + c z, with and without the old z
+   for (int c = 0; c < 2; c++)
+   {
+      z = z0;
+      add(2.0, x, -3.0, y, ref);
+      ref.Add(0.5*c, z0);
+      const double d = AddAndDot(2.0, x, -3.0, y, 0.5*c, z, &w);
+      ref -= z;
+      REQUIRE(ref.Normlinf() < 1e-14);
+      REQUIRE(std::abs(d - z*w) < 1e-12 * std::abs(d));
+   }
+
+   // x += a p, r += b q, with the norm of r
+   Vector r(z0), xr(x);
+   const double d = AddTwoAndDot(2.0, y, xr, -1.5, w, r, &r);
+   ref = x;
+   ref.Add(2.0, y);
+   ref -= xr;
+   REQUIRE(ref.Normlinf() < 1e-14);
+   ref = z0;
+   ref.Add(-1.5, w);
+   ref -= r;
+   REQUIRE(ref.Normlinf() < 1e-14);
+   REQUIRE(std::abs(d - r*r) < 1e-12 * d);
+
+   const Vector *v[3] = { &x, &y, &z0 };
+   double dots[3];
+   MultiDot(3, v, w, dots);
+   for (int j = 0; j < 3; j++)
+   {
+      REQUIRE(std::abs(dots[j] - (*v[j])*w) < 1e-12 * std::abs(dots[j]));
+   }
+}
@@ -0,0 +1,251 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+#include <cmath>
+
+using namespace mfem;
+
+// Linear system dy/dt = L y + g(t), with g chosen such that the exact solution
+// is y(t) = (1 + sin(t), cos(2t)).
+class ManufacturedODE : public TimeDependentOperator
+{
+public:
+   ManufacturedODE() : TimeDependentOperator(2, 0.0) { }
+
+   static void Exact(double t, Vector &y)
+   {
+      y.SetSize(2);
+      y(0) = 1.0 + sin(t);
+      y(1) = cos(2*t);
+   }
+
+   static void Apply(const Vector &y, Vector &Ly)
+   {
+      Ly(0) = -y(0) + 0.5*y(1);
+      Ly(1) = -0.5*y(0) - 2.0*y(1);
+   }
+
+   virtual void Mult(const Vector &y, Vector &dydt) const
+   {
+      const double t = GetTime();
+      Vector ye, Lye(2);
+      Exact(t, ye);
+      Apply(ye, Lye);
+      Apply(y, dydt);
+      dydt(0) += cos(t) - Lye(0);
+      dydt(1) += -2*sin(2*t) - Lye(1);
+   }
+
+   // Solve k = f(y + dt k, t), i.e. (I - dt L) k = f(y, t).
+   virtual void ImplicitSolve(const double dt, const Vector &y, Vector &k)
+   {
+      Vector r(2);
+      Mult(y, r);
+      DenseMatrix M(2);
+      M(0,0) = 1.0 + dt;   M(0,1) = -0.5*dt;
+      M(1,0) = 0.5*dt;     M(1,1) = 1.0 + 2.0*dt;
+      DenseMatrixInverse(M).Mult(r, k);
+   }
+};
+
+// The same exact solution with dy/dt = f_E(y,t) + f_I(y,t), where the stiff
+// part f_I(y) = s L y is treated implicitly and the explicit part is
+// f_E(y,t) = R y + g(t), with a rotation R.
+class SplitODE : public IMEXTimeDependentOperator
+{
+protected:
+   static const double s;
+
+public:
+   SplitODE() : IMEXTimeDependentOperator(2, 0.0) { }
+
+   virtual void ExplicitMult(const Vector &y, Vector &dydt) const
+   {
+      const double t = GetTime();
+      Vector ye, Lye(2);
+      ManufacturedODE::Exact(t, ye);
+      ManufacturedODE::Apply(ye, Lye);
+      dydt(0) = 0.3*(y(1) - ye(1)) + cos(t) - s*Lye(0);
+      dydt(1) = -0.3*(y(0) - ye(0)) - 2*sin(2*t) - s*Lye(1);
+   }
+
+   virtual void ImplicitPartMult(const Vector &y, Vector &dydt) const
+   {
+      ManufacturedODE::Apply(y, dydt);
+      dydt *= s;
+   }
+
+   // Solve k = s L (y + dt k), i.e. (I - dt s L) k = s L y.
+   virtual void ImplicitPartSolve(const double dt, const Vector &y, Vector &k)
+   {
+      Vector r(2);
+      ImplicitPartMult(y, r);
+      const double sdt = s*dt;
+      DenseMatrix M(2);
+      M(0,0) = 1.0 + sdt;   M(0,1) = -0.5*sdt;
+      M(1,0) = 0.5*sdt;     M(1,1) = 1.0 + 2.0*sdt;
+      DenseMatrixInverse(M).Mult(r, k);
+   }
+};
+
+const double SplitODE::s = 10.0;
+
+// SplitODE with a solve for the full operator, as used by the DIRK solvers.
+class FullySolvedSplitODE : public SplitODE
+{
+public:
+   // Solve k = f(y + dt k, t), i.e. (I - dt (R + s L)) k = f(y, t).
+   virtual void ImplicitSolve(const double dt, const Vector &y, Vector &k)
+   {
+      Vector r(2);
+      Mult(y, r);
+      const double sdt = s*dt;
+      DenseMatrix M(2);
+      M(0,0) = 1.0 + sdt;             M(0,1) = -0.5*sdt - 0.3*dt;
+      M(1,0) = 0.5*sdt + 0.3*dt;      M(1,1) = 1.0 + 2.0*sdt;
+      DenseMatrixInverse(M).Mult(r, k);
+   }
+};
+
+// Error at t = 1 with n uniform steps.
+template <class ODEOperator = ManufacturedODE>
+static double SolveError(ODESolver &ode, int n)
+{
+   ODEOperator f;
+   ode.Init(f);
+   Vector y, ye;
+   ManufacturedODE::Exact(0.0, y);
+   double t = 0.0, dt = 1.0/n;
+   for (int i = 0; i < n; i++) { ode.Step(y, t, dt); }
+   REQUIRE(fabs(t - 1.0) < 1e-12);
+   ManufacturedODE::Exact(t, ye);
+   y -= ye;
+   return y.Normlinf();
+}
+
+template <class ODEOperator = ManufacturedODE>
+static double ConvergenceOrder(ODESolver &ode, int n)
+{
+   return log(SolveError<ODEOperator>(ode, n) /
+              SolveError<ODEOperator>(ode, 2*n)) / log(2.0);
+}
+
+TEST_CASE("Low-storage Runge-Kutta", "[ODE]")
+{
+   LowStorageRK3Solver rk3;
+   REQUIRE(ConvergenceOrder(rk3, 20) > 2.8);
+
+   LowStorageRK4Solver rk4;
+   REQUIRE(ConvergenceOrder(rk4, 10) > 3.8);
+
+   LowStorageSSPRKSolver ssp22(2, 2), ssp25(2, 5);
+   REQUIRE(ConvergenceOrder(ssp22, 20) > 1.8);
+   REQUIRE(ConvergenceOrder(ssp25, 20) > 1.8);
+
+   LowStorageSSPRKSolver ssp34(3, 4), ssp39(3, 9);
+   REQUIRE(ssp34.GetSSPCoefficient() == 2.0);
+   REQUIRE(ConvergenceOrder(ssp34, 20) > 2.8);
+   REQUIRE(ConvergenceOrder(ssp39, 20) > 2.8);
+
+   LowStorageSSPRKSolver ssp410(4, 10);
+   REQUIRE(ConvergenceOrder(ssp410, 10) > 3.8);
+}
+
+// Error at t = 1 of the adaptive solver with the given tolerance.
+static double AdaptiveError(AdaptiveODESolver &ode, double tol, int &steps)
+{
+   ManufacturedODE f;
+   ode.Init(f);
+   ode.SetTolerances(tol, tol);
+   Vector y, ye;
+   ManufacturedODE::Exact(0.0, y);
+   double t = 0.0, dt = 0.5;
+   ode.Run(y, t, dt, 1.0);
+   REQUIRE(t == 1.0);
+   steps = ode.GetNumAcceptedSteps();
+   ManufacturedODE::Exact(t, ye);
+   y -= ye;
+   return y.Normlinf();
+}
+
+TEST_CASE("Adaptive time stepping", "[ODE]")
+{
+   BogackiShampineSolver bs;
+   DormandPrinceSolver dp;
+   FehlbergSolver rkf;
+   AdaptiveSDIRK4Solver sdirk;
+   AdaptiveODESolver *solvers[4] = { &bs, &dp, &rkf, &sdirk };
+   for (int i = 0; i < 4; i++)
+   {
+      int steps1, steps2;
+      const double err1 = AdaptiveError(*solvers[i], 1e-5, steps1);
+      const double err2 = AdaptiveError(*solvers[i], 1e-8, steps2);
+      REQUIRE(err1 < 1e-3);
+      REQUIRE(err2 < 1e-6);
+      REQUIRE(err2 < err1);
+      REQUIRE(steps2 > steps1);
+   }
+
+   SECTION("Step size controllers")
+   {
+      ManufacturedODE f;
+      Vector y;
+      PIDController pid;
+      PIDController icontrol(1.0, 0.0, 0.0);
+      ODEController *controllers[2] = { &pid, &icontrol };
+      for (int i = 0; i < 2; i++)
+      {
+         dp.SetController(*controllers[i]);
+         dp.Init(f);
+         dp.SetTolerances(1e-6, 1e-6);
+         ManufacturedODE::Exact(0.0, y);
+         // A first step which is too large is rejected
+         double t = 0.0, dt = 1.0, dt_next;
+         dp.Step(y, t, dt, dt_next);
+         REQUIRE(dp.GetNumRejectedSteps() > 0);
+         REQUIRE(t == dt);
+         REQUIRE(dt < 1.0);
+         REQUIRE(dt_next > 0.0);
+         REQUIRE(dt_next == dp.GetNextTimeStep());
+      }
+   }
+}
+
+TEST_CASE("IMEX Runge-Kutta", "[ODE]")
+{
+   ARS111Solver ars111;
+   ARS222Solver ars222;
+   ARS443Solver ars443;
+   ARK324L2SASolver ark3;
+   ODESolver *solvers[4] = { &ars111, &ars222, &ars443, &ark3 };
+   const double order[4] = { 1.0, 2.0, 3.0, 3.0 };
+   for (int i = 0; i < 4; i++)
+   {
+      const double p = ConvergenceOrder<SplitODE>(*solvers[i], 80);
+      REQUIRE(p > order[i] - 0.2);
+      // The stiff part does not restrict the time step
+      REQUIRE(SolveError<SplitODE>(*solvers[i], 4) < 0.5);
+   }
+
+   SECTION("Non-IMEX implicit solvers")
+   {
+      // The DIRK solvers use ImplicitSolve() with the full operator, not the
+      // solve for the stiff part only.
+      SDIRK33Solver sdirk;
+      REQUIRE(ConvergenceOrder<FullySolvedSplitODE>(sdirk, 80) > 2.8);
+#ifdef MFEM_USE_EXCEPTIONS
+      REQUIRE_THROWS_AS(SolveError<SplitODE>(sdirk, 4), ErrorException);
+#endif
+   }
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+static double SolveError(const SparseMatrix &A, const Solver &S)
+{
+   Vector x(A.Height()), b(A.Height()), y(A.Height());
+   x.Randomize(1);
+   A.Mult(x, b);
+   S.Mult(b, y);
+   y -= x;
+   return y.Normlinf() / x.Normlinf();
+}
+
+TEST_CASE("Sparse Cholesky solver", "[SparseCholeskySolver]")
+{
+   const double tol = 1e-10;
+
+   SECTION("Nested dissection ordering")
+   {
+      Mesh mesh(20, 20, Element::QUADRILATERAL);
+      H1_FECollection fec(1, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator);
+      a.Assemble();
+      a.Finalize();
+      Array<int> perm, count(fes.GetVSize());
+      NestedDissectionOrdering(a.SpMat(), perm);
+      REQUIRE(perm.Size() == fes.GetVSize());
+      count = 0;
+      for (int i = 0; i < perm.Size(); i++) { count[perm[i]]++; }
+      REQUIRE(count.Min() == 1);
+      REQUIRE(count.Max() == 1);
+   }
+
+   SECTION("Definite matrices")
+   {
+      Mesh mesh(4, 4, 4, Element::HEXAHEDRON);
+      H1_FECollection fec(2, 3);
+      FiniteElementSpace fes(&mesh, &fec);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator);
+      a.AddDomainIntegrator(new MassIntegrator);
+      a.Assemble();
+      a.Finalize();
+      SparseMatrix &A = a.SpMat();
+
+      SparseCholeskySolver chol(A);
+      REQUIRE(SolveError(A, chol) < tol);
+      REQUIRE(chol.NumSupernodes() < A.Height());
+
+      // Refactorization with the same pattern reuses the symbolic analysis
+      const int nnz = chol.NumNonZeroElems();
+      A *= 3.0;
+      chol.SetOperator(A);
+      REQUIRE(chol.NumNonZeroElems() == nnz);
+      REQUIRE(SolveError(A, chol) < tol);
+
+      A *= -1.0;
+      SparseCholeskySolver ldlt(A, SparseCholeskySolver::LDLT);
+      REQUIRE(SolveError(A, ldlt) < tol);
+
+      // Natural ordering
+      Array<int> natural(A.Height());
+      for (int i = 0; i < A.Height(); i++) { natural[i] = i; }
+      ldlt.SetOrdering(natural);
+      ldlt.SetOperator(A);
+      REQUIRE(ldlt.NumNonZeroElems() > nnz);
+      REQUIRE(SolveError(A, ldlt) < tol);
+   }
+
+   SECTION("Quasi-definite saddle-point matrix")
+   {
+      // [ K  B^T ]
+      // [ B  -C  ]  with K, C symmetric positive definite: LDL^T exists for
+      // any ordering, with positive and negative pivots.
+      const int n1 = 200, n2 = 100, n = n1 + n2;
+      SparseMatrix A(n);
+      for (int i = 0; i < n1; i++)
+      {
+         A.Add(i, i, 2.5);
+         if (i+1 < n1)
+         {
+            A.Add(i, i+1, -1.0);
+            A.Add(i+1, i, -1.0);
+         }
+      }
+      for (int i = 0; i < n2; i++)
+      {
+         const int r = n1 + i;
+         A.Add(r, r, -0.1);
+         for (int k = 0; k < 2; k++)
+         {
+            const double b = k ? 0.5 : 1.0;
+            A.Add(r, 2*i+k, b);
+            A.Add(2*i+k, r, b);
+         }
+      }
+      A.Finalize();
+      SparseCholeskySolver ldlt(A, SparseCholeskySolver::LDLT);
+      REQUIRE(SolveError(A, ldlt) < tol);
+   }
+
+   SECTION("Disconnected graph")
+   {
+      // Two decoupled 1D Laplacians and a diagonal block
+      const int n = 300;
+      SparseMatrix A(n);
+      for (int i = 0; i < n; i++)
+      {
+         A.Add(i, i, 2.5);
+         if (i < 200 && i % 100 != 99)
+         {
+            A.Add(i, i+1, -1.0);
+            A.Add(i+1, i, -1.0);
+         }
+      }
+      A.Finalize();
+      SparseCholeskySolver chol(A);
+      REQUIRE(SolveError(A, chol) < tol);
+   }
+}
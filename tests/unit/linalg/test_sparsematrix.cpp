@@ -0,0 +1,397 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+static void RandomSparseMatrix(SparseMatrix &M, int max_nnz_row)
+{
+   for (int i = 0; i < M.Height(); i++)
+   {
+      const int nnz_row = rand()%max_nnz_row + 1;
+      for (int j = 0; j < nnz_row; j++)
+      {
+         M.Set(i, rand()%M.Width(), double(rand())/RAND_MAX - 0.5);
+      }
+   }
+   M.Finalize();
+}
+
+static double MaxDiff(const SparseMatrix &S, const DenseMatrix &D)
+{
+   DenseMatrix SD;
+   S.ToDenseMatrix(SD);
+   SD -= D;
+   return SD.MaxMaxNorm();
+}
+
+#ifdef MFEM_USE_OPENMP
+// Enable the host OpenMP backend, used by the threaded SparseMatrix kernels.
+// The Device can be configured only once per program.
+static void EnableOpenMPDevice()
+{
+   if (!Device::IsConfigured()) { Device::Configure("omp"); }
+   Device::Enable();
+   REQUIRE(Device::AllowsHostOpenMP());
+}
+
+// Check that S and T have the same CSR structure, and return the maximum
+// difference of their values.
+static double SameStructureMaxDiff(const SparseMatrix &S, const SparseMatrix &T)
+{
+   REQUIRE(S.Height() == T.Height());
+   REQUIRE(S.Width() == T.Width());
+   const int nnz = S.NumNonZeroElems();
+   REQUIRE(T.NumNonZeroElems() == nnz);
+   bool same_I = true, same_J = true;
+   for (int i = 0; i <= S.Height(); i++)
+   {
+      same_I = same_I && (S.GetI()[i] == T.GetI()[i]);
+   }
+   double diff = 0.0;
+   for (int k = 0; k < nnz; k++)
+   {
+      same_J = same_J && (S.GetJ()[k] == T.GetJ()[k]);
+      diff = std::max(diff, fabs(S.GetData()[k] - T.GetData()[k]));
+   }
+   REQUIRE(same_I);
+   REQUIRE(same_J);
+   return diff;
+}
+#endif
+
+TEST_CASE("Sparse matrix-vector products", "[SparseMatrix]")
+{
+   srand(2);
+   // Rows of very different lengths, as in DG or constrained matrices
+   SparseMatrix A(500, 400);
+   for (int i = 0; i < A.Height(); i++)
+   {
+      const int nnz_row = (i % 50 == 0) ? 300 : rand()%6 + 1;
+      for (int j = 0; j < nnz_row; j++)
+      {
+         A.Set(i, rand()%A.Width(), double(rand())/RAND_MAX - 0.5);
+      }
+   }
+   A.Finalize();
+   Vector x(A.Width()), xt(A.Height());
+   x.Randomize(1);
+   xt.Randomize(2);
+
+   Vector y(A.Height()), yt(A.Width()), yd(A.Height()), ytd(A.Width());
+   A.Mult(x, y);
+   A.MultTranspose(xt, yt);
+   DenseMatrix Ad;
+   A.ToDenseMatrix(Ad);
+   Ad.Mult(x, yd);
+   Ad.MultTranspose(xt, ytd);
+   yd -= y;
+   ytd -= yt;
+   REQUIRE(yd.Normlinf() < 1e-12*y.Normlinf());
+   REQUIRE(ytd.Normlinf() < 1e-12*yt.Normlinf());
+
+#ifdef MFEM_USE_OPENMP
+   SECTION("Threaded kernels")
+   {
+      Vector y_omp(A.Height()), yt_omp(A.Width());
+      EnableOpenMPDevice();
+      A.Mult(x, y_omp);
+      y_omp.Add(-1.0, y);
+      const double err = y_omp.Normlinf();
+      y_omp = 1.0;
+      A.AddMult(x, y_omp, 2.0);
+      y_omp.Add(-2.0, y);
+      y_omp -= 1.0;
+      const double add_err = y_omp.Normlinf();
+      A.MultTranspose(xt, yt_omp);
+      yt_omp.Add(-1.0, yt);
+      const double t_err = yt_omp.Normlinf();
+      yt_omp = 1.0;
+      A.AddMultTranspose(xt, yt_omp, 2.0);
+      yt_omp.Add(-2.0, yt);
+      yt_omp -= 1.0;
+      const double add_t_err = yt_omp.Normlinf();
+      Device::Disable();
+
+      REQUIRE(err < 1e-12*y.Normlinf());
+      REQUIRE(add_err < 1e-12*y.Normlinf());
+      REQUIRE(t_err < 1e-12*yt.Normlinf());
+      REQUIRE(add_t_err < 1e-12*yt.Normlinf());
+   }
+#endif
+}
+
+TEST_CASE("Sparse matrix products", "[SparseMatrix]")
+{
+   const double tol = 1e-12;
+   srand(1);
+   SparseMatrix A(200, 150), B(150, 120), P(150, 60);
+   RandomSparseMatrix(A, 8);
+   RandomSparseMatrix(B, 8);
+   RandomSparseMatrix(P, 3);
+   DenseMatrix Ad, Bd, Pd;
+   A.ToDenseMatrix(Ad);
+   B.ToDenseMatrix(Bd);
+   P.ToDenseMatrix(Pd);
+
+   SECTION("Transpose")
+   {
+      SparseMatrix *At = Transpose(A);
+      DenseMatrix Atd(150, 200);
+      for (int i = 0; i < 200; i++)
+      {
+         for (int j = 0; j < 150; j++) { Atd(j,i) = Ad(i,j); }
+      }
+      REQUIRE(MaxDiff(*At, Atd) == 0.0);
+      // The rows in each column of A are sorted
+      for (int i = 0; i < At->Height(); i++)
+      {
+         for (int k = At->GetI()[i]+1; k < At->GetI()[i+1]; k++)
+         {
+            REQUIRE(At->GetJ()[k-1] < At->GetJ()[k]);
+         }
+      }
+      delete At;
+   }
+
+   SECTION("Mult")
+   {
+      DenseMatrix ABd(200, 120);
+      Mult(Ad, Bd, ABd);
+      SparseMatrix *AB = Mult(A, B);
+      REQUIRE(MaxDiff(*AB, ABd) < tol);
+
+      // Reuse the sparsity pattern for new values
+      B *= 2.0;
+      ABd *= 2.0;
+      SparseMatrix *AB2 = Mult(A, B, AB);
+      REQUIRE(AB2 == AB);
+      REQUIRE(MaxDiff(*AB, ABd) < tol);
+      delete AB;
+   }
+
+   SECTION("RAP")
+   {
+      SparseMatrix S(150);
+      RandomSparseMatrix(S, 8);
+      DenseMatrix Sd, SPd(150, 60), PtSPd(60, 60);
+      S.ToDenseMatrix(Sd);
+      Mult(Sd, Pd, SPd);
+      MultAtB(Pd, SPd, PtSPd);
+
+      SparseMatrix *PtSP = RAP(P, S, P);
+      REQUIRE(MaxDiff(*PtSP, PtSPd) < tol);
+      S *= -3.0;
+      PtSPd *= -3.0;
+      RAP(P, S, P, PtSP);
+      REQUIRE(MaxDiff(*PtSP, PtSPd) < tol);
+      delete PtSP;
+   }
+
+#ifdef MFEM_USE_OPENMP
+   SECTION("Threaded kernels")
+   {
+      // The threaded transpose and SpGEMM give the same matrices as the
+      // sequential ones.
+      SparseMatrix S(150);
+      RandomSparseMatrix(S, 8);
+      SparseMatrix *At = Transpose(A);
+      SparseMatrix *AB = Mult(A, B);
+      SparseMatrix *PtSP = RAP(P, S, P);
+
+      EnableOpenMPDevice();
+      SparseMatrix *At_omp = Transpose(A);
+      SparseMatrix *AB_omp = Mult(A, B);
+      SparseMatrix *PtSP_omp = RAP(P, S, P);
+      // Pre-allocated output
+      SparseMatrix AB_reuse(*AB);
+      AB_reuse = 0.0;
+      Mult(A, B, &AB_reuse);
+      Device::Disable();
+
+      REQUIRE(SameStructureMaxDiff(*At, *At_omp) == 0.0);
+      REQUIRE(SameStructureMaxDiff(*AB, *AB_omp) < tol);
+      REQUIRE(SameStructureMaxDiff(*AB, AB_reuse) < tol);
+      REQUIRE(SameStructureMaxDiff(*PtSP, *PtSP_omp) < tol);
+      delete PtSP_omp;
+      delete AB_omp;
+      delete At_omp;
+      delete PtSP;
+      delete AB;
+      delete At;
+   }
+#endif
+}
+
+TEST_CASE("Batched row and column elimination", "[SparseMatrix]")
+{
+   srand(2);
+   const int n = 300;
+   SparseMatrix R(n);
+   RandomSparseMatrix(R, 6);
+   SparseMatrix *Rt = Transpose(R);
+   Vector d(n);
+   d = 4.0;
+   SparseMatrix D(d);
+   SparseMatrix *RD = Add(R, D);
+   SparseMatrix *S = Add(*RD, *Rt); // symmetric sparsity pattern
+   delete RD;
+   delete Rt;
+
+   Array<int> ess;
+   for (int i = 0; i < n; i += 7) { ess.Append(i); }
+   Vector sol(n), b(n);
+   sol.Randomize(1);
+   b.Randomize(2);
+
+   const Matrix::DiagonalPolicy policies[3] =
+   { Matrix::DIAG_ONE, Matrix::DIAG_ZERO, Matrix::DIAG_KEEP };
+   for (int p = 0; p < 3; p++)
+   {
+      const Matrix::DiagonalPolicy dpolicy = policies[p];
+
+      // With the r.h.s.
+      SparseMatrix A1(*S), A2(*S);
+      Vector b1(b), b2(b);
+      for (int k = 0; k < ess.Size(); k++)
+      {
+         A1.EliminateRowCol(ess[k], sol(ess[k]), b1, dpolicy);
+      }
+      A2.EliminateRowsCols(ess, sol, b2, dpolicy);
+      DenseMatrix A1d;
+      A1.ToDenseMatrix(A1d);
+      REQUIRE(MaxDiff(A2, A1d) == 0.0);
+      b2 -= b1;
+      REQUIRE(b2.Normlinf() < 1e-12);
+
+      // With the eliminated part, in CSR and LIL format
+      SparseMatrix A3(*S), Ae3(n), Ae4;
+      for (int k = 0; k < ess.Size(); k++)
+      {
+         A3.EliminateRowCol(ess[k], Ae3, dpolicy);
+      }
+      Ae3.Finalize();
+      SparseMatrix A4(n);
+      for (int i = 0; i < n; i++)
+      {
+         for (int k = S->GetI()[i]; k < S->GetI()[i+1]; k++)
+         {
+            A4.Add(i, S->GetJ()[k], S->GetData()[k]);
+         }
+      }
+      A4.EliminateRowsCols(ess, Ae4, dpolicy);
+      A4.Finalize(0);
+      REQUIRE(Ae4.Finalized());
+      DenseMatrix A3d, Ae3d;
+      A3.ToDenseMatrix(A3d);
+      Ae3.ToDenseMatrix(Ae3d);
+      REQUIRE(MaxDiff(A4, A3d) == 0.0);
+      REQUIRE(MaxDiff(Ae4, Ae3d) == 0.0);
+
+      // Update of a new r.h.s. with the stored eliminated part
+      Vector b3(b), b4(b);
+      Ae4.AddMult(sol, b4, -1.0);
+      A4.PartMult(ess, sol, b4);
+      SparseMatrix A5(*S);
+      A5.EliminateRowsCols(ess, sol, b3, dpolicy);
+      b4 -= b3;
+      REQUIRE(b4.Normlinf() < 1e-12);
+   }
+   delete S;
+}
+
+TEST_CASE("Interleaved complex sparse matrix", "[ComplexSparseMatrix]")
+{
+   const double tol = 1e-12;
+   srand(3);
+   const int n = 100;
+   SparseMatrix K(n), M(n);
+   RandomSparseMatrix(K, 5);
+   RandomSparseMatrix(M, 5);
+   SparseMatrix *G = Add(K, M); // graph containing both patterns
+   const double omega = 2.5;
+
+   const ComplexOperator::Convention conventions[2] =
+   { ComplexOperator::HERMITIAN, ComplexOperator::BLOCK_SYMMETRIC };
+   for (int c = 0; c < 2; c++)
+   {
+      // Reference: A = K - omega^2 M + i omega M with separate parts
+      SparseMatrix *A_r = Add(1.0, K, -omega*omega, M);
+      SparseMatrix *A_i = new SparseMatrix(M);
+      *A_i *= omega;
+      ComplexSparseMatrix Z(A_r, A_i, true, true, conventions[c]);
+
+      // Same matrix assembled directly in interleaved form
+      ComplexSparseMatrix Zi(*G, conventions[c]);
+      REQUIRE(Zi.IsInterleaved());
+      Zi.Add(1.0, 0.0, K);
+      Zi.Add(-omega*omega, omega, M);
+
+      Vector x(2*n), y(2*n), yi(2*n);
+      x.Randomize(4);
+      Z.Mult(x, y);
+      Zi.Mult(x, yi);
+      yi -= y;
+      REQUIRE(yi.Normlinf() < tol);
+      Z.MultTranspose(x, y);
+      Zi.MultTranspose(x, yi);
+      yi -= y;
+      REQUIRE(yi.Normlinf() < tol);
+
+      SparseMatrix *S = Z.GetSystemMatrix();
+      SparseMatrix *Si = Zi.GetSystemMatrix();
+      DenseMatrix Sd;
+      S->ToDenseMatrix(Sd);
+      REQUIRE(MaxDiff(*Si, Sd) < tol);
+      delete Si;
+
+      // Conversion of the pair of real matrices
+      Z.ConvertToInterleaved();
+      REQUIRE(Z.IsInterleaved());
+      Si = Z.GetSystemMatrix();
+      REQUIRE(MaxDiff(*Si, Sd) < tol);
+      delete Si;
+      delete S;
+   }
+
+   // Element-wise assembly with signed indices
+   ComplexSparseMatrix Z(*G);
+   SparseMatrix Sr(n), Si(n);
+   for (int i = 0; i < n; i++)
+   {
+      for (int k = G->GetI()[i]; k < G->GetI()[i+1]; k++)
+      {
+         const int j = G->GetJ()[k];
+         Array<int> rows(1), cols(1);
+         DenseMatrix er(1), ei(1);
+         er(0,0) = double(rand())/RAND_MAX;
+         ei(0,0) = double(rand())/RAND_MAX;
+         rows[0] = (k % 2) ? i : -1-i;
+         cols[0] = (k % 3) ? j : -1-j;
+         Z.AddSubMatrix(rows, cols, er, ei);
+         const double t = ((k % 2) ? 1.0 : -1.0) * ((k % 3) ? 1.0 : -1.0);
+         Sr.Add(i, j, t*er(0,0));
+         Si.Add(i, j, t*ei(0,0));
+      }
+   }
+   Sr.Finalize();
+   Si.Finalize();
+   ComplexSparseMatrix Zref(&Sr, &Si, false, false);
+   Vector x(2*n), y(2*n), yi(2*n);
+   x.Randomize(5);
+   Zref.Mult(x, y);
+   Z.Mult(x, yi);
+   yi -= y;
+   REQUIRE(yi.Normlinf() < tol);
+   delete G;
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+TEST_CASE("MulticolorGSSmoother", "[MulticolorGSSmoother]")
+{
+   Mesh mesh(6, 6, Element::QUADRILATERAL, true);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+
+   Array<int> ess_tdof_list, ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   ConstantCoefficient one(1.0);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a.Assemble();
+   LinearForm b(&fes);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+   GridFunction x(&fes);
+   x = 0.0;
+
+   SparseMatrix A;
+   Vector B, X;
+   a.FormLinearSystem(ess_tdof_list, x, b, A, X, B);
+
+   SECTION("Coloring")
+   {
+      MulticolorGSSmoother mgs(A);
+      int max_row = 0;
+      for (int i = 0; i < A.Height(); i++)
+      {
+         max_row = std::max(max_row, A.RowSize(i));
+      }
+      REQUIRE(mgs.GetNumColors() > 1);
+      REQUIRE(mgs.GetNumColors() <= max_row);
+   }
+
+   SECTION("Stationary iteration")
+   {
+      MulticolorGSSmoother mgs(A, 0, 200);
+      X = 0.0;
+      mgs.Mult(B, X);
+      Vector R(B.Size());
+      A.Mult(X, R);
+      subtract(B, R, R);
+      REQUIRE(R.Norml2() < 1e-6 * B.Norml2());
+   }
+
+   SECTION("SSOR preconditioned CG")
+   {
+      for (int s = 0; s < 2; s++)
+      {
+         MulticolorGSSmoother mgs(A, 0, 1, (s == 0) ? 1.0 : 1.5);
+         CGSolver cg;
+         cg.SetOperator(A);
+         cg.SetPreconditioner(mgs);
+         cg.SetRelTol(1e-12);
+         cg.SetMaxIter(200);
+         cg.SetPrintLevel(-1);
+         X = 0.0;
+         cg.Mult(B, X);
+         REQUIRE(cg.GetConverged());
+      }
+   }
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+TEST_CASE("SymmetricSparseMatrix", "[SymmetricSparseMatrix]")
+{
+   Mesh mesh(4, 3, Element::QUADRILATERAL, true);
+   ConstantCoefficient one(1.0);
+
+   // An ND space tests the dofs with sign changes
+   H1_FECollection h1_fec(2, 2);
+   ND_FECollection nd_fec(2, 2);
+   FiniteElementSpace h1_fes(&mesh, &h1_fec);
+   FiniteElementSpace nd_fes(&mesh, &nd_fec);
+
+   for (int s = 0; s < 2; s++)
+   {
+      FiniteElementSpace &fes = (s == 0) ? h1_fes : nd_fes;
+      BilinearForm a(&fes);
+      if (s == 0)
+      {
+         a.AddDomainIntegrator(new DiffusionIntegrator(one));
+         a.AddDomainIntegrator(new MassIntegrator(one));
+      }
+      else
+      {
+         a.AddDomainIntegrator(new CurlCurlIntegrator(one));
+         a.AddDomainIntegrator(new VectorFEMassIntegrator(one));
+      }
+      a.Assemble();
+      a.Finalize();
+      SparseMatrix &A = a.SpMat();
+
+      SymmetricSparseMatrix *S = a.AssembleSymmetric();
+      SymmetricSparseMatrix C(A);
+      REQUIRE(S->NumNonZeroElems() == A.NumNonZeroElems());
+
+      const int n = A.Height();
+      Vector x(n), y(n), ys(n), yc(n);
+      x.Randomize(1);
+
+      A.Mult(x, y);
+      S->Mult(x, ys);
+      C.Mult(x, yc);
+      ys -= y;
+      yc -= y;
+      REQUIRE(ys.Normlinf() < 1e-12 * y.Normlinf());
+      REQUIRE(yc.Normlinf() < 1e-12 * y.Normlinf());
+
+      SparseMatrix *F = S->ToSparseMatrix();
+      SparseMatrix *D = Add(1.0, A, -1.0, *F);
+      REQUIRE(D->MaxNorm() < 1e-12 * A.MaxNorm());
+      delete D;
+      delete F;
+
+      Vector d, ds;
+      A.GetDiag(d);
+      S->GetDiag(ds);
+      ds -= d;
+      REQUIRE(ds.Normlinf() == 0.0);
+
+      // Eliminate the boundary dofs in both matrices
+      Array<int> ess_dofs, ess_bdr(mesh.bdr_attributes.Max());
+      ess_bdr = 1;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_dofs);
+      Vector b(n), bs(n), sol(n);
+      b.Randomize(2);
+      sol.Randomize(3);
+      bs = b;
+      for (int i = 0; i < ess_dofs.Size(); i++)
+      {
+         A.EliminateRowCol(ess_dofs[i], sol(ess_dofs[i]), b);
+      }
+      S->EliminateRowsCols(ess_dofs, sol, bs);
+      bs -= b;
+      REQUIRE(bs.Normlinf() < 1e-12 * b.Normlinf());
+
+      // Symmetric Gauss-Seidel sweeps agree with the full storage version
+      GSSmoother gs(A, 0, 2);
+      SymmetricGSSmoother sgs(*S, 0, 2);
+      gs.Mult(b, y);
+      sgs.Mult(b, ys);
+      ys -= y;
+      REQUIRE(ys.Normlinf() < 1e-12 * y.Normlinf());
+
+      delete S;
+   }
+}
+
+TEST_CASE("SymmetricSparseMatrix skip zeros", "[SymmetricSparseMatrix]")
+{
+   // The off-diagonal entries of the two blocks cancel
+   Array<int> dofs(2);
+   dofs[0] = 0;
+   dofs[1] = 1;
+   DenseMatrix b1(2), b2(2);
+   b1 = 1.0;
+   b2 = 1.0;
+   b2(0,1) = b2(1,0) = -1.0;
+
+   for (int skip_zeros = 0; skip_zeros < 2; skip_zeros++)
+   {
+      SymmetricSparseMatrix S(3);
+      S.AddSubMatrix(dofs, b1);
+      S.AddSubMatrix(dofs, b2);
+      S.Finalize(skip_zeros);
+      // The diagonal entries are always kept, including the zero one of row 2
+      REQUIRE(S.NumNonZeroElems() == (skip_zeros ? 3 : 5));
+
+      Vector x(3), y(3);
+      x(0) = 1.0; x(1) = 2.0; x(2) = 3.0;
+      S.Mult(x, y);
+      REQUIRE(y(0) == 2.0);
+      REQUIRE(y(1) == 4.0);
+      REQUIRE(y(2) == 0.0);
+   }
+}